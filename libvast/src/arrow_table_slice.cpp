@@ -13,12 +13,15 @@
 #  include "vast/arrow_table_slice.hpp"
 #  include "vast/arrow_table_slice_builder.hpp"
 #  include "vast/detail/byte_swap.hpp"
+#  include "vast/detail/compare_kernels.hpp"
 #  include "vast/detail/narrow.hpp"
 #  include "vast/detail/overload.hpp"
+#  include "vast/detail/regex.hpp"
 #  include "vast/die.hpp"
 #  include "vast/error.hpp"
 #  include "vast/fbs/table_slice.hpp"
 #  include "vast/fbs/utils.hpp"
+#  include "vast/ids.hpp"
 #  include "vast/logger.hpp"
 #  include "vast/value_index.hpp"
 
@@ -26,8 +29,11 @@
 #  include <arrow/io/api.h>
 #  include <arrow/ipc/api.h>
 
+#  include <algorithm>
+#  include <array>
 #  include <type_traits>
 #  include <utility>
+#  include <vector>
 
 namespace vast {
 
@@ -482,8 +488,65 @@ public:
   template <class Array, class Getter>
   void apply(const Array& arr, Getter f) {
     for (int64_t row = 0; row < arr.length(); ++row)
-      if (!arr.IsNull(row))
-        idx_.append(f(arr, row), detail::narrow_cast<size_t>(offset_ + row));
+      append(row, arr.IsNull(row) ? data_view{} : data_view{f(arr, row)});
+  }
+
+  /// Appends the maximal runs of non-null rows through the bulk path of the
+  /// value index, falling back to appending one value at a time for indexes
+  /// that do not support the run type.
+  /// @param arr The array to append.
+  /// @param make_run Creates a `value_index::value_run` for rows `[i, j)`.
+  /// @param f The getter for appending a single row.
+  template <class Array, class MakeRun, class Getter>
+  void apply_runs(const Array& arr, MakeRun make_run, Getter f) {
+    auto bulk = true;
+    int64_t row = 0;
+    while (row < arr.length()) {
+      if (arr.IsNull(row)) {
+        append(row++, data_view{});
+        continue;
+      }
+      auto last = row + 1;
+      while (last < arr.length() && !arr.IsNull(last))
+        ++last;
+      if (bulk) {
+        auto pos = detail::narrow_cast<size_t>(offset_ + row);
+        auto appended = idx_.append_run(make_run(arr, row, last), pos);
+        bulk = static_cast<bool>(appended);
+      }
+      if (!bulk)
+        for (auto i = row; i < last; ++i)
+          append(i, f(arr, i));
+      row = last;
+    }
+  }
+
+  /// Appends a numeric array by handing out spans over its raw values.
+  template <class T, class Array, class Getter>
+  void apply_raw(const Array& arr, Getter f) {
+    apply_runs(
+      arr,
+      [](const Array& arr, int64_t first, int64_t last) {
+        return value_index::value_run{span<const T>{
+          reinterpret_cast<const T*>(arr.raw_values()) + first,
+          detail::narrow_cast<size_t>(last - first)}};
+      },
+      f);
+  }
+
+  /// Appends an array whose values need materializing before a bulk append.
+  template <class T, class Array, class Getter>
+  void apply_materialized(const Array& arr, std::vector<T>& buffer, Getter f) {
+    apply_runs(
+      arr,
+      [&](const Array& arr, int64_t first, int64_t last) {
+        buffer.clear();
+        for (auto row = first; row < last; ++row)
+          buffer.push_back(f(arr, row));
+        return value_index::value_run{
+          span<const T>{buffer.data(), buffer.size()}};
+      },
+      f);
   }
 
   void operator()(const arrow::BooleanArray& arr, const bool_type&) {
@@ -492,17 +555,26 @@ public:
 
   template <class T>
   void operator()(const arrow::NumericArray<T>& arr, const real_type&) {
-    apply(arr, real_at);
+    if constexpr (std::is_same_v<T, arrow::DoubleType>)
+      apply_raw<real>(arr, real_at);
+    else
+      apply(arr, real_at);
   }
 
   template <class T>
   void operator()(const arrow::NumericArray<T>& arr, const integer_type&) {
-    apply(arr, integer_at);
+    if constexpr (std::is_same_v<T, arrow::Int64Type>)
+      apply_raw<integer::value_type>(arr, integer_at);
+    else
+      apply(arr, integer_at);
   }
 
   template <class T>
   void operator()(const arrow::NumericArray<T>& arr, const count_type&) {
-    apply(arr, count_at);
+    if constexpr (std::is_same_v<T, arrow::UInt64Type>)
+      apply_raw<count>(arr, count_at);
+    else
+      apply(arr, count_at);
   }
 
   template <class T>
@@ -512,11 +584,14 @@ public:
 
   template <class T>
   void operator()(const arrow::NumericArray<T>& arr, const duration_type&) {
-    apply(arr, duration_at);
+    if constexpr (std::is_same_v<T, arrow::Int64Type>)
+      apply_raw<duration::rep>(arr, duration_at);
+    else
+      apply(arr, duration_at);
   }
 
   void operator()(const arrow::FixedSizeBinaryArray& arr, const address_type&) {
-    apply(arr, address_at);
+    apply_materialized(arr, addresses_, address_at);
   }
 
   void operator()(const arrow::FixedSizeBinaryArray& arr, const subnet_type&) {
@@ -524,7 +599,7 @@ public:
   }
 
   void operator()(const arrow::StringArray& arr, const string_type&) {
-    apply(arr, string_at);
+    apply_materialized(arr, strings_, string_at);
   }
 
   void operator()(const arrow::StringArray& arr, const pattern_type&) {
@@ -532,7 +607,12 @@ public:
   }
 
   void operator()(const arrow::TimestampArray& arr, const time_type&) {
-    apply(arr, timestamp_at);
+    // Only timestamps with nanosecond resolution share the representation of
+    // the value index.
+    auto& ts_type = static_cast<const arrow::TimestampType&>(*arr.type());
+    if (ts_type.unit() != arrow::TimeUnit::NANO)
+      return apply(arr, timestamp_at);
+    apply_raw<duration::rep>(arr, timestamp_at);
   }
 
   template <class T>
@@ -557,8 +637,273 @@ public:
   }
 
 private:
+  void append(int64_t row, data_view x) {
+    idx_.append(std::move(x), detail::narrow_cast<size_t>(offset_ + row));
+  }
+
   int64_t offset_;
   value_index& idx_;
+  std::vector<std::string_view> strings_ = {};
+  std::vector<address> addresses_ = {};
+};
+
+// -- evaluation of predicates over an entire column ---------------------------
+
+/// Evaluates a predicate with a fixed operator and literal against all values
+/// of a column, collecting the results in 64-bit blocks before appending them
+/// to the result bitmap. Comparisons between a column and a literal of the
+/// same type operate directly on the Arrow array, using SIMD kernels for
+/// 64-bit numeric values and addresses where possible; all other combinations
+/// fall back to materializing a data view per value.
+class column_evaluator {
+public:
+  column_evaluator(relational_operator op, const data& rhs)
+    : op_{op},
+      rhs_{rhs},
+      rhs_view_{make_view(rhs)},
+      has_kernel_{detail::has_compare_kernel(op)} {
+    null_result_ = evaluate_view(data_view{}, op_, rhs_view_);
+  }
+
+  ids& result() {
+    return result_;
+  }
+
+  template <class Array, class Predicate>
+  void scan(const Array& arr, Predicate pred) {
+    auto block = ids::block_type{0};
+    auto n = ids::size_type{0};
+    const auto has_nulls = arr.null_count() > 0;
+    for (int64_t row = 0; row < arr.length(); ++row) {
+      auto bit = has_nulls && arr.IsNull(row) ? null_result_ : pred(row);
+      block |= ids::block_type{bit} << n;
+      if (++n == ids::word_type::width) {
+        result_.append_block(block);
+        block = 0;
+        n = 0;
+      }
+    }
+    if (n > 0)
+      result_.append_block(block, n);
+  }
+
+  /// Appends the output of a comparison kernel to the result, correcting the
+  /// bits of all rows that hold null values.
+  void append_blocks(const arrow::Array& arr, std::vector<uint64_t>& blocks) {
+    if (arr.null_count() > 0) {
+      for (int64_t row = 0; row < arr.length(); ++row) {
+        if (arr.IsNull(row)) {
+          auto& block = blocks[row / 64];
+          auto mask = uint64_t{1} << (row % 64);
+          block = null_result_ ? block | mask : block & ~mask;
+        }
+      }
+    }
+    auto remaining = detail::narrow_cast<size_t>(arr.length());
+    for (auto block : blocks) {
+      auto n = std::min(remaining, size_t{ids::word_type::width});
+      result_.append_block(block, n);
+      remaining -= n;
+    }
+  }
+
+  template <class T>
+  void compare_raw(const arrow::Array& arr, const T* xs, T x) {
+    auto n = detail::narrow_cast<size_t>(arr.length());
+    auto blocks = std::vector<uint64_t>((n + 63) / 64);
+    detail::compare(op_, xs, n, x, blocks.data());
+    append_blocks(arr, blocks);
+  }
+
+  void mask_equal_raw(const arrow::FixedSizeBinaryArray& arr,
+                      const address& network, unsigned top_bits, bool negate) {
+    auto ones = std::array<uint8_t, 16>{};
+    ones.fill(0xFF);
+    auto mask = address::v6(ones.data(), address::network);
+    mask.mask(top_bits);
+    auto n = detail::narrow_cast<size_t>(arr.length());
+    auto blocks = std::vector<uint64_t>((n + 63) / 64);
+    detail::mask_equal(arr.raw_values(), n, network.data().data(),
+                       mask.data().data(), blocks.data());
+    if (negate)
+      for (auto& block : blocks)
+        block = ~block;
+    append_blocks(arr, blocks);
+  }
+
+  template <class Array, class Getter>
+  void apply(const Array& arr, Getter f) {
+    scan(arr, [&](int64_t row) {
+      return evaluate_view(data_view{f(arr, row)}, op_, rhs_view_);
+    });
+  }
+
+  template <class Array, class Getter, class T>
+  void compare(const Array& arr, Getter f, const T& x) {
+    switch (op_) {
+      case relational_operator::equal:
+        return scan(arr, [&](int64_t row) { return f(arr, row) == x; });
+      case relational_operator::not_equal:
+        return scan(arr, [&](int64_t row) { return f(arr, row) != x; });
+      case relational_operator::less:
+        return scan(arr, [&](int64_t row) { return f(arr, row) < x; });
+      case relational_operator::less_equal:
+        return scan(arr, [&](int64_t row) { return f(arr, row) <= x; });
+      case relational_operator::greater:
+        return scan(arr, [&](int64_t row) { return f(arr, row) > x; });
+      case relational_operator::greater_equal:
+        return scan(arr, [&](int64_t row) { return f(arr, row) >= x; });
+      default:
+        return apply(arr, f);
+    }
+  }
+
+  template <class T, class Array, class Getter>
+  void dispatch(const Array& arr, Getter f) {
+    if (const auto* x = caf::get_if<T>(&rhs_))
+      compare(arr, f, make_view(*x));
+    else
+      apply(arr, f);
+  }
+
+  void operator()(const arrow::BooleanArray& arr, const bool_type&) {
+    dispatch<bool>(arr, boolean_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const real_type&) {
+    if constexpr (std::is_same_v<T, arrow::DoubleType>)
+      if (const auto* x = caf::get_if<real>(&rhs_); x && has_kernel_)
+        return compare_raw(arr, arr.raw_values(), *x);
+    dispatch<real>(arr, real_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const integer_type&) {
+    if constexpr (std::is_same_v<T, arrow::Int64Type>)
+      if (const auto* x = caf::get_if<integer>(&rhs_); x && has_kernel_)
+        return compare_raw(arr, arr.raw_values(), x->value);
+    dispatch<integer>(arr, integer_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const count_type&) {
+    if constexpr (std::is_same_v<T, arrow::UInt64Type>)
+      if (const auto* x = caf::get_if<count>(&rhs_); x && has_kernel_)
+        return compare_raw(arr, arr.raw_values(), *x);
+    dispatch<count>(arr, count_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr,
+                  const enumeration_type& t) {
+    // Enumerations compare by their canonical representation.
+    apply(arr, [&](const auto& arr, int64_t row) -> data_view {
+      auto x = enumeration_at(arr, row);
+      if (x >= t.fields.size())
+        return caf::none;
+      return make_view(t.fields[x]);
+    });
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const duration_type&) {
+    if constexpr (std::is_same_v<T, arrow::Int64Type>)
+      if (const auto* x = caf::get_if<duration>(&rhs_); x && has_kernel_)
+        return compare_raw(arr, arr.raw_values(), int64_t{x->count()});
+    dispatch<duration>(arr, duration_at);
+  }
+
+  void operator()(const arrow::FixedSizeBinaryArray& arr, const address_type&) {
+    if (const auto* sn = caf::get_if<subnet>(&rhs_)) {
+      auto top_bits = sn->network().is_v4() ? sn->length() + 96u : sn->length();
+      if (op_ == relational_operator::in)
+        return mask_equal_raw(arr, sn->network(), top_bits, false);
+      if (op_ == relational_operator::not_in)
+        return mask_equal_raw(arr, sn->network(), top_bits, true);
+    }
+    if (const auto* addr = caf::get_if<address>(&rhs_)) {
+      if (op_ == relational_operator::equal)
+        return mask_equal_raw(arr, *addr, 128u, false);
+      if (op_ == relational_operator::not_equal)
+        return mask_equal_raw(arr, *addr, 128u, true);
+    }
+    dispatch<address>(arr, address_at);
+  }
+
+  void operator()(const arrow::FixedSizeBinaryArray& arr, const subnet_type&) {
+    dispatch<subnet>(arr, subnet_at);
+  }
+
+  void operator()(const arrow::StringArray& arr, const string_type&) {
+    if (const auto* str = caf::get_if<std::string>(&rhs_)) {
+      if (op_ == relational_operator::ni)
+        return scan(arr, [&](int64_t row) {
+          return string_at(arr, row).find(*str) != std::string_view::npos;
+        });
+      if (op_ == relational_operator::not_ni)
+        return scan(arr, [&](int64_t row) {
+          return string_at(arr, row).find(*str) == std::string_view::npos;
+        });
+    }
+    if (const auto* pat = caf::get_if<pattern>(&rhs_);
+        pat
+        && (op_ == relational_operator::match
+            || op_ == relational_operator::not_match)) {
+      if (auto rx = pat->compiled()) {
+        auto negate = op_ == relational_operator::not_match;
+        return scan(arr, [&](int64_t row) {
+          return (*rx)->match(string_at(arr, row)) != negate;
+        });
+      }
+    }
+    dispatch<std::string>(arr, string_at);
+  }
+
+  void operator()(const arrow::StringArray& arr, const pattern_type&) {
+    apply(arr, pattern_at);
+  }
+
+  void operator()(const arrow::TimestampArray& arr, const time_type&) {
+    // Avoid checking the time unit per row for the common case of timestamps
+    // with nanosecond resolution.
+    auto& ts_type = static_cast<const arrow::TimestampType&>(*arr.type());
+    if (ts_type.unit() != arrow::TimeUnit::NANO)
+      return dispatch<time>(arr, timestamp_at);
+    if (const auto* x = caf::get_if<time>(&rhs_); x && has_kernel_)
+      return compare_raw(arr, arr.raw_values(),
+                         int64_t{x->time_since_epoch().count()});
+    dispatch<time>(arr, [](const auto& arr, int64_t row) {
+      return time{duration{arr.Value(row)}};
+    });
+  }
+
+  template <class T>
+  void operator()(const arrow::ListArray& arr, const T& t) {
+    if constexpr (std::is_same_v<T, list_type>) {
+      apply(arr, [&](const auto& arr, int64_t row) {
+        return list_at(t.value_type, arr, row);
+      });
+    } else {
+      static_assert(std::is_same_v<T, map_type>);
+      apply(arr, [&](const auto& arr, int64_t row) {
+        return map_at(t.key_type, t.value_type, arr, row);
+      });
+    }
+  }
+
+  void operator()(const arrow::StructArray& arr, const record_type& t) {
+    apply(arr,
+          [&](const auto& arr, int64_t row) { return record_at(t, arr, row); });
+  }
+
+private:
+  relational_operator op_;
+  const data& rhs_;
+  data_view rhs_view_;
+  bool has_kernel_ = false;
+  bool null_result_ = false;
+  ids result_ = {};
 };
 
 // -- utility for converting Buffer to RecordBatch -----------------------------
@@ -690,6 +1035,22 @@ void arrow_table_slice<FlatBuffer>::append_column_to_index(
   }
 }
 
+template <class FlatBuffer>
+ids arrow_table_slice<FlatBuffer>::evaluate_column(
+  table_slice::size_type column, const type& t, relational_operator op,
+  const data& rhs) const {
+  auto f = column_evaluator{op, rhs};
+  if (auto&& batch = record_batch()) {
+    auto array = batch->column(detail::narrow_cast<int>(column));
+    decode(t, *array, f);
+  }
+  // Decoding fails for mismatching types, in which case no row qualifies.
+  auto& result = f.result();
+  if (result.size() < rows())
+    result.append_bits(false, rows() - result.size());
+  return std::move(result);
+}
+
 template <class FlatBuffer>
 data_view
 arrow_table_slice<FlatBuffer>::at(table_slice::size_type row,
@@ -8,7 +8,13 @@
 
 #include "vast/bloom_filter_synopsis.hpp"
 
+#include "vast/address_synopsis.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
+#include "vast/fbs/utils.hpp"
+#include "vast/string_synopsis.hpp"
+
+#include <type_traits>
 
 namespace vast {
 
@@ -16,8 +22,22 @@ type annotate_parameters(type type, const bloom_filter_parameters& params) {
   using namespace std::string_literals;
   auto v = "bloomfilter("s + std::to_string(*params.n) + ','
            + std::to_string(*params.p) + ')';
-  // Replaces any previously existing attributes.
-  return std::move(type).attributes({{"synopsis", std::move(v)}});
+  // Replaces any previously existing attributes, but retains the layout
+  // because it determines the type of the synopsis after deserialization.
+  auto blocked = has_blocked_layout(type);
+  type = std::move(type).attributes({{"synopsis", std::move(v)}});
+  if (blocked)
+    return annotate_blocked_layout(std::move(type));
+  return type;
+}
+
+bool has_blocked_layout(const type& x) {
+  auto layout = find_attribute(x, "synopsis-layout");
+  return layout && layout->value && *layout->value == "blocked";
+}
+
+type annotate_blocked_layout(type x) {
+  return std::move(x).update_attributes({{"synopsis-layout", "blocked"}});
 }
 
 std::optional<bloom_filter_parameters> parse_parameters(const type& x) {
@@ -31,4 +51,92 @@ std::optional<bloom_filter_parameters> parse_parameters(const type& x) {
   return parse_parameters(*i->value);
 }
 
+namespace detail {
+
+caf::expected<flatbuffers::Offset<fbs::bloom_filter_synopsis::v0>>
+pack_bloom_filter_synopsis(flatbuffers::FlatBufferBuilder& builder,
+                           const type& t, policy::partitioning layout,
+                           const double_hasher<xxhash64>& hasher,
+                           span<const uint64_t> words, size_t size) {
+  VAST_ASSERT(layout != policy::partitioning::yes);
+  auto type_bytes = fbs::serialize_bytes(builder, t);
+  if (!type_bytes)
+    return type_bytes.error();
+  auto bits = builder.CreateVector(words.data(), words.size());
+  auto seeds = hasher.seeds();
+  auto partitioning = layout == policy::partitioning::blocked
+                        ? fbs::bloom_filter_synopsis::Partitioning::blocked
+                        : fbs::bloom_filter_synopsis::Partitioning::no;
+  fbs::bloom_filter_synopsis::v0Builder bloom_filter_builder(builder);
+  bloom_filter_builder.add_type(*type_bytes);
+  bloom_filter_builder.add_partitioning(partitioning);
+  bloom_filter_builder.add_num_hash_functions(
+    narrow_cast<uint32_t>(hasher.size()));
+  bloom_filter_builder.add_seed1(seeds[0]);
+  bloom_filter_builder.add_seed2(seeds[1]);
+  bloom_filter_builder.add_size(size);
+  bloom_filter_builder.add_bits(bits);
+  return bloom_filter_builder.Finish();
+}
+
+} // namespace detail
+
+caf::error
+unpack(const fbs::bloom_filter_synopsis::v0& x, synopsis_ptr& ptr) {
+  using fbs::bloom_filter_synopsis::Partitioning;
+  type t;
+  if (auto error = fbs::deserialize_bytes(x.type(), t))
+    return error;
+  if (!x.bits())
+    return caf::make_error(ec::format_error, "Bloom filter synopsis has no "
+                                             "bits");
+  auto words = span<const uint64_t>{x.bits()->data(), x.bits()->size()};
+  auto size = x.size();
+  constexpr auto word_width = word<uint64_t>::width;
+  if (size == 0 || words.size() != (size + word_width - 1) / word_width)
+    return caf::make_error(ec::format_error, "Bloom filter synopsis has",
+                           words.size(), "words for", size, "bits");
+  if (x.num_hash_functions() == 0)
+    return caf::make_error(ec::format_error, "Bloom filter synopsis has no "
+                                             "hash functions");
+  if (x.partitioning() != Partitioning::no
+      && x.partitioning() != Partitioning::blocked)
+    return caf::make_error(ec::format_error, "unknown Bloom filter layout");
+  auto blocked = x.partitioning() == Partitioning::blocked;
+  if (blocked && size % detail::bloom_filter_block_size != 0)
+    return caf::make_error(ec::format_error, "blocked Bloom filter synopsis "
+                                             "has incomplete blocks");
+  auto hasher
+    = double_hasher<xxhash64>{x.num_hash_functions(), {x.seed1(), x.seed2()}};
+  // We copy the bits so that the synopsis does not outlive the buffer.
+  auto make = [&](auto* tag, auto layout) -> synopsis_ptr {
+    using value_type = std::remove_pointer_t<decltype(tag)>;
+    constexpr auto cell_layout = decltype(layout)::value;
+    using view_type = bloom_filter_view<xxhash64, double_hasher, cell_layout>;
+    auto view = view_type{std::move(hasher), words, size};
+    if constexpr (std::is_same_v<value_type, address>)
+      return std::make_unique<address_synopsis<xxhash64, cell_layout>>(
+        std::move(t), view.materialize());
+    else
+      return std::make_unique<string_synopsis<xxhash64, cell_layout>>(
+        std::move(t), view.materialize());
+  };
+  auto dispatch = [&](auto* tag) {
+    using policy::partitioning;
+    if (blocked)
+      return make(tag,
+                  std::integral_constant<partitioning, partitioning::blocked>{});
+    return make(tag, std::integral_constant<partitioning, partitioning::no>{});
+  };
+  if (caf::holds_alternative<address_type>(t))
+    ptr = dispatch(static_cast<address*>(nullptr));
+  else if (caf::holds_alternative<string_type>(t))
+    ptr = dispatch(static_cast<std::string*>(nullptr));
+  else
+    return caf::make_error(ec::format_error, "Bloom filter synopsis has "
+                                             "unsupported type",
+                           t);
+  return caf::none;
+}
+
 } // namespace vast
@@ -0,0 +1,138 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/compression.hpp"
+
+#include "vast/config.hpp"
+
+#include "vast/chunk.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
+#include "vast/error.hpp"
+
+#include <fmt/format.h>
+
+#if VAST_ENABLE_ARROW
+#  include <arrow/util/compression.h>
+#endif
+
+namespace vast {
+
+namespace {
+
+#if VAST_ENABLE_ARROW
+
+/// Creates the Arrow codec that implements a compression algorithm.
+caf::expected<std::unique_ptr<arrow::util::Codec>>
+make_codec(compression method, int level) {
+  VAST_ASSERT(method != compression::none);
+  auto type = method == compression::lz4 ? arrow::Compression::LZ4_FRAME
+                                         : arrow::Compression::ZSTD;
+  auto codec
+    = level == 0
+        ? arrow::util::Codec::Create(type)
+        : arrow::util::Codec::Create(type, level);
+  if (!codec.ok())
+    return caf::make_error(ec::invalid_configuration,
+                           fmt::format("failed to create {} codec: {}",
+                                       to_string(method),
+                                       codec.status().ToString()));
+  return std::move(codec).ValueOrDie();
+}
+
+#endif // VAST_ENABLE_ARROW
+
+} // namespace
+
+const char* to_string(compression x) noexcept {
+  switch (x) {
+    case compression::none:
+      return "none";
+    case compression::lz4:
+      return "lz4";
+    case compression::zstd:
+      return "zstd";
+  }
+  return "unknown";
+}
+
+caf::expected<compression> parse_compression(std::string_view name) {
+  for (auto x : {compression::none, compression::lz4, compression::zstd})
+    if (name == to_string(x))
+      return x;
+  return caf::make_error(ec::parse_error,
+                         fmt::format("unknown compression {}; expected one of "
+                                     "none, lz4, or zstd",
+                                     name));
+}
+
+caf::expected<std::vector<std::byte>>
+compress(compression method, int level, span<const std::byte> xs) {
+#if VAST_ENABLE_ARROW
+  auto codec = make_codec(method, level);
+  if (!codec)
+    return codec.error();
+  auto input_size = detail::narrow_cast<int64_t>(xs.size());
+  const auto* input = reinterpret_cast<const uint8_t*>(xs.data());
+  auto result = std::vector<std::byte>(
+    detail::narrow_cast<size_t>((*codec)->MaxCompressedLen(input_size, input)));
+  auto size = (*codec)->Compress(input_size, input,
+                                 detail::narrow_cast<int64_t>(result.size()),
+                                 reinterpret_cast<uint8_t*>(result.data()));
+  if (!size.ok())
+    return caf::make_error(ec::unspecified,
+                           fmt::format("failed to compress {} bytes with {}: "
+                                       "{}",
+                                       xs.size(), to_string(method),
+                                       size.status().ToString()));
+  result.resize(detail::narrow_cast<size_t>(size.ValueOrDie()));
+  result.shrink_to_fit();
+  return result;
+#else
+  (void)level;
+  (void)xs;
+  return caf::make_error(ec::unimplemented,
+                         fmt::format("{} compression requires Apache Arrow",
+                                     to_string(method)));
+#endif
+}
+
+caf::expected<chunk_ptr> decompress(compression method,
+                                    span<const std::byte> xs,
+                                    size_t decompressed_size) {
+#if VAST_ENABLE_ARROW
+  auto codec = make_codec(method, 0);
+  if (!codec)
+    return codec.error();
+  auto result = std::vector<std::byte>(decompressed_size);
+  auto size = (*codec)->Decompress(
+    detail::narrow_cast<int64_t>(xs.size()),
+    reinterpret_cast<const uint8_t*>(xs.data()),
+    detail::narrow_cast<int64_t>(result.size()),
+    reinterpret_cast<uint8_t*>(result.data()));
+  if (!size.ok())
+    return caf::make_error(ec::format_error,
+                           fmt::format("failed to decompress {} bytes with {}: "
+                                       "{}",
+                                       xs.size(), to_string(method),
+                                       size.status().ToString()));
+  if (size.ValueOrDie() != detail::narrow_cast<int64_t>(decompressed_size))
+    return caf::make_error(ec::format_error,
+                           fmt::format("decompressed {} bytes but expected {}",
+                                       size.ValueOrDie(), decompressed_size));
+  return chunk::make(std::move(result));
+#else
+  (void)xs;
+  (void)decompressed_size;
+  return caf::make_error(ec::unimplemented,
+                         fmt::format("{} decompression requires Apache Arrow",
+                                     to_string(method)));
+#endif
+}
+
+} // namespace vast
@@ -0,0 +1,393 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/detail/compare_kernels.hpp"
+
+#include "vast/detail/assert.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__))                                 \
+  && (defined(__GNUC__) || defined(__clang__))
+#  define VAST_HAS_X86_KERNELS 1
+#  define VAST_TARGET_SSE4_2 __attribute__((target("sse4.2")))
+#  define VAST_TARGET_AVX2 __attribute__((target("avx2")))
+#  include <immintrin.h>
+#else
+#  define VAST_HAS_X86_KERNELS 0
+#endif
+
+namespace vast::detail {
+
+namespace {
+
+template <relational_operator Op>
+using op_constant = std::integral_constant<relational_operator, Op>;
+
+/// Lifts a runtime operator into a compile-time constant.
+template <class F>
+void with_operator(relational_operator op, F f) noexcept {
+  switch (op) {
+    case relational_operator::equal:
+      return f(op_constant<relational_operator::equal>{});
+    case relational_operator::not_equal:
+      return f(op_constant<relational_operator::not_equal>{});
+    case relational_operator::less:
+      return f(op_constant<relational_operator::less>{});
+    case relational_operator::less_equal:
+      return f(op_constant<relational_operator::less_equal>{});
+    case relational_operator::greater:
+      return f(op_constant<relational_operator::greater>{});
+    case relational_operator::greater_equal:
+      return f(op_constant<relational_operator::greater_equal>{});
+    default:
+      VAST_ASSERT(!"unsupported operator for comparison kernel");
+  }
+}
+
+// -- scalar kernels -----------------------------------------------------------
+
+template <relational_operator Op, class T>
+bool apply(T lhs, T rhs) noexcept {
+  if constexpr (Op == relational_operator::equal)
+    return lhs == rhs;
+  else if constexpr (Op == relational_operator::not_equal)
+    return lhs != rhs;
+  else if constexpr (Op == relational_operator::less)
+    return lhs < rhs;
+  else if constexpr (Op == relational_operator::less_equal)
+    return lhs <= rhs;
+  else if constexpr (Op == relational_operator::greater)
+    return lhs > rhs;
+  else
+    return lhs >= rhs;
+}
+
+/// Writes the bits for the values in `[first, n)` into the partially filled
+/// block `out[first / 64]` and all following blocks.
+template <relational_operator Op, class T>
+void compare_scalar(const T* xs, size_t first, size_t n, T x,
+                    uint64_t* out) noexcept {
+  for (auto i = first; i < n; ++i) {
+    if (i % 64 == 0)
+      out[i / 64] = 0;
+    out[i / 64] |= uint64_t{apply<Op>(xs[i], x)} << (i % 64);
+  }
+}
+
+struct address_word {
+  uint64_t hi;
+  uint64_t lo;
+};
+
+address_word load_address(const uint8_t* bytes) noexcept {
+  auto result = address_word{};
+  std::memcpy(&result.hi, bytes, 8);
+  std::memcpy(&result.lo, bytes + 8, 8);
+  return result;
+}
+
+void mask_equal_scalar(const uint8_t* xs, size_t first, size_t n,
+                       const uint8_t* network, const uint8_t* mask,
+                       uint64_t* out) noexcept {
+  // Byte order does not matter for masked equality, so we can compare
+  // the addresses in two native 64-bit words.
+  auto net = load_address(network);
+  auto msk = load_address(mask);
+  for (auto i = first; i < n; ++i) {
+    if (i % 64 == 0)
+      out[i / 64] = 0;
+    auto addr = load_address(xs + i * 16);
+    auto bit = (addr.hi & msk.hi) == net.hi && (addr.lo & msk.lo) == net.lo;
+    out[i / 64] |= uint64_t{bit} << (i % 64);
+  }
+}
+
+#if VAST_HAS_X86_KERNELS
+
+// -- SSE4.2 kernels -----------------------------------------------------------
+
+template <relational_operator Op>
+VAST_TARGET_SSE4_2 int movemask_sse(__m128i lhs, __m128i rhs) noexcept {
+  auto ones = _mm_set1_epi64x(-1);
+  __m128i result;
+  if constexpr (Op == relational_operator::equal)
+    result = _mm_cmpeq_epi64(lhs, rhs);
+  else if constexpr (Op == relational_operator::not_equal)
+    result = _mm_xor_si128(_mm_cmpeq_epi64(lhs, rhs), ones);
+  else if constexpr (Op == relational_operator::less)
+    result = _mm_cmpgt_epi64(rhs, lhs);
+  else if constexpr (Op == relational_operator::less_equal)
+    result = _mm_xor_si128(_mm_cmpgt_epi64(lhs, rhs), ones);
+  else if constexpr (Op == relational_operator::greater)
+    result = _mm_cmpgt_epi64(lhs, rhs);
+  else
+    result = _mm_xor_si128(_mm_cmpgt_epi64(rhs, lhs), ones);
+  return _mm_movemask_pd(_mm_castsi128_pd(result));
+}
+
+template <relational_operator Op>
+VAST_TARGET_SSE4_2 int movemask_sse(__m128d lhs, __m128d rhs) noexcept {
+  if constexpr (Op == relational_operator::equal)
+    return _mm_movemask_pd(_mm_cmpeq_pd(lhs, rhs));
+  else if constexpr (Op == relational_operator::not_equal)
+    return _mm_movemask_pd(_mm_cmpneq_pd(lhs, rhs));
+  else if constexpr (Op == relational_operator::less)
+    return _mm_movemask_pd(_mm_cmplt_pd(lhs, rhs));
+  else if constexpr (Op == relational_operator::less_equal)
+    return _mm_movemask_pd(_mm_cmple_pd(lhs, rhs));
+  else if constexpr (Op == relational_operator::greater)
+    return _mm_movemask_pd(_mm_cmpgt_pd(lhs, rhs));
+  else
+    return _mm_movemask_pd(_mm_cmpge_pd(lhs, rhs));
+}
+
+/// Processes full blocks of 64 values and returns the number of values
+/// processed. Unsigned values get their sign bit flipped such that the signed
+/// comparison instructions order them correctly.
+template <relational_operator Op, class T>
+VAST_TARGET_SSE4_2 size_t compare_sse(const T* xs, size_t n, T x,
+                                      uint64_t* out) noexcept {
+  auto blocks = n / 64;
+  if constexpr (std::is_same_v<T, double>) {
+    auto rhs = _mm_set1_pd(x);
+    for (size_t b = 0; b < blocks; ++b) {
+      auto block = uint64_t{0};
+      const auto* ptr = xs + b * 64;
+      for (size_t i = 0; i < 64; i += 2) {
+        auto lhs = _mm_loadu_pd(ptr + i);
+        block |= uint64_t(movemask_sse<Op>(lhs, rhs)) << i;
+      }
+      out[b] = block;
+    }
+  } else {
+    constexpr auto is_unsigned = std::is_unsigned_v<T>;
+    auto bias = _mm_set1_epi64x(is_unsigned ? INT64_MIN : 0);
+    auto rhs = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(x)), bias);
+    for (size_t b = 0; b < blocks; ++b) {
+      auto block = uint64_t{0};
+      const auto* ptr = reinterpret_cast<const __m128i*>(xs + b * 64);
+      for (size_t i = 0; i < 32; ++i) {
+        auto lhs = _mm_xor_si128(_mm_loadu_si128(ptr + i), bias);
+        block |= uint64_t(movemask_sse<Op>(lhs, rhs)) << (i * 2);
+      }
+      out[b] = block;
+    }
+  }
+  return blocks * 64;
+}
+
+VAST_TARGET_SSE4_2 size_t mask_equal_sse(const uint8_t* xs, size_t n,
+                                         const uint8_t* network,
+                                         const uint8_t* mask,
+                                         uint64_t* out) noexcept {
+  auto blocks = n / 64;
+  auto net = _mm_loadu_si128(reinterpret_cast<const __m128i*>(network));
+  auto msk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+  for (size_t b = 0; b < blocks; ++b) {
+    auto block = uint64_t{0};
+    const auto* ptr = reinterpret_cast<const __m128i*>(xs + b * 64 * 16);
+    for (size_t i = 0; i < 64; ++i) {
+      auto addr = _mm_and_si128(_mm_loadu_si128(ptr + i), msk);
+      auto eq = _mm_movemask_epi8(_mm_cmpeq_epi8(addr, net));
+      block |= uint64_t{eq == 0xFFFF} << i;
+    }
+    out[b] = block;
+  }
+  return blocks * 64;
+}
+
+// -- AVX2 kernels -------------------------------------------------------------
+
+template <relational_operator Op>
+VAST_TARGET_AVX2 int movemask_avx2(__m256i lhs, __m256i rhs) noexcept {
+  auto ones = _mm256_set1_epi64x(-1);
+  __m256i result;
+  if constexpr (Op == relational_operator::equal)
+    result = _mm256_cmpeq_epi64(lhs, rhs);
+  else if constexpr (Op == relational_operator::not_equal)
+    result = _mm256_xor_si256(_mm256_cmpeq_epi64(lhs, rhs), ones);
+  else if constexpr (Op == relational_operator::less)
+    result = _mm256_cmpgt_epi64(rhs, lhs);
+  else if constexpr (Op == relational_operator::less_equal)
+    result = _mm256_xor_si256(_mm256_cmpgt_epi64(lhs, rhs), ones);
+  else if constexpr (Op == relational_operator::greater)
+    result = _mm256_cmpgt_epi64(lhs, rhs);
+  else
+    result = _mm256_xor_si256(_mm256_cmpgt_epi64(rhs, lhs), ones);
+  return _mm256_movemask_pd(_mm256_castsi256_pd(result));
+}
+
+template <relational_operator Op>
+VAST_TARGET_AVX2 int movemask_avx2(__m256d lhs, __m256d rhs) noexcept {
+  if constexpr (Op == relational_operator::equal)
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ));
+  else if constexpr (Op == relational_operator::not_equal)
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_NEQ_UQ));
+  else if constexpr (Op == relational_operator::less)
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_LT_OQ));
+  else if constexpr (Op == relational_operator::less_equal)
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_LE_OQ));
+  else if constexpr (Op == relational_operator::greater)
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_GT_OQ));
+  else
+    return _mm256_movemask_pd(_mm256_cmp_pd(lhs, rhs, _CMP_GE_OQ));
+}
+
+template <relational_operator Op, class T>
+VAST_TARGET_AVX2 size_t compare_avx2(const T* xs, size_t n, T x,
+                                     uint64_t* out) noexcept {
+  auto blocks = n / 64;
+  if constexpr (std::is_same_v<T, double>) {
+    auto rhs = _mm256_set1_pd(x);
+    for (size_t b = 0; b < blocks; ++b) {
+      auto block = uint64_t{0};
+      const auto* ptr = xs + b * 64;
+      for (size_t i = 0; i < 64; i += 4) {
+        auto lhs = _mm256_loadu_pd(ptr + i);
+        block |= uint64_t(movemask_avx2<Op>(lhs, rhs)) << i;
+      }
+      out[b] = block;
+    }
+  } else {
+    constexpr auto is_unsigned = std::is_unsigned_v<T>;
+    auto bias = _mm256_set1_epi64x(is_unsigned ? INT64_MIN : 0);
+    auto rhs
+      = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(x)), bias);
+    for (size_t b = 0; b < blocks; ++b) {
+      auto block = uint64_t{0};
+      const auto* ptr = reinterpret_cast<const __m256i*>(xs + b * 64);
+      for (size_t i = 0; i < 16; ++i) {
+        auto lhs = _mm256_xor_si256(_mm256_loadu_si256(ptr + i), bias);
+        block |= uint64_t(movemask_avx2<Op>(lhs, rhs)) << (i * 4);
+      }
+      out[b] = block;
+    }
+  }
+  return blocks * 64;
+}
+
+VAST_TARGET_AVX2 size_t mask_equal_avx2(const uint8_t* xs, size_t n,
+                                        const uint8_t* network,
+                                        const uint8_t* mask,
+                                        uint64_t* out) noexcept {
+  auto blocks = n / 64;
+  // Process two addresses per 256-bit register.
+  auto net = _mm256_broadcastsi128_si256(
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(network)));
+  auto msk = _mm256_broadcastsi128_si256(
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+  for (size_t b = 0; b < blocks; ++b) {
+    auto block = uint64_t{0};
+    const auto* ptr = reinterpret_cast<const __m256i*>(xs + b * 64 * 16);
+    for (size_t i = 0; i < 32; ++i) {
+      auto addrs = _mm256_and_si256(_mm256_loadu_si256(ptr + i), msk);
+      auto eq = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(addrs, net)));
+      auto lo = uint64_t{(eq & 0xFFFFu) == 0xFFFFu};
+      auto hi = uint64_t{(eq >> 16) == 0xFFFFu};
+      block |= (lo | (hi << 1)) << (i * 2);
+    }
+    out[b] = block;
+  }
+  return blocks * 64;
+}
+
+#endif // VAST_HAS_X86_KERNELS
+
+template <class T>
+void compare_impl(simd_level level, relational_operator op, const T* xs,
+                  size_t n, T x, uint64_t* out) noexcept {
+  level = std::min(level, supported_simd_level());
+  with_operator(op, [&](auto op_constant) {
+    constexpr auto Op = decltype(op_constant)::value;
+    auto done = size_t{0};
+#if VAST_HAS_X86_KERNELS
+    if (level == simd_level::avx2)
+      done = compare_avx2<Op>(xs, n, x, out);
+    else if (level == simd_level::sse4_2)
+      done = compare_sse<Op>(xs, n, x, out);
+#endif // VAST_HAS_X86_KERNELS
+    compare_scalar<Op>(xs, done, n, x, out);
+  });
+}
+
+} // namespace
+
+const char* to_string(simd_level level) noexcept {
+  switch (level) {
+    case simd_level::scalar:
+      return "scalar";
+    case simd_level::sse4_2:
+      return "sse4.2";
+    case simd_level::avx2:
+      return "avx2";
+  }
+  return "unknown";
+}
+
+simd_level supported_simd_level() noexcept {
+  static const auto level = [] {
+#if VAST_HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+      return simd_level::avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+      return simd_level::sse4_2;
+#endif // VAST_HAS_X86_KERNELS
+    return simd_level::scalar;
+  }();
+  return level;
+}
+
+bool has_compare_kernel(relational_operator op) noexcept {
+  switch (op) {
+    case relational_operator::equal:
+    case relational_operator::not_equal:
+    case relational_operator::less:
+    case relational_operator::less_equal:
+    case relational_operator::greater:
+    case relational_operator::greater_equal:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void compare(simd_level level, relational_operator op, const int64_t* xs,
+             size_t n, int64_t x, uint64_t* out) noexcept {
+  compare_impl(level, op, xs, n, x, out);
+}
+
+void compare(simd_level level, relational_operator op, const uint64_t* xs,
+             size_t n, uint64_t x, uint64_t* out) noexcept {
+  compare_impl(level, op, xs, n, x, out);
+}
+
+void compare(simd_level level, relational_operator op, const double* xs,
+             size_t n, double x, uint64_t* out) noexcept {
+  compare_impl(level, op, xs, n, x, out);
+}
+
+void mask_equal(simd_level level, const uint8_t* xs, size_t n,
+                const uint8_t* network, const uint8_t* mask,
+                uint64_t* out) noexcept {
+  level = std::min(level, supported_simd_level());
+  auto done = size_t{0};
+#if VAST_HAS_X86_KERNELS
+  if (level == simd_level::avx2)
+    done = mask_equal_avx2(xs, n, network, mask, out);
+  else if (level == simd_level::sse4_2)
+    done = mask_equal_sse(xs, n, network, mask, out);
+#endif // VAST_HAS_X86_KERNELS
+  mask_equal_scalar(xs, done, n, network, mask, out);
+}
+
+} // namespace vast::detail
@@ -0,0 +1,123 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/detail/padded_line_range.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/fdinbuf.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vast::detail {
+
+padded_line_range::padded_line_range(std::istream& input, size_t padding,
+                                     size_t capacity)
+  : input_{input}, padding_{padding}, buffer_(capacity + padding) {
+  VAST_ASSERT(capacity > 0);
+}
+
+std::string_view padded_line_range::get() const {
+  return line_;
+}
+
+bool padded_line_range::next_timeout(std::chrono::milliseconds timeout) {
+  line_ = {};
+  // Get the next non-empty line.
+  while (true) {
+    if (extract()) {
+      if (line_.empty())
+        continue;
+      return false;
+    }
+    if (exhausted_) {
+      // The input may end without a final line break.
+      if (begin_ < end_) {
+        line_ = std::string_view{buffer_.data() + begin_, end_ - begin_};
+        if (line_.back() == '\r')
+          line_.remove_suffix(1);
+        begin_ = end_;
+        ++line_number_;
+      }
+      return false;
+    }
+    if (fill(timeout))
+      return true;
+  }
+}
+
+bool padded_line_range::done() const {
+  return line_.empty() && exhausted_ && begin_ == end_;
+}
+
+size_t padded_line_range::line_number() const {
+  return line_number_;
+}
+
+bool padded_line_range::extract() {
+  auto* first = buffer_.data() + begin_;
+  const auto* separator = static_cast<const char*>(
+    std::memchr(first, '\n', end_ - begin_));
+  if (separator == nullptr)
+    return false;
+  auto size = static_cast<size_t>(separator - first);
+  begin_ += size + 1;
+  // Accept Windows line endings as well.
+  if (size > 0 && first[size - 1] == '\r')
+    --size;
+  line_ = std::string_view{first, size};
+  ++line_number_;
+  return true;
+}
+
+bool padded_line_range::fill(std::chrono::milliseconds timeout) {
+  // Move the incomplete line to the front of the buffer, and grow the buffer
+  // if the incomplete line already fills it.
+  std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+  end_ -= begin_;
+  begin_ = 0;
+  if (end_ == capacity())
+    buffer_.resize(2 * capacity() + padding_);
+  auto* sb = input_.rdbuf();
+  if (sb == nullptr) {
+    exhausted_ = true;
+    return false;
+  }
+  auto* fd = dynamic_cast<fdinbuf*>(sb);
+  if (fd)
+    fd->read_timeout() = timeout;
+  auto timed_out = false;
+  using traits_type = std::streambuf::traits_type;
+  if (traits_type::eq_int_type(sb->sgetc(), traits_type::eof())) {
+    timed_out = fd != nullptr && fd->timed_out();
+    exhausted_ = !timed_out;
+  } else {
+    // Consume everything that we can get without blocking.
+    while (end_ < capacity()) {
+      auto available = sb->in_avail();
+      if (available <= 0)
+        break;
+      auto n = sb->sgetn(buffer_.data() + end_,
+                         std::min(static_cast<std::streamsize>(available),
+                                  static_cast<std::streamsize>(capacity()
+                                                               - end_)));
+      if (n <= 0)
+        break;
+      end_ += static_cast<size_t>(n);
+    }
+  }
+  if (fd)
+    fd->read_timeout() = std::nullopt;
+  return timed_out;
+}
+
+size_t padded_line_range::capacity() const {
+  return buffer_.size() - padding_;
+}
+
+} // namespace vast::detail
@@ -0,0 +1,917 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/detail/regex.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
+
+#include <caf/error.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <regex>
+#include <utility>
+
+namespace vast::detail {
+
+namespace {
+
+using byte_set = std::bitset<256>;
+
+constexpr size_t unbounded = std::numeric_limits<size_t>::max();
+
+/// The maximum bound of a counted repetition such as `x{2,5}`.
+constexpr size_t max_repetitions = 1'000;
+
+/// The maximum number of NFA states. Larger expressions, which usually stem
+/// from nested counted repetitions, fall back to `std::regex`.
+constexpr size_t max_nfa_states = 10'000;
+
+/// The maximum number of DFA states. Expressions that exceed it keep matching
+/// in linear time by simulating the NFA directly.
+constexpr size_t max_dfa_states = 1'024;
+
+// -- abstract syntax ----------------------------------------------------------
+
+struct node {
+  enum class kind { empty, bytes, concat, alternate, repeat, begin, end };
+  kind k = kind::empty;
+  byte_set set = {};
+  std::vector<node> children = {};
+  size_t min = 0;
+  size_t max = 0;
+};
+
+node make_byte(char c) {
+  auto result = node{node::kind::bytes};
+  result.set.set(static_cast<uint8_t>(c));
+  return result;
+}
+
+byte_set make_range(char first, char last) {
+  auto result = byte_set{};
+  for (auto c = static_cast<uint8_t>(first); c <= static_cast<uint8_t>(last);
+       ++c)
+    result.set(c);
+  return result;
+}
+
+byte_set digits() {
+  return make_range('0', '9');
+}
+
+byte_set word_chars() {
+  return make_range('a', 'z') | make_range('A', 'Z') | digits()
+         | make_range('_', '_');
+}
+
+byte_set whitespace() {
+  return make_range('\t', '\r') | make_range(' ', ' ');
+}
+
+/// Parses the subset of the ECMAScript grammar that describes regular
+/// languages. The parser rejects everything else, including invalid
+/// expressions, so that `std::regex` has the final say about them.
+class parser {
+public:
+  explicit parser(std::string_view str) : str_{str} {
+  }
+
+  std::optional<node> parse() {
+    auto result = parse_alternation();
+    if (!result || !at_end())
+      return std::nullopt;
+    return result;
+  }
+
+private:
+  bool at_end() const {
+    return pos_ == str_.size();
+  }
+
+  char peek() const {
+    return str_[pos_];
+  }
+
+  std::optional<node> parse_alternation() {
+    auto first = parse_concatenation();
+    if (!first || at_end() || peek() != '|')
+      return first;
+    auto result = node{node::kind::alternate};
+    result.children.push_back(std::move(*first));
+    while (!at_end() && peek() == '|') {
+      ++pos_;
+      auto next = parse_concatenation();
+      if (!next)
+        return std::nullopt;
+      result.children.push_back(std::move(*next));
+    }
+    return result;
+  }
+
+  std::optional<node> parse_concatenation() {
+    auto result = node{node::kind::concat};
+    while (!at_end() && peek() != '|' && peek() != ')') {
+      auto x = parse_atom();
+      if (!x || !parse_quantifier(*x))
+        return std::nullopt;
+      result.children.push_back(std::move(*x));
+    }
+    return result;
+  }
+
+  bool parse_quantifier(node& x) {
+    if (at_end())
+      return true;
+    auto min = size_t{0};
+    auto max = size_t{0};
+    switch (peek()) {
+      default:
+        return true;
+      case '*':
+        max = unbounded;
+        ++pos_;
+        break;
+      case '+':
+        min = 1;
+        max = unbounded;
+        ++pos_;
+        break;
+      case '?':
+        max = 1;
+        ++pos_;
+        break;
+      case '{':
+        if (!parse_bounds(min, max))
+          return false;
+        break;
+    }
+    if (x.k == node::kind::begin || x.k == node::kind::end)
+      return false;
+    // Lazy quantifiers accept the same strings as greedy ones.
+    if (!at_end() && peek() == '?')
+      ++pos_;
+    // Leave quantified quantifiers to std::regex, which rejects them.
+    if (!at_end()
+        && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{'))
+      return false;
+    auto repeat = node{node::kind::repeat};
+    repeat.min = min;
+    repeat.max = max;
+    repeat.children.push_back(std::move(x));
+    x = std::move(repeat);
+    return true;
+  }
+
+  bool parse_number(size_t& x) {
+    auto first = pos_;
+    x = 0;
+    while (!at_end() && peek() >= '0' && peek() <= '9') {
+      x = x * 10 + (peek() - '0');
+      if (x > max_repetitions)
+        return false;
+      ++pos_;
+    }
+    return pos_ != first;
+  }
+
+  bool parse_bounds(size_t& min, size_t& max) {
+    ++pos_;
+    if (!parse_number(min) || at_end())
+      return false;
+    if (peek() == '}') {
+      ++pos_;
+      max = min;
+      return true;
+    }
+    if (peek() != ',')
+      return false;
+    ++pos_;
+    if (at_end())
+      return false;
+    if (peek() == '}') {
+      ++pos_;
+      max = unbounded;
+      return true;
+    }
+    if (!parse_number(max) || at_end() || peek() != '}' || max < min)
+      return false;
+    ++pos_;
+    return true;
+  }
+
+  std::optional<node> parse_atom() {
+    auto c = str_[pos_++];
+    switch (c) {
+      default:
+        return make_byte(c);
+      case '^':
+        return node{node::kind::begin};
+      case '$':
+        return node{node::kind::end};
+      case '.': {
+        // In ECMAScript, the dot does not match line terminators.
+        auto result = node{node::kind::bytes};
+        result.set.set();
+        result.set.reset('\n');
+        result.set.reset('\r');
+        return result;
+      }
+      case '(': {
+        if (!at_end() && peek() == '?') {
+          // Only non-capturing groups describe regular languages.
+          if (pos_ + 1 >= str_.size() || str_[pos_ + 1] != ':')
+            return std::nullopt;
+          pos_ += 2;
+        }
+        auto result = parse_alternation();
+        if (!result || at_end() || peek() != ')')
+          return std::nullopt;
+        ++pos_;
+        return result;
+      }
+      case '[':
+        return parse_class();
+      case '\\': {
+        auto result = node{node::kind::bytes};
+        auto single = false;
+        if (!parse_escape(result.set, single))
+          return std::nullopt;
+        return result;
+      }
+      case ')':
+      case ']':
+      case '{':
+      case '}':
+      case '*':
+      case '+':
+      case '?':
+        return std::nullopt;
+    }
+  }
+
+  /// Parses an escape sequence after the backslash.
+  /// @param set The set to add the escaped bytes to.
+  /// @param single Set to `true` if the escape denotes a single byte.
+  bool parse_escape(byte_set& set, bool& single) {
+    if (at_end())
+      return false;
+    auto c = str_[pos_++];
+    single = true;
+    auto add = [&](byte_set xs) {
+      set |= xs;
+      single = false;
+      return true;
+    };
+    auto add_byte = [&](char x) {
+      set.set(static_cast<uint8_t>(x));
+      return true;
+    };
+    switch (c) {
+      case 'd':
+        return add(digits());
+      case 'D':
+        return add(~digits());
+      case 'w':
+        return add(word_chars());
+      case 'W':
+        return add(~word_chars());
+      case 's':
+        return add(whitespace());
+      case 'S':
+        return add(~whitespace());
+      case 't':
+        return add_byte('\t');
+      case 'n':
+        return add_byte('\n');
+      case 'r':
+        return add_byte('\r');
+      case 'f':
+        return add_byte('\f');
+      case 'v':
+        return add_byte('\v');
+      case '0':
+        if (!at_end() && peek() >= '0' && peek() <= '9')
+          return false;
+        return add_byte('\0');
+      case 'x': {
+        auto hex = [](char x) -> int {
+          if (x >= '0' && x <= '9')
+            return x - '0';
+          if (x >= 'a' && x <= 'f')
+            return x - 'a' + 10;
+          if (x >= 'A' && x <= 'F')
+            return x - 'A' + 10;
+          return -1;
+        };
+        if (pos_ + 2 > str_.size())
+          return false;
+        auto hi = hex(str_[pos_]);
+        auto lo = hex(str_[pos_ + 1]);
+        if (hi < 0 || lo < 0)
+          return false;
+        pos_ += 2;
+        return add_byte(static_cast<char>(hi << 4 | lo));
+      }
+      default:
+        // Identity escapes of punctuation; letters and digits denote word
+        // boundaries, backreferences, or other constructs we don't support.
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+            || (c >= '0' && c <= '9'))
+          return false;
+        return add_byte(c);
+    }
+  }
+
+  /// Parses a single element of a character class.
+  /// @param set The set to add the element to.
+  /// @param single Set to `true` if the element denotes a single byte.
+  bool parse_class_atom(byte_set& set, bool& single) {
+    if (at_end())
+      return false;
+    auto c = str_[pos_++];
+    if (c == '\\') {
+      // Inside a class, `\b` denotes a backspace; we leave it to std::regex.
+      if (!at_end() && peek() == 'b')
+        return false;
+      return parse_escape(set, single);
+    }
+    // Leave POSIX classes, equivalence classes, and collating elements to
+    // std::regex.
+    if (c == '[' && !at_end()
+        && (peek() == ':' || peek() == '=' || peek() == '.'))
+      return false;
+    set.set(static_cast<uint8_t>(c));
+    single = true;
+    return true;
+  }
+
+  std::optional<node> parse_class() {
+    auto negated = !at_end() && peek() == '^';
+    if (negated)
+      ++pos_;
+    // Leave empty classes to std::regex, whose treatment of them varies.
+    if (at_end() || peek() == ']')
+      return std::nullopt;
+    auto result = node{node::kind::bytes};
+    while (!at_end() && peek() != ']') {
+      auto first = byte_set{};
+      auto single = false;
+      if (!parse_class_atom(first, single))
+        return std::nullopt;
+      auto is_range = !at_end() && peek() == '-' && pos_ + 1 < str_.size()
+                      && str_[pos_ + 1] != ']';
+      if (!is_range) {
+        result.set |= first;
+        continue;
+      }
+      ++pos_;
+      auto last = byte_set{};
+      auto last_single = false;
+      if (!single || !parse_class_atom(last, last_single) || !last_single)
+        return std::nullopt;
+      auto lo = first_byte(first);
+      auto hi = first_byte(last);
+      if (lo > hi)
+        return std::nullopt;
+      result.set |= make_range(static_cast<char>(lo), static_cast<char>(hi));
+    }
+    if (at_end())
+      return std::nullopt;
+    ++pos_;
+    if (negated)
+      result.set.flip();
+    return result;
+  }
+
+  static uint8_t first_byte(const byte_set& set) {
+    for (size_t i = 0; i < set.size(); ++i)
+      if (set.test(i))
+        return static_cast<uint8_t>(i);
+    VAST_ASSERT(!"class atom without a byte");
+    return 0;
+  }
+
+  std::string_view str_;
+  size_t pos_ = 0;
+};
+
+// -- literal extraction -------------------------------------------------------
+
+struct literal_info {
+  /// Whether the node matches exactly `str`.
+  bool exact = false;
+  std::string str = {};
+
+  /// Literals that every match of the node contains.
+  std::vector<std::string> required = {};
+
+  /// Returns all literals that every match contains, including `str` for
+  /// exact nodes.
+  std::vector<std::string> all() const {
+    auto result = required;
+    if (exact && !str.empty())
+      result.push_back(str);
+    return result;
+  }
+};
+
+literal_info analyze(const node& x) {
+  auto result = literal_info{};
+  switch (x.k) {
+    case node::kind::empty:
+    case node::kind::begin:
+    case node::kind::end:
+      result.exact = true;
+      break;
+    case node::kind::bytes:
+      if (x.set.count() == 1) {
+        result.exact = true;
+        for (size_t i = 0; i < x.set.size(); ++i)
+          if (x.set.test(i))
+            result.str.push_back(static_cast<char>(i));
+      }
+      break;
+    case node::kind::concat: {
+      // Adjacent exact children form a literal that every match contains.
+      auto run = std::string{};
+      auto flush = [&] {
+        if (!run.empty())
+          result.required.push_back(std::move(run));
+        run.clear();
+      };
+      result.exact = true;
+      for (const auto& child : x.children) {
+        auto info = analyze(child);
+        if (info.exact) {
+          run += info.str;
+          continue;
+        }
+        result.exact = false;
+        flush();
+        result.required.insert(result.required.end(), info.required.begin(),
+                               info.required.end());
+      }
+      if (result.exact)
+        result.str = std::move(run);
+      else
+        flush();
+      break;
+    }
+    case node::kind::alternate: {
+      // Every match contains the literals that all alternatives require.
+      auto common = analyze(x.children.front());
+      auto literals = common.all();
+      result.exact = common.exact;
+      for (size_t i = 1; i < x.children.size(); ++i) {
+        auto info = analyze(x.children[i]);
+        result.exact = result.exact && info.exact && info.str == common.str;
+        auto others = info.all();
+        literals.erase(std::remove_if(literals.begin(), literals.end(),
+                                      [&](const auto& literal) {
+                                        return std::find(others.begin(),
+                                                         others.end(), literal)
+                                               == others.end();
+                                      }),
+                       literals.end());
+      }
+      if (result.exact)
+        result.str = std::move(common.str);
+      else
+        result.required = std::move(literals);
+      break;
+    }
+    case node::kind::repeat: {
+      if (x.min == 0) {
+        result.exact = x.max == 0;
+        break;
+      }
+      auto info = analyze(x.children.front());
+      if (info.exact && x.min == x.max) {
+        result.exact = true;
+        for (size_t i = 0; i < x.min; ++i)
+          result.str += info.str;
+      } else {
+        result.required = info.all();
+      }
+      break;
+    }
+  }
+  return result;
+}
+
+std::vector<std::string> extract_literals(const node& root) {
+  auto result = analyze(root).all();
+  std::sort(result.begin(), result.end(), [](const auto& x, const auto& y) {
+    return x.size() != y.size() ? x.size() > y.size() : x < y;
+  });
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  // Drop literals that are part of a longer literal.
+  auto redundant = [&](const auto& x) {
+    return std::any_of(result.begin(), result.end(), [&](const auto& y) {
+      return y.size() > x.size() && y.find(x) != std::string::npos;
+    });
+  };
+  auto literals = std::vector<std::string>{};
+  for (const auto& literal : result)
+    if (!redundant(literal))
+      literals.push_back(literal);
+  return literals;
+}
+
+// -- nondeterministic finite automaton ----------------------------------------
+
+struct nfa_state {
+  enum class kind : uint8_t { bytes, split, epsilon, begin, end, accept };
+  kind k;
+  uint32_t out = 0;
+  uint32_t out1 = 0;
+  uint32_t set = 0;
+};
+
+struct nfa {
+  std::vector<nfa_state> states = {};
+  std::vector<byte_set> sets = {};
+  uint32_t start = 0;
+  uint32_t accept = 0;
+};
+
+/// Builds an NFA by Thompson's construction.
+class nfa_builder {
+public:
+  std::optional<nfa> build(const node& root) {
+    auto [entry, exit] = compile(root);
+    result_.accept = add(nfa_state::kind::accept);
+    result_.states[exit].out = result_.accept;
+    result_.start = entry;
+    if (overflow_)
+      return std::nullopt;
+    return std::move(result_);
+  }
+
+private:
+  /// A partial automaton with a single entry state and an epsilon state as
+  /// its exit, whose successor is yet unknown.
+  using fragment = std::pair<uint32_t, uint32_t>;
+
+  uint32_t add(nfa_state::kind k, uint32_t out = 0, uint32_t out1 = 0) {
+    if (result_.states.size() >= max_nfa_states)
+      overflow_ = true;
+    result_.states.push_back({k, out, out1, 0});
+    return static_cast<uint32_t>(result_.states.size() - 1);
+  }
+
+  fragment single(nfa_state::kind k) {
+    auto entry = add(k);
+    auto exit = add(nfa_state::kind::epsilon);
+    result_.states[entry].out = exit;
+    return {entry, exit};
+  }
+
+  fragment compile(const node& x) {
+    switch (x.k) {
+      case node::kind::empty: {
+        auto state = add(nfa_state::kind::epsilon);
+        return {state, state};
+      }
+      case node::kind::bytes: {
+        auto result = single(nfa_state::kind::bytes);
+        auto it = std::find(result_.sets.begin(), result_.sets.end(), x.set);
+        if (it == result_.sets.end())
+          it = result_.sets.insert(result_.sets.end(), x.set);
+        result_.states[result.first].set
+          = static_cast<uint32_t>(it - result_.sets.begin());
+        return result;
+      }
+      case node::kind::begin:
+        return single(nfa_state::kind::begin);
+      case node::kind::end:
+        return single(nfa_state::kind::end);
+      case node::kind::concat: {
+        auto result = fragment{};
+        result.first = result.second = add(nfa_state::kind::epsilon);
+        for (const auto& child : x.children) {
+          if (overflow_)
+            break;
+          auto [entry, exit] = compile(child);
+          result_.states[result.second].out = entry;
+          result.second = exit;
+        }
+        return result;
+      }
+      case node::kind::alternate: {
+        auto exit = add(nfa_state::kind::epsilon);
+        auto entry = uint32_t{0};
+        for (auto i = x.children.size(); i > 0 && !overflow_; --i) {
+          auto child = compile(x.children[i - 1]);
+          result_.states[child.second].out = exit;
+          entry = i == x.children.size()
+                    ? child.first
+                    : add(nfa_state::kind::split, child.first, entry);
+        }
+        return {entry, exit};
+      }
+      case node::kind::repeat: {
+        const auto& child = x.children.front();
+        auto entry = add(nfa_state::kind::epsilon);
+        auto last = entry;
+        for (size_t i = 0; i < x.min && !overflow_; ++i) {
+          auto [first, exit] = compile(child);
+          result_.states[last].out = first;
+          last = exit;
+        }
+        auto exit = add(nfa_state::kind::epsilon);
+        if (x.max == unbounded) {
+          auto [first, loop] = compile(child);
+          auto split = add(nfa_state::kind::split, first, exit);
+          result_.states[loop].out = split;
+          result_.states[last].out = split;
+          return {entry, exit};
+        }
+        for (auto i = x.min; i < x.max && !overflow_; ++i) {
+          auto [first, next] = compile(child);
+          auto split = add(nfa_state::kind::split, first, exit);
+          result_.states[last].out = split;
+          last = next;
+        }
+        result_.states[last].out = exit;
+        return {entry, exit};
+      }
+    }
+    VAST_ASSERT(!"unhandled node kind");
+    return {};
+  }
+
+  nfa result_ = {};
+  bool overflow_ = false;
+};
+
+/// Computes the states that consume input or accept, and which are reachable
+/// from a set of states via epsilon transitions and satisfied assertions.
+class closure {
+public:
+  explicit closure(const nfa& automaton)
+    : nfa_{automaton}, marks_(automaton.states.size(), 0) {
+  }
+
+  const std::vector<uint32_t>&
+  operator()(const std::vector<uint32_t>& kernel, bool at_begin, bool at_end) {
+    ++generation_;
+    result_.clear();
+    stack_.assign(kernel.begin(), kernel.end());
+    while (!stack_.empty()) {
+      auto id = stack_.back();
+      stack_.pop_back();
+      if (marks_[id] == generation_)
+        continue;
+      marks_[id] = generation_;
+      const auto& state = nfa_.states[id];
+      switch (state.k) {
+        case nfa_state::kind::bytes:
+        case nfa_state::kind::accept:
+          result_.push_back(id);
+          break;
+        case nfa_state::kind::split:
+          stack_.push_back(state.out1);
+          stack_.push_back(state.out);
+          break;
+        case nfa_state::kind::epsilon:
+          stack_.push_back(state.out);
+          break;
+        case nfa_state::kind::begin:
+          if (at_begin)
+            stack_.push_back(state.out);
+          break;
+        case nfa_state::kind::end:
+          if (at_end)
+            stack_.push_back(state.out);
+          break;
+      }
+    }
+    std::sort(result_.begin(), result_.end());
+    return result_;
+  }
+
+  bool accepts(const std::vector<uint32_t>& closed) const {
+    return std::binary_search(closed.begin(), closed.end(), nfa_.accept);
+  }
+
+  /// Computes the states after consuming a byte.
+  void step(const std::vector<uint32_t>& closed, uint8_t byte, bool search,
+            std::vector<uint32_t>& next) const {
+    next.clear();
+    for (auto id : closed) {
+      const auto& state = nfa_.states[id];
+      if (state.k == nfa_state::kind::bytes && nfa_.sets[state.set].test(byte))
+        next.push_back(state.out);
+    }
+    // An unanchored search may start a new match at every position.
+    if (search)
+      next.push_back(nfa_.start);
+    std::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+  }
+
+private:
+  const nfa& nfa_;
+  std::vector<uint32_t> marks_;
+  uint32_t generation_ = 0;
+  std::vector<uint32_t> stack_ = {};
+  std::vector<uint32_t> result_ = {};
+};
+
+bool simulate(const nfa& automaton, std::string_view str, bool search) {
+  auto close = closure{automaton};
+  auto kernel = std::vector<uint32_t>{automaton.start};
+  auto next = std::vector<uint32_t>{};
+  auto at_begin = true;
+  for (auto c : str) {
+    const auto& closed = close(kernel, at_begin, false);
+    if (search && close.accepts(closed))
+      return true;
+    if (!search && closed.empty())
+      return false;
+    close.step(closed, static_cast<uint8_t>(c), search, next);
+    kernel.swap(next);
+    at_begin = false;
+  }
+  return close.accepts(close(kernel, at_begin, true));
+}
+
+// -- deterministic finite automaton -------------------------------------------
+
+/// Partitions all bytes into classes that no transition of an NFA
+/// distinguishes, which keeps the transition table of a DFA small.
+struct byte_classes {
+  explicit byte_classes(const nfa& automaton) {
+    for (const auto& set : automaton.sets) {
+      auto remap = std::array<int, 512>{};
+      remap.fill(-1);
+      auto next = 0;
+      for (size_t byte = 0; byte < 256; ++byte) {
+        auto& id = remap[classes[byte] * 2 + set.test(byte)];
+        if (id < 0)
+          id = next++;
+        classes[byte] = static_cast<uint8_t>(id);
+      }
+      size = static_cast<size_t>(next);
+    }
+    representatives.resize(size);
+    for (size_t byte = 256; byte > 0; --byte)
+      representatives[classes[byte - 1]] = static_cast<uint8_t>(byte - 1);
+  }
+
+  std::array<uint8_t, 256> classes = {};
+  size_t size = 1;
+  std::vector<uint8_t> representatives = {};
+};
+
+struct dfa {
+  static constexpr uint8_t accepts_now = 1;
+  static constexpr uint8_t accepts_at_end = 2;
+  static constexpr uint8_t dead = 4;
+
+  std::vector<uint32_t> transitions = {};
+  std::vector<uint8_t> flags = {};
+};
+
+/// Builds a DFA by subset construction.
+/// @returns The DFA, or `std::nullopt` if it requires too many states.
+std::optional<dfa>
+make_dfa(const nfa& automaton, const byte_classes& classes, bool search) {
+  using key = std::pair<std::vector<uint32_t>, bool>;
+  auto ids = std::map<key, uint32_t>{};
+  auto kernels = std::vector<key>{};
+  auto intern = [&](std::vector<uint32_t> kernel, bool at_begin) {
+    auto k = key{std::move(kernel), at_begin};
+    auto [it, inserted]
+      = ids.emplace(k, static_cast<uint32_t>(kernels.size()));
+    if (inserted)
+      kernels.push_back(std::move(k));
+    return it->second;
+  };
+  auto result = dfa{};
+  auto close = closure{automaton};
+  auto next = std::vector<uint32_t>{};
+  intern({automaton.start}, true);
+  for (size_t id = 0; id < kernels.size(); ++id) {
+    if (kernels.size() > max_dfa_states)
+      return std::nullopt;
+    auto [kernel, at_begin] = kernels[id];
+    auto flags = uint8_t{0};
+    if (close.accepts(close(kernel, at_begin, true)))
+      flags |= dfa::accepts_at_end;
+    const auto closed = close(kernel, at_begin, false);
+    if (close.accepts(closed))
+      flags |= dfa::accepts_now;
+    // A search can start a new match after every byte, so only anchored
+    // matches get stuck.
+    if (!search && closed.empty())
+      flags |= dfa::dead;
+    result.flags.push_back(flags);
+    for (size_t c = 0; c < classes.size; ++c) {
+      close.step(closed, classes.representatives[c], search, next);
+      result.transitions.push_back(intern(next, false));
+    }
+  }
+  return result;
+}
+
+bool run(const dfa& automaton, const byte_classes& classes,
+         std::string_view str, bool search) {
+  auto state = uint32_t{0};
+  for (auto c : str) {
+    auto flags = automaton.flags[state];
+    if (search && (flags & dfa::accepts_now))
+      return true;
+    if (flags & dfa::dead)
+      return false;
+    state = automaton.transitions[state * classes.size
+                                  + classes.classes[static_cast<uint8_t>(c)]];
+  }
+  return automaton.flags[state] & dfa::accepts_at_end;
+}
+
+} // namespace
+
+struct regex::impl {
+  explicit impl(nfa x) : automaton{std::move(x)}, classes{automaton} {
+  }
+
+  explicit impl(std::regex x) : classes{automaton}, fallback{std::move(x)} {
+  }
+
+  nfa automaton = {};
+  byte_classes classes;
+  std::optional<dfa> match_dfa = {};
+  std::optional<dfa> search_dfa = {};
+  std::optional<std::regex> fallback = {};
+  std::vector<std::string> literals = {};
+};
+
+caf::expected<regex> regex::make(std::string_view str) {
+  auto result = regex{};
+  if (auto root = parser{str}.parse()) {
+    if (auto automaton = nfa_builder{}.build(*root)) {
+      result.impl_ = std::make_unique<impl>(std::move(*automaton));
+      auto& x = *result.impl_;
+      x.match_dfa = make_dfa(x.automaton, x.classes, false);
+      x.search_dfa = make_dfa(x.automaton, x.classes, true);
+      x.literals = extract_literals(*root);
+      return result;
+    }
+  }
+  try {
+    result.impl_ = std::make_unique<impl>(std::regex{str.begin(), str.end()});
+  } catch (const std::regex_error& err) {
+    return caf::make_error(ec::syntax_error,
+                           "failed to create regular expression from pattern",
+                           std::string{str}, err.what());
+  }
+  return result;
+}
+
+regex::regex() = default;
+
+regex::regex(regex&&) noexcept = default;
+
+regex& regex::operator=(regex&&) noexcept = default;
+
+regex::~regex() noexcept = default;
+
+bool regex::match(std::string_view str) const {
+  if (impl_->fallback)
+    return std::regex_match(str.begin(), str.end(), *impl_->fallback);
+  if (impl_->match_dfa)
+    return run(*impl_->match_dfa, impl_->classes, str, false);
+  return simulate(impl_->automaton, str, false);
+}
+
+bool regex::search(std::string_view str) const {
+  if (impl_->fallback)
+    return std::regex_search(str.begin(), str.end(), *impl_->fallback);
+  if (impl_->search_dfa)
+    return run(*impl_->search_dfa, impl_->classes, str, true);
+  return simulate(impl_->automaton, str, true);
+}
+
+const std::vector<std::string>& regex::required_literals() const noexcept {
+  return impl_->literals;
+}
+
+bool regex::is_automaton() const noexcept {
+  return !impl_->fallback;
+}
+
+} // namespace vast::detail
@@ -0,0 +1,111 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/ewah_arena.hpp"
+
+#include "vast/chunk.hpp"
+#include "vast/detail/endian.hpp"
+#include "vast/error.hpp"
+#include "vast/ewah_bitmap.hpp"
+
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace vast {
+
+namespace {
+
+thread_local ewah_arena* current_arena = nullptr;
+
+} // namespace
+
+ewah_arena::scope::scope(ewah_arena* arena) noexcept
+  : previous_{std::exchange(current_arena, arena)} {
+  // nop
+}
+
+ewah_arena::scope::~scope() noexcept {
+  current_arena = previous_;
+}
+
+ewah_arena::ewah_arena() noexcept = default;
+
+ewah_arena::ewah_arena(chunk_ptr chunk, span<const uint64_t> blocks) {
+  VAST_ASSERT(chunk);
+  static_assert(std::is_same_v<ewah_bitmap::block_type, uint64_t>);
+  auto aligned
+    = reinterpret_cast<uintptr_t>(blocks.data()) % alignof(uint64_t) == 0;
+  if (VAST_LITTLE_ENDIAN && aligned) {
+    chunk_ = std::move(chunk);
+    view_ = blocks;
+    return;
+  }
+  // We cannot use the blocks in place, so we copy them once into a chunk that
+  // all deserialized bitmaps share.
+  auto copy = std::make_unique<std::vector<uint64_t>>(blocks.size());
+  std::memcpy(copy->data(), blocks.data(), blocks.size() * sizeof(uint64_t));
+#if VAST_BIG_ENDIAN
+  for (auto& block : *copy)
+    block = __builtin_bswap64(block);
+#endif
+  view_ = span<const uint64_t>{copy->data(), copy->size()};
+  chunk_ = chunk::make(as_bytes(view_), [copy = std::move(copy)]() noexcept {
+    // nop; the lambda owns the copy.
+  });
+}
+
+span<const uint64_t> ewah_arena::blocks() const noexcept {
+  if (chunk_)
+    return view_;
+  return span<const uint64_t>{collected_.data(), collected_.size()};
+}
+
+ewah_arena::scope ewah_arena::activate() noexcept {
+  return scope{this};
+}
+
+ewah_arena* ewah_arena::current() noexcept {
+  return current_arena;
+}
+
+caf::error ewah_arena::apply(caf::serializer& sink, ewah_bitmap& bm) {
+  VAST_ASSERT(!chunk_, "cannot serialize into a read-only arena");
+  auto xs = bm.blocks();
+  uint64_t offset = collected_.size();
+  uint64_t size = xs.size();
+  collected_.insert(collected_.end(), xs.begin(), xs.end());
+  return sink(offset, size, bm.last_marker_, bm.num_bits_);
+}
+
+caf::error ewah_arena::apply(caf::deserializer& source, ewah_bitmap& bm) {
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  ewah_bitmap::size_type last_marker = 0;
+  ewah_bitmap::size_type num_bits = 0;
+  if (auto err = source(offset, size, last_marker, num_bits))
+    return err;
+  auto xs = blocks();
+  if (offset > xs.size() || size > xs.size() - offset
+      || (size > 0 && last_marker >= size))
+    return caf::make_error(ec::format_error, "EWAH bitmap exceeds the bounds "
+                                             "of its arena");
+  if (size == 0) {
+    bm = ewah_bitmap{};
+    return caf::none;
+  }
+  bm = ewah_bitmap{chunk_, xs.subspan(offset, size), last_marker, num_bits};
+  return caf::none;
+}
+
+} // namespace vast
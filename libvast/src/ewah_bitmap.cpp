@@ -8,12 +8,25 @@
 
 #include "vast/ewah_bitmap.hpp"
 
+#include <algorithm>
+
 namespace vast {
 
 ewah_bitmap::ewah_bitmap(size_type n, bool bit) {
   append_bits(bit, n);
 }
 
+ewah_bitmap::ewah_bitmap(chunk_ptr chunk, span<const block_type> blocks,
+                         size_type last_marker, size_type num_bits)
+  : last_marker_{last_marker},
+    num_bits_{num_bits},
+    chunk_{std::move(chunk)},
+    view_{blocks} {
+  VAST_ASSERT(chunk_);
+  VAST_ASSERT(blocks.size() >= 2);
+  VAST_ASSERT(last_marker_ < blocks.size());
+}
+
 bool ewah_bitmap::empty() const {
   return num_bits_ == 0;
 }
@@ -23,14 +36,19 @@ ewah_bitmap::size_type ewah_bitmap::size() const {
 }
 
 size_t ewah_bitmap::memusage() const {
+  // Referenced blocks are not accounted for, because they are owned by the
+  // chunk and typically memory-mapped.
   return blocks_.capacity() * sizeof(block_type);
 }
 
-const ewah_bitmap::block_vector& ewah_bitmap::blocks() const {
-  return blocks_;
+span<const ewah_bitmap::block_type> ewah_bitmap::blocks() const {
+  if (chunk_)
+    return view_;
+  return span<const block_type>{blocks_.data(), blocks_.size()};
 }
 
 void ewah_bitmap::append_bit(bool bit) {
+  detach();
   auto partial = num_bits_ % word_type::width;
   if (blocks_.empty()) {
     blocks_.push_back(0); // Always begin with an empty marker.
@@ -46,6 +64,7 @@ void ewah_bitmap::append_bit(bool bit) {
 }
 
 void ewah_bitmap::append_bits(bool bit, size_type n) {
+  detach();
   if (n == 0)
     return;
   if (blocks_.empty()) {
@@ -120,6 +139,7 @@ void ewah_bitmap::append_bits(bool bit, size_type n) {
 }
 
 void ewah_bitmap::append_block(block_type value, size_type bits) {
+  detach();
   VAST_ASSERT(bits > 0);
   VAST_ASSERT(bits <= word_type::width);
   if (blocks_.empty())
@@ -148,6 +168,7 @@ void ewah_bitmap::append_block(block_type value, size_type bits) {
 }
 
 void ewah_bitmap::flip() {
+  detach();
   if (blocks_.empty())
     return;
   VAST_ASSERT(blocks_.size() >= 2);
@@ -171,6 +192,14 @@ void ewah_bitmap::flip() {
     blocks_.back() &= word_type::lsb_mask(partial);
 }
 
+void ewah_bitmap::detach() {
+  if (!chunk_)
+    return;
+  blocks_.assign(view_.begin(), view_.end());
+  view_ = {};
+  chunk_ = nullptr;
+}
+
 void ewah_bitmap::integrate_last_block() {
   VAST_ASSERT(blocks_.size() >= 2); // at least one marker plus dirty block
   VAST_ASSERT(last_marker_ < blocks_.size() - 1); // no marker as last block
@@ -236,7 +265,10 @@ void ewah_bitmap::bump_dirty_count() {
 bool operator==(const ewah_bitmap& x, const ewah_bitmap& y) {
   // If the block vector and the number of bits are equal, so must be the
   // marker by construction.
-  return x.blocks_ == y.blocks_ && x.num_bits_ == y.num_bits_;
+  auto xs = x.blocks();
+  auto ys = y.blocks();
+  return x.num_bits_ == y.num_bits_
+         && std::equal(xs.begin(), xs.end(), ys.begin(), ys.end());
 }
 
 ewah_bitmap_range::ewah_bitmap_range(const ewah_bitmap& bm)
@@ -27,7 +27,6 @@
 #include "vast/view.hpp"
 
 #include <algorithm>
-#include <regex>
 
 namespace vast {
 
@@ -282,15 +281,11 @@ caf::expected<void> validator::operator()(const negation& n) {
 caf::expected<void> validator::operator()(const predicate& p) {
   op_ = p.op;
   // If rhs is a pattern, validate early that it is a valid regular expression.
+  // This also compiles the pattern once for all copies of the expression.
   if (auto dat = caf::get_if<data>(&p.rhs))
     if (auto pat = caf::get_if<pattern>(dat))
-      try {
-        [[maybe_unused]] auto r = std::regex{pat->string()};
-      } catch (const std::regex_error& err) {
-        return caf::make_error(
-          ec::syntax_error, "failed to create regular expression from pattern",
-          pat->string(), err.what());
-      }
+      if (auto rx = pat->compiled(); !rx)
+        return std::move(rx.error());
   return caf::visit(*this, p.lhs, p.rhs);
 }
 
@@ -15,33 +15,148 @@
 #  include "vast/detail/assert.hpp"
 #  include "vast/detail/byte_swap.hpp"
 #  include "vast/detail/fdoutbuf.hpp"
+#  include "vast/detail/narrow.hpp"
 #  include "vast/detail/string.hpp"
 #  include "vast/error.hpp"
 #  include "vast/format/arrow.hpp"
+#  include "vast/logger.hpp"
 #  include "vast/table_slice_builder.hpp"
 #  include "vast/type.hpp"
 
+#  include <arrow/buffer.h>
+#  include <arrow/record_batch.h>
+#  include <arrow/result.h>
 #  include <arrow/util/config.h>
 #  include <arrow/util/io_util.h>
+#  include <arrow/util/key_value_metadata.h>
+#  include <caf/binary_deserializer.hpp>
+#  include <caf/binary_serializer.hpp>
 #  include <caf/none.hpp>
+#  include <caf/settings.hpp>
 
+#  include <algorithm>
+#  include <iterator>
 #  include <stdexcept>
+#  include <string_view>
 
 namespace vast::format::arrow {
 
+namespace {
+
+/// The magic bytes at the beginning of an Arrow IPC file.
+constexpr std::string_view file_magic = "ARROW1";
+
+/// Maps an Arrow type to the VAST type with the same Arrow representation.
+std::optional<type> infer_type(const ::arrow::DataType& arrow_type) {
+  if (arrow_type.id() == ::arrow::Type::LIST) {
+    const auto& list = static_cast<const ::arrow::ListType&>(arrow_type);
+    if (auto value_type = infer_type(*list.value_type()))
+      return list_type{std::move(*value_type)};
+    return std::nullopt;
+  }
+  // Types that share an Arrow representation resolve to the first candidate,
+  // e.g., int64 maps to integer rather than duration.
+  auto candidates = std::vector<type>{bool_type{},     integer_type{},
+                                      count_type{},    real_type{},
+                                      time_type{},     duration_type{},
+                                      string_type{}};
+  for (auto& candidate : candidates)
+    if (make_arrow_type(candidate)->Equals(arrow_type))
+      return std::move(candidate);
+  return std::nullopt;
+}
+
+} // namespace
+
+std::shared_ptr<::arrow::Schema> make_schema(const record_type& layout) {
+  auto schema = make_arrow_schema(layout);
+  auto buffer = std::vector<char>{};
+  caf::binary_serializer sink{nullptr, buffer};
+  if (auto err = sink(layout)) {
+    VAST_WARN("arrow-writer failed to serialize layout {}: {}", layout.name(),
+              render(err));
+    return schema;
+  }
+  auto metadata = ::arrow::key_value_metadata(
+    {{"name", layout.name()},
+     {layout_metadata_key, std::string{buffer.begin(), buffer.end()}}});
+  return schema->WithMetadata(metadata);
+}
+
+caf::expected<record_type>
+make_layout(const ::arrow::Schema& schema, const std::string& default_name) {
+  auto layout = record_type{};
+  const auto& metadata = schema.metadata();
+  if (auto i = metadata ? metadata->FindKey(layout_metadata_key) : -1;
+      i >= 0) {
+    const auto& bytes = metadata->value(i);
+    caf::binary_deserializer source{nullptr, bytes.data(), bytes.size()};
+    if (auto err = source(layout))
+      return caf::make_error(ec::parse_error,
+                             "failed to deserialize layout from Arrow schema",
+                             render(err));
+    return layout;
+  }
+  // Data from other tools lacks the VAST layout, so we derive it from the
+  // Arrow types.
+  for (const auto& field : schema.fields()) {
+    auto field_type = infer_type(*field->type());
+    if (!field_type)
+      return caf::make_error(ec::type_clash,
+                             fmt::format("unsupported Arrow type {} of field {}",
+                                         field->type()->ToString(),
+                                         field->name()));
+    layout.fields.emplace_back(field->name(), std::move(*field_type));
+  }
+  auto i = metadata ? metadata->FindKey("name") : -1;
+  layout.name(i >= 0 && !metadata->value(i).empty() ? metadata->value(i)
+                                                    : default_name);
+  return layout;
+}
+
+// -- writer -------------------------------------------------------------------
+
 writer::writer() {
   out_ = std::make_shared<::arrow::io::StdoutStream>();
 }
 
-writer::writer(const caf::settings&) {
-  out_ = std::make_shared<::arrow::io::StdoutStream>();
+writer::writer(const caf::settings& options) {
+  auto output = caf::get_or(options, "vast.export.write",
+                            std::string{defaults::export_::write});
+  if (caf::get_or(options, "vast.export.arrow.file", false)) {
+    directory_ = output;
+    return;
+  }
+  if (output == "-") {
+    out_ = std::make_shared<::arrow::io::StdoutStream>();
+    return;
+  }
+  if (auto out = ::arrow::io::FileOutputStream::Open(output); out.ok())
+    out_ = std::move(*out);
+  else
+    VAST_ERROR("{} failed to open {}: {}", name(), output,
+               out.status().ToString());
 }
 
 writer::~writer() {
-  // nop
+  // Closing the writers adds the end-of-stream markers and file footers.
+  if (current_batch_writer_ != nullptr)
+    if (auto status = current_batch_writer_->Close(); !status.ok())
+      VAST_WARN("{} failed to close Arrow stream: {}", name(),
+                status.ToString());
+  for (auto& [layout_name, file] : files_) {
+    auto status = file.writer->Close();
+    if (status.ok())
+      status = file.out->Close();
+    if (!status.ok())
+      VAST_WARN("{} failed to close Arrow file for {}: {}", name(),
+                layout_name, status.ToString());
+  }
 }
 
 caf::error writer::write(const table_slice& slice) {
+  if (directory_)
+    return write_file(slice);
   if (out_ == nullptr)
     return caf::make_error(ec::logic_error, "invalid arrow output stream");
   if (!layout(slice.layout()))
@@ -73,7 +188,7 @@ bool writer::layout(const record_type& layout) {
   if (layout.fields.empty())
     return true;
   current_layout_ = layout;
-  auto schema = make_arrow_schema(layout);
+  auto schema = make_schema(layout);
   current_builder_ = arrow_table_slice_builder::make(layout);
 #  if ARROW_VERSION_MAJOR >= 2
   auto writer_result = ::arrow::ipc::MakeStreamWriter(out_.get(), schema);
@@ -87,6 +202,296 @@ bool writer::layout(const record_type& layout) {
   return false;
 }
 
+caf::error writer::write_file(const table_slice& slice) {
+  if (*directory_ == "-")
+    return caf::make_error(ec::invalid_configuration,
+                           "writing Arrow IPC files requires a target "
+                           "directory");
+  const auto& layout = slice.layout();
+  auto file = files_.find(layout.name());
+  if (file == files_.end()) {
+    auto err = std::error_code{};
+    std::filesystem::create_directories(*directory_, err);
+    if (err)
+      return caf::make_error(ec::filesystem_error,
+                             fmt::format("failed to create directory {}: {}",
+                                         directory_->string(), err.message()));
+    auto path = *directory_ / fmt::format("{}.arrow", layout.name());
+    auto out = ::arrow::io::FileOutputStream::Open(path.string());
+    if (!out.ok())
+      return caf::make_error(ec::filesystem_error,
+                             fmt::format("failed to open {}: {}", path.string(),
+                                         out.status().ToString()));
+    auto schema = make_schema(layout);
+#  if ARROW_VERSION_MAJOR >= 2
+    auto writer_result = ::arrow::ipc::MakeFileWriter(out->get(), schema);
+#  else
+    auto writer_result = ::arrow::ipc::NewFileWriter(out->get(), schema);
+#  endif
+    if (!writer_result.ok())
+      return caf::make_error(ec::unspecified,
+                             "failed to create Arrow file writer",
+                             writer_result.status().ToString());
+    file = files_
+             .emplace(layout.name(),
+                      file_state{std::move(*out), std::move(*writer_result)})
+             .first;
+  }
+  auto batch = as_record_batch(slice);
+  VAST_ASSERT(batch != nullptr);
+  if (auto status = file->second.writer->WriteRecordBatch(*batch);
+      !status.ok())
+    return caf::make_error(ec::unspecified, "failed to write record batch",
+                           status.ToString());
+  return caf::none;
+}
+
+// -- reader -------------------------------------------------------------------
+
+/// Reads from a standard input stream without buffering it. The bytes that
+/// the reader consumed to detect the input format are replayed first.
+class istream_input_stream : public ::arrow::io::InputStream {
+public:
+  istream_input_stream(std::istream& in, std::string prefix)
+    : in_{in}, prefix_{std::move(prefix)} {
+    // nop
+  }
+
+  ::arrow::Status Close() override {
+    closed_ = true;
+    return ::arrow::Status::OK();
+  }
+
+  [[nodiscard]] bool closed() const override {
+    return closed_;
+  }
+
+  [[nodiscard]] ::arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+  ::arrow::Result<int64_t> Read(int64_t nbytes, void* out) override {
+    auto* data = static_cast<char*>(out);
+    auto from_prefix = std::min(prefix_.size(), static_cast<size_t>(nbytes));
+    std::copy_n(prefix_.begin(), from_prefix, data);
+    prefix_.erase(0, from_prefix);
+    auto result = static_cast<int64_t>(from_prefix);
+    if (result < nbytes) {
+      in_.read(data + result, nbytes - result);
+      result += in_.gcount();
+    }
+    position_ += result;
+    return result;
+  }
+
+  ::arrow::Result<std::shared_ptr<::arrow::Buffer>>
+  Read(int64_t nbytes) override {
+    ARROW_ASSIGN_OR_RAISE(auto buffer,
+                          ::arrow::AllocateResizableBuffer(nbytes));
+    ARROW_ASSIGN_OR_RAISE(auto bytes_read,
+                          Read(nbytes, buffer->mutable_data()));
+    ARROW_RETURN_NOT_OK(buffer->Resize(bytes_read, false));
+    return std::shared_ptr<::arrow::Buffer>{std::move(buffer)};
+  }
+
+  /// @returns Whether the stream has no more bytes to read.
+  bool at_end() {
+    return prefix_.empty()
+           && in_.peek() == std::istream::traits_type::eof();
+  }
+
+private:
+  std::istream& in_;
+  std::string prefix_;
+  int64_t position_ = 0;
+  bool closed_ = false;
+};
+
+reader::reader(const caf::settings& options, std::unique_ptr<std::istream> in)
+  : format::reader(options), in_{std::move(in)} {
+  // Regular files are mapped into memory, such that the record batches
+  // reference the file contents directly.
+  input_ = caf::get_or(options, "vast.import.read",
+                       std::string{defaults::import::read});
+  if (caf::get_or(options, "vast.import.uds", false))
+    input_ = "-";
+}
+
+reader::~reader() {
+  // nop
+}
+
+void reader::reset(std::unique_ptr<std::istream> in) {
+  input_ = "-";
+  in_ = std::move(in);
+  file_ = nullptr;
+  in_stream_ = nullptr;
+  file_reader_ = nullptr;
+  next_file_batch_ = 0;
+  stream_reader_ = nullptr;
+  batch_ = nullptr;
+  batch_offset_ = 0;
+}
+
+caf::error reader::schema(vast::schema x) {
+  schema_ = std::move(x);
+  return caf::none;
+}
+
+vast::schema reader::schema() const {
+  return schema_;
+}
+
+const char* reader::name() const {
+  return "arrow-reader";
+}
+
+caf::error
+reader::read_impl(size_t max_events, size_t max_slice_size, consumer& f) {
+  if (file_ == nullptr && in_stream_ == nullptr)
+    if (auto err = open())
+      return err;
+  size_t produced = 0;
+  while (produced < max_events) {
+    if (batch_ == nullptr || batch_offset_ == batch_->num_rows())
+      if (auto err = next_batch())
+        return err;
+    auto num_rows = detail::narrow_cast<size_t>(batch_->num_rows());
+    auto offset = detail::narrow_cast<size_t>(batch_offset_);
+    auto rows
+      = std::min({num_rows - offset, max_slice_size, max_events - produced});
+    // Slicing a record batch shares the underlying buffers.
+    auto batch = rows == num_rows ? batch_ : batch_->Slice(batch_offset_, rows);
+    f(arrow_table_slice_builder::create(batch, layout_));
+    batch_offset_ += detail::narrow_cast<int64_t>(rows);
+    produced += rows;
+  }
+  return caf::none;
+}
+
+caf::error reader::open() {
+  if (input_ != "-") {
+    auto file = ::arrow::io::MemoryMappedFile::Open(input_,
+                                                    ::arrow::io::FileMode::READ);
+    if (!file.ok())
+      return caf::make_error(ec::filesystem_error,
+                             fmt::format("failed to map {} into memory: {}",
+                                         input_, file.status().ToString()));
+    file_ = std::move(*file);
+  } else {
+    if (in_ == nullptr)
+      return caf::make_error(ec::end_of_input, "no input stream");
+    // Arrow IPC files start with magic bytes, whereas streams start with a
+    // schema message.
+    auto prefix = std::string(file_magic.size(), '\0');
+    in_->read(prefix.data(),
+              detail::narrow_cast<std::streamsize>(prefix.size()));
+    prefix.resize(detail::narrow_cast<size_t>(in_->gcount()));
+    if (prefix != file_magic) {
+      in_stream_
+        = std::make_shared<istream_input_stream>(*in_, std::move(prefix));
+      return caf::none;
+    }
+    // Only the file format requires random access, so we buffer the input
+    // stream in that case alone.
+    auto buffer = std::move(prefix);
+    buffer.append(std::istreambuf_iterator<char>{*in_},
+                  std::istreambuf_iterator<char>{});
+    file_ = std::make_shared<::arrow::io::BufferReader>(
+      ::arrow::Buffer::FromString(std::move(buffer)));
+  }
+  auto size = file_->GetSize();
+  if (!size.ok())
+    return caf::make_error(ec::filesystem_error, "failed to determine size",
+                           size.status().ToString());
+  if (*size < static_cast<int64_t>(file_magic.size()))
+    return caf::none;
+  auto magic = file_->ReadAt(0, file_magic.size());
+  if (!magic.ok())
+    return caf::make_error(ec::filesystem_error, "failed to read input",
+                           magic.status().ToString());
+  if ((*magic)->ToString() != file_magic)
+    return caf::none;
+  auto file_reader = ::arrow::ipc::RecordBatchFileReader::Open(file_);
+  if (!file_reader.ok())
+    return caf::make_error(ec::format_error, "failed to open Arrow IPC file",
+                           file_reader.status().ToString());
+  file_reader_ = std::move(*file_reader);
+  VAST_DEBUG("{} reads {} record batches from Arrow IPC file", name(),
+             file_reader_->num_record_batches());
+  return caf::none;
+}
+
+caf::error reader::next_batch() {
+  batch_offset_ = 0;
+  while (true) {
+    batch_ = nullptr;
+    if (file_reader_ != nullptr) {
+      if (next_file_batch_ == file_reader_->num_record_batches())
+        return caf::make_error(ec::end_of_input, "input exhausted");
+      auto batch = file_reader_->ReadRecordBatch(next_file_batch_++);
+      if (!batch.ok())
+        return caf::make_error(ec::format_error, "failed to read record batch",
+                               batch.status().ToString());
+      batch_ = std::move(*batch);
+    } else {
+      // The Arrow writer emits one stream per layout, so we open the next
+      // stream when the current one ends before the input does.
+      if (stream_reader_ == nullptr) {
+        ::arrow::io::InputStream* input = in_stream_.get();
+        if (input != nullptr) {
+          if (in_stream_->at_end())
+            return caf::make_error(ec::end_of_input, "input exhausted");
+        } else {
+          auto position = file_->Tell();
+          auto size = file_->GetSize();
+          if (!position.ok() || !size.ok())
+            return caf::make_error(ec::filesystem_error,
+                                   "failed to determine input position");
+          if (*position >= *size)
+            return caf::make_error(ec::end_of_input, "input exhausted");
+          input = file_.get();
+        }
+        auto stream_reader = ::arrow::ipc::RecordBatchStreamReader::Open(input);
+        if (!stream_reader.ok())
+          return caf::make_error(ec::format_error,
+                                 "failed to open Arrow IPC stream",
+                                 stream_reader.status().ToString());
+        stream_reader_ = std::move(*stream_reader);
+      }
+      if (auto status = stream_reader_->ReadNext(&batch_); !status.ok())
+        return caf::make_error(ec::format_error, "failed to read record batch",
+                               status.ToString());
+      if (batch_ == nullptr) {
+        stream_reader_ = nullptr;
+        continue;
+      }
+    }
+    if (batch_->num_rows() == 0)
+      continue;
+    if (current_schema_ == nullptr
+        || !batch_->schema()->Equals(*current_schema_, true))
+      if (auto err = update_layout(batch_->schema()))
+        return err;
+    return caf::none;
+  }
+}
+
+caf::error
+reader::update_layout(const std::shared_ptr<::arrow::Schema>& schema) {
+  auto layout = make_layout(*schema);
+  if (!layout)
+    return std::move(layout.error());
+  if (!make_arrow_schema(flatten(*layout))->Equals(*schema))
+    return caf::make_error(ec::type_clash,
+                           fmt::format("Arrow schema does not match layout {}",
+                                       layout->name()));
+  VAST_DEBUG("{} reads record batches of layout {}", name(), layout->name());
+  layout_ = std::move(*layout);
+  current_schema_ = schema;
+  return caf::none;
+}
+
 } // namespace vast::format::arrow
 
 #endif // VAST_ENABLE_ARROW
@@ -85,10 +85,11 @@ caf::expected<data> type_biased_convert_impl(JsonType j, const type& t) {
     // No conversion needed: The types are the same.
     return j;
   } else if constexpr (ptraits::can_be_parsed) {
-    // Conversion available: try to parse.
+    // Conversion available: try to parse. The parsers operate on the string
+    // view directly to avoid a temporary copy.
     using value_type = typename ptraits::to_type;
     value_type x;
-    if (auto p = make_parser<value_type>{}; !p(std::string{j}, x))
+    if (auto p = make_parser<value_type>{}; !p(j, x))
       return caf::make_error(ec::parse_error, "unable to parse",
                              caf::detail::pretty_type_name(typeid(value_type)),
                              ":", std::string{j});
@@ -396,25 +397,24 @@ caf::expected<data> convert(const ::simdjson::dom::element& e, const type& t) {
   return caf::make_error(ec::syntax_error, "invalid json type");
 }
 
+/// Looks up a field by its precomputed path. Nested names are resolved in
+/// nested JSON objects first, falling back to flattened names.
 ::simdjson::simdjson_result<::simdjson::dom::element>
-lookup(std::string_view field, const ::simdjson::dom::object& xs) {
-  VAST_ASSERT(!field.empty());
-  const auto i = field.find('.');
-  if (i == std::string_view::npos)
-    return xs.at_key(field);
-  // We have to deal with a nested field name in a potentially nested JSON
-  // object.
-  if (auto at_key_result = xs.at_key(field.substr(0, i));
-      at_key_result.error() != ::simdjson::error_code::SUCCESS) {
-    // Attempt to access JSON field with flattened name.
-    return xs.at_key(field);
-  } else if (auto get_object_result = at_key_result.get_object();
-             get_object_result.error() != ::simdjson::error_code::SUCCESS) {
-    return ::simdjson::error_code::INCORRECT_TYPE;
-  } else {
-    field.remove_prefix(i + 1);
-    return lookup(field, get_object_result.value());
+lookup(const field_path& field, ::simdjson::dom::object xs) {
+  auto key = std::string_view{field.key};
+  size_t offset = 0;
+  for (auto separator : field.separators) {
+    auto at_key_result = xs.at_key(key.substr(offset, separator - offset));
+    if (at_key_result.error() != ::simdjson::error_code::SUCCESS)
+      // Attempt to access JSON field with flattened name.
+      return xs.at_key(key.substr(offset));
+    auto get_object_result = at_key_result.get_object();
+    if (get_object_result.error() != ::simdjson::error_code::SUCCESS)
+      return ::simdjson::error_code::INCORRECT_TYPE;
+    xs = get_object_result.value();
+    offset = separator + 1;
   }
+  return xs.at_key(key.substr(offset));
 }
 
 } // namespace
@@ -443,11 +443,28 @@ const char* writer::name() const {
   return "json-writer";
 }
 
+std::vector<field_path> make_field_paths(const record_type& layout) {
+  std::vector<field_path> result;
+  for (const auto& field : record_type::each(layout)) {
+    auto path = field_path{field.key(), {}, field.type()};
+    for (size_t i = 0; i < path.key.size(); ++i)
+      if (path.key[i] == '.')
+        path.separators.push_back(i);
+    result.push_back(std::move(path));
+  }
+  return result;
+}
+
 caf::error add(table_slice_builder& builder, const ::simdjson::dom::object& xs,
                const record_type& layout) {
+  return add(builder, xs, make_field_paths(layout));
+}
+
+caf::error add(table_slice_builder& builder, const ::simdjson::dom::object& xs,
+               const std::vector<field_path>& fields) {
   caf::error err = caf::none;
-  for (const auto& field : record_type::each(layout)) {
-    auto lookup_result = lookup(field.key(), xs);
+  for (const auto& field : fields) {
+    auto lookup_result = lookup(field, xs);
     // Non-existing fields are treated as empty (unset).
     if (lookup_result.error() != ::simdjson::error_code::SUCCESS) {
       if (!builder.add(make_data_view(caf::none)))
@@ -456,19 +473,33 @@ caf::error add(table_slice_builder& builder, const ::simdjson::dom::object& xs,
                                "slice builder");
       continue;
     }
-    auto x = convert(lookup_result.value(), field.type());
+    const auto& element = lookup_result.value();
+    // Strings make up the bulk of most JSON input. Adding them as views into
+    // the parsed document avoids copying each of them into a temporary data
+    // instance. All other basic types convert to data without allocating.
+    if (element.type() == ::simdjson::dom::element_type::STRING
+        && caf::holds_alternative<string_type>(field.type)) {
+      auto str = std::string_view{element.get_string().value()};
+      if (!builder.add(make_data_view(str)))
+        return caf::make_error(ec::type_clash,
+                               fmt::format("unexpected type for field {} with "
+                                           "type {} for string {}",
+                                           field.key, field.type, str));
+      continue;
+    }
+    auto x = convert(element, field.type);
     if (!x) {
       if (!err)
         err = caf::make_error(ec::convert_error);
       err.context() += x.error().context();
-      err.context() += caf::make_message("could not convert", field.key());
+      err.context() += caf::make_message("could not convert", field.key);
       x = caf::none;
     }
     if (!builder.add(*x))
       return caf::make_error(ec::type_clash,
                              fmt::format("unexpected type for field {} with "
                                          "type {} for data {}",
-                                         field.key(), field.type(), *x));
+                                         field.key, field.type, *x));
   }
   return err;
 }
@@ -0,0 +1,261 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/format/parallel_reader.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/string.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace vast::format {
+
+namespace {
+
+/// Adds the data points of `from` to `into`, summing up the values of
+/// counters that occur in both reports.
+void merge(vast::system::report& into, vast::system::report from) {
+  for (auto& x : from) {
+    auto it = std::find_if(into.begin(), into.end(), [&](const auto& y) {
+      return y.key == x.key;
+    });
+    if (it == into.end()) {
+      into.push_back(std::move(x));
+      continue;
+    }
+    auto accumulate = [&](auto tag) {
+      using value_type = decltype(tag);
+      auto* lhs = caf::get_if<value_type>(&it->value);
+      auto* rhs = caf::get_if<value_type>(&x.value);
+      if (lhs == nullptr || rhs == nullptr)
+        return false;
+      *lhs += *rhs;
+      return true;
+    };
+    if (!accumulate(uint64_t{}) && !accumulate(int64_t{})
+        && !accumulate(double{}) && !accumulate(duration{}))
+      it->value = std::move(x.value);
+  }
+}
+
+} // namespace
+
+parallel_reader::parallel_reader(const caf::settings& options,
+                                 std::unique_ptr<std::istream> in,
+                                 reader_factory factory, header_policy headers,
+                                 size_t num_workers)
+  : reader(options),
+    factory_{std::move(factory)},
+    headers_{headers},
+    num_workers_{num_workers} {
+  VAST_ASSERT(factory_ != nullptr);
+  VAST_ASSERT(num_workers_ > 0);
+  // The prototype never reads any input, but answers all questions regarding
+  // the schema and the name of the underlying format.
+  prototype_ = factory_(nullptr);
+  VAST_ASSERT(prototype_ != nullptr);
+  if (in != nullptr)
+    reset(std::move(in));
+}
+
+parallel_reader::~parallel_reader() {
+  // nop
+}
+
+void parallel_reader::reset(std::unique_ptr<std::istream> in) {
+  VAST_ASSERT(in != nullptr);
+  input_ = std::move(in);
+  lines_ = std::make_unique<detail::line_range>(*input_);
+  header_.clear();
+  in_header_ = false;
+}
+
+caf::error parallel_reader::schema(vast::schema x) {
+  if (auto err = prototype_->schema(x))
+    return err;
+  schema_ = std::move(x);
+  return caf::none;
+}
+
+vast::schema parallel_reader::schema() const {
+  return prototype_->schema();
+}
+
+const char* parallel_reader::name() const {
+  return prototype_->name();
+}
+
+vast::system::report parallel_reader::status() const {
+  return std::exchange(report_, {});
+}
+
+caf::error parallel_reader::read_impl(size_t max_events, size_t max_slice_size,
+                                      consumer& f) {
+  VAST_ASSERT(max_events > 0);
+  VAST_ASSERT(max_slice_size > 0);
+  size_t produced = 0;
+  // Hands parsed slices to the consumer in input order, splitting the last
+  // slice if necessary to stay within the limit of events.
+  auto emit = [&] {
+    while (produced < max_events && !pending_.empty()) {
+      auto slice = std::move(pending_.front());
+      pending_.pop_front();
+      auto remaining = max_events - produced;
+      if (slice.rows() > remaining) {
+        auto [head, tail] = vast::split(std::move(slice), remaining);
+        pending_.push_front(std::move(tail));
+        slice = std::move(head);
+      }
+      produced += slice.rows();
+      f(std::move(slice));
+    }
+  };
+  while (true) {
+    emit();
+    if (produced == max_events)
+      return caf::none;
+    // Errors surface only after all slices parsed before them.
+    if (deferred_error_)
+      return std::exchange(deferred_error_, caf::error{});
+    if (lines_ == nullptr || lines_->done())
+      return caf::make_error(ec::end_of_input, "input exhausted");
+    // Spread the remaining events evenly across the workers, but give each of
+    // them at least a full slice worth of lines so that small limits do not
+    // fragment the output into tiny slices. Events beyond the limit remain in
+    // the pending slices for the next call.
+    auto remaining = max_events - produced;
+    auto max_block_lines
+      = 4 * std::min(max_slice_size, std::numeric_limits<size_t>::max() / 4);
+    auto block_lines = std::clamp((remaining + num_workers_ - 1) / num_workers_,
+                                  max_slice_size, max_block_lines);
+    auto [blocks, timed_out] = split_input(block_lines);
+    std::vector<std::future<block_result>> results;
+    results.reserve(blocks.size());
+    for (auto& block : blocks)
+      results.push_back(std::async(
+        std::launch::async,
+        [this, block = std::move(block), max_slice_size]() mutable {
+          return parse(std::move(block), max_slice_size);
+        }));
+    for (auto& result : results) {
+      auto x = result.get();
+      merge(report_, std::move(x.report));
+      // A sequential reader would not have looked past the first error, so
+      // we discard the slices of all subsequent blocks.
+      if (deferred_error_)
+        continue;
+      for (auto& slice : x.slices)
+        pending_.push_back(std::move(slice));
+      deferred_error_ = std::move(x.error);
+    }
+    if (timed_out) {
+      VAST_DEBUG("{} reached input timeout at line {}",
+                 detail::pretty_type_name(this), lines_->line_number());
+      emit();
+      if (produced == max_events)
+        return caf::none;
+      // Ask the source to forward what we have instead of waiting for more.
+      return produced > 0 ? ec::timeout : ec::stalled;
+    }
+  }
+}
+
+std::pair<std::vector<std::string>, bool>
+parallel_reader::split_input(size_t max_block_lines) {
+  std::vector<std::string> blocks;
+  std::string block;
+  size_t block_lines = 0;
+  auto flush = [&] {
+    if (block_lines == 0)
+      return;
+    blocks.push_back(std::exchange(block, {}));
+    block_lines = 0;
+  };
+  auto timed_out = false;
+  while (blocks.size() < num_workers_) {
+    if (lines_->next_timeout(read_timeout_)) {
+      timed_out = true;
+      break;
+    }
+    if (lines_->done())
+      break;
+    const auto& line = lines_->get();
+    if (line.empty())
+      continue;
+    switch (headers_) {
+      case header_policy::none:
+        break;
+      case header_policy::first_line:
+        if (header_.empty()) {
+          header_ = line;
+          header_ += '\n';
+          continue;
+        }
+        break;
+      case header_policy::zeek:
+        if (detail::starts_with(line, "#separator")) {
+          // A new log starts, which the current block must not include.
+          flush();
+          header_.clear();
+          in_header_ = true;
+        }
+        if (in_header_ && detail::starts_with(line, "#")) {
+          header_ += line;
+          header_ += '\n';
+          continue;
+        }
+        in_header_ = false;
+        break;
+    }
+    if (block_lines == 0)
+      block = header_;
+    block += line;
+    block += '\n';
+    if (++block_lines == max_block_lines)
+      flush();
+  }
+  flush();
+  return {std::move(blocks), timed_out};
+}
+
+parallel_reader::block_result
+parallel_reader::parse(std::string block, size_t max_slice_size) const {
+  block_result result;
+  auto child = factory_(std::make_unique<std::istringstream>(std::move(block)));
+  // Every block is complete, so there is no point in flushing early.
+  child->batch_timeout_ = reader_clock::duration::zero();
+  child->table_slice_type_ = table_slice_type_;
+  if (!schema_.empty())
+    if (auto err = child->schema(schema_)) {
+      result.error = std::move(err);
+      return result;
+    }
+  auto add = [&](table_slice slice) {
+    result.slices.push_back(std::move(slice));
+  };
+  while (true) {
+    auto [err, produced] = child->read(std::numeric_limits<size_t>::max(),
+                                       max_slice_size, add);
+    if (err == ec::end_of_input)
+      break;
+    if (err && err != ec::timeout) {
+      result.error = std::move(err);
+      break;
+    }
+  }
+  result.report = child->status();
+  return result;
+}
+
+} // namespace vast::format
@@ -15,6 +15,7 @@
 #include "vast/format/json/default_selector.hpp"
 #include "vast/format/json/suricata_selector.hpp"
 #include "vast/format/json/zeek_selector.hpp"
+#include "vast/format/parallel_reader.hpp"
 #include "vast/format/reader.hpp"
 #include "vast/format/syslog.hpp"
 #include "vast/format/zeek.hpp"
@@ -25,6 +26,8 @@
 #  include "vast/format/arrow.hpp"
 #endif
 
+#include <caf/settings.hpp>
+
 namespace vast {
 
 template <class Reader>
@@ -41,6 +44,27 @@ make_reader(const caf::settings& options) {
   }
 }
 
+/// Creates a reader for a line-based format that parses its input on
+/// `vast.import.parser-threads` threads.
+template <class Reader, format::parallel_reader::header_policy Headers
+                        = format::parallel_reader::header_policy::none>
+caf::expected<std::unique_ptr<format::reader>>
+make_line_reader(const caf::settings& options) {
+  auto num_threads
+    = caf::get_or(options, "vast.import.parser-threads",
+                  defaults::import::parser_threads);
+  if (num_threads <= 1)
+    return make_reader<Reader>(options);
+  auto in = detail::make_input_stream(options);
+  if (!in)
+    return in.error();
+  auto factory = [options](std::unique_ptr<std::istream> in) {
+    return std::make_unique<Reader>(options, std::move(in));
+  };
+  return std::make_unique<format::parallel_reader>(
+    options, std::move(*in), std::move(factory), Headers, num_threads);
+}
+
 template <class Reader, class ReaderS,
           class Defaults = typename Reader::defaults>
 caf::expected<std::unique_ptr<format::reader>>
@@ -51,15 +75,20 @@ make_json_reader(const caf::settings& options) {
 void factory_traits<format::reader>::initialize() {
   using namespace format;
   using fac = factory<reader>;
-  fac::add("csv", make_reader<csv::reader>);
-  fac::add("json",
-           make_reader<format::json::reader<format::json::default_selector>>);
+  using policy = parallel_reader::header_policy;
+  fac::add("csv", make_line_reader<csv::reader, policy::first_line>);
+  fac::add("json", make_line_reader<
+                     format::json::reader<format::json::default_selector>>);
   fac::add("suricata",
-           make_reader<format::json::reader<format::json::suricata_selector>>);
-  fac::add("syslog", make_reader<syslog::reader>);
-  fac::add("zeek", make_reader<zeek::reader>);
-  fac::add("zeek-json",
-           make_reader<format::json::reader<format::json::zeek_selector>>);
+           make_line_reader<
+             format::json::reader<format::json::suricata_selector>>);
+  fac::add("syslog", make_line_reader<syslog::reader>);
+  fac::add("zeek", make_line_reader<zeek::reader, policy::zeek>);
+  fac::add("zeek-json", make_line_reader<
+                          format::json::reader<format::json::zeek_selector>>);
+#if VAST_ENABLE_ARROW
+  fac::add("arrow", make_reader<arrow::reader>);
+#endif
   for (const auto& plugin : plugins::get()) {
     if (const auto* reader = plugin.as<reader_plugin>()) {
       fac::add(
@@ -8,6 +8,7 @@
 
 #include "vast/index/address_index.hpp"
 
+#include "vast/detail/assert.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/index/container_lookup.hpp"
 #include "vast/type.hpp"
@@ -16,7 +17,9 @@
 #include <caf/serializer.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 
 namespace vast {
 
@@ -49,6 +52,26 @@ bool address_index::append_impl(data_view x, id pos) {
   return true;
 }
 
+bool address_index::append_run_impl(const value_run& xs, id pos) {
+  auto addrs = caf::get_if<span<const address>>(&xs);
+  if (!addrs)
+    return false;
+  auto n = addrs->size();
+  auto bytes = std::vector<uint8_t>(n);
+  for (auto i = 0u; i < 16; ++i) {
+    for (size_t j = 0; j < n; ++j)
+      bytes[j] = (*addrs)[j].data()[i];
+    bytes_[i].skip(pos - bytes_[i].size());
+    bytes_[i].append(span<const uint8_t>{bytes.data(), bytes.size()});
+  }
+  auto v4 = std::make_unique<bool[]>(n);
+  for (size_t j = 0; j < n; ++j)
+    v4[j] = (*addrs)[j].is_v4();
+  v4_.skip(pos - v4_.size());
+  v4_.append(span<const bool>{v4.get(), n});
+  return true;
+}
+
 caf::expected<ids>
 address_index::lookup_impl(relational_operator op, data_view d) const {
   return caf::visit(
@@ -101,11 +124,80 @@ address_index::lookup_impl(relational_operator op, data_view d) const {
           result.flip();
         return result;
       },
-      [&](view<list> xs) { return detail::container_lookup(*this, op, xs); },
+      [&](view<list> xs) -> caf::expected<ids> {
+        VAST_ASSERT(xs);
+        // Large sets of addresses, e.g., IoC lists, benefit from a dedicated
+        // lookup. Everything else goes through the generic path.
+        std::vector<address> addrs;
+        addrs.reserve(xs->size());
+        for (auto x : *xs) {
+          if (auto addr = caf::get_if<view<address>>(&x))
+            addrs.push_back(*addr);
+          else
+            return detail::container_lookup(*this, op, xs);
+        }
+        return lookup_addresses(op, std::move(addrs));
+      },
     },
     d);
 }
 
+caf::expected<ids>
+address_index::lookup_addresses(relational_operator op,
+                                std::vector<address> xs) const {
+  if (!(op == relational_operator::in || op == relational_operator::not_in))
+    return caf::make_error(ec::unsupported_operator, op);
+  auto by_bytes = [](const address& x, const address& y) {
+    return x.data() < y.data();
+  };
+  std::sort(xs.begin(), xs.end(), by_bytes);
+  xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+  // IPv4 addresses share the same 12-byte prefix, so they are adjacent after
+  // sorting. They form a separate trie that starts at the last four bytes and
+  // the v4 bitmap instead of all rows.
+  auto v4_begin = std::find_if(xs.begin(), xs.end(),
+                               [](const address& x) { return x.is_v4(); });
+  auto v4_end = std::find_if(v4_begin, xs.end(),
+                             [](const address& x) { return !x.is_v4(); });
+  // Many addresses share the same byte values at the same positions, so we
+  // look up each of them at most once.
+  std::vector<std::optional<ids>> cache(16 * 256);
+  auto equal = [&](size_t i, uint8_t byte) -> const ids& {
+    auto& result = cache[i * 256 + byte];
+    if (!result)
+      result = ids{bytes_[i].lookup(relational_operator::equal, byte)};
+    return *result;
+  };
+  auto result = ids{offset(), false};
+  auto walk = [&](auto& self, auto first, auto last, size_t i,
+                  const ids& prefix) -> void {
+    if (i == 16) {
+      result |= prefix;
+      return;
+    }
+    while (first != last) {
+      auto byte = first->data()[i];
+      auto next = std::find_if(first, last, [&](const address& x) {
+        return x.data()[i] != byte;
+      });
+      auto matches = prefix;
+      matches &= equal(i, byte);
+      if (!all<0>(matches))
+        self(self, first, next, i + 1, matches);
+      first = next;
+    }
+  };
+  if (v4_begin != v4_end)
+    walk(walk, v4_begin, v4_end, 12, ids{v4_.coder().storage()});
+  if (xs.begin() != v4_begin)
+    walk(walk, xs.begin(), v4_begin, 0, ids{offset(), true});
+  if (v4_end != xs.end())
+    walk(walk, v4_end, xs.end(), 0, ids{offset(), true});
+  if (op == relational_operator::not_in)
+    result.flip();
+  return result;
+}
+
 size_t address_index::memusage_impl() const {
   auto acc = v4_.memusage();
   for (const auto& byte_index : bytes_)
@@ -0,0 +1,205 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/index/address_prefix_index.hpp"
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/iterator.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/index/container_lookup.hpp"
+#include "vast/type.hpp"
+
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+#include <caf/settings.hpp>
+
+#include <algorithm>
+
+namespace vast {
+
+namespace {
+
+/// Iterates over the postings of a range of directory entries.
+class postings_iterator
+  : public detail::iterator_adaptor<
+      postings_iterator, std::vector<size_t>::const_iterator, ewah_bitmap,
+      std::forward_iterator_tag, const ewah_bitmap&> {
+  using super = detail::iterator_adaptor<
+    postings_iterator, std::vector<size_t>::const_iterator, ewah_bitmap,
+    std::forward_iterator_tag, const ewah_bitmap&>;
+
+public:
+  postings_iterator(std::vector<size_t>::const_iterator it,
+                    const std::vector<ewah_bitmap>& postings)
+    : super{it}, postings_{&postings} {
+    // nop
+  }
+
+private:
+  friend detail::iterator_access;
+
+  [[nodiscard]] const ewah_bitmap& dereference() const {
+    return (*postings_)[*this->base()];
+  }
+
+  const std::vector<ewah_bitmap>* postings_;
+};
+
+} // namespace
+
+address_prefix_index::address_prefix_index(vast::type t, caf::settings opts)
+  : value_index{std::move(t), std::move(opts)} {
+  // nop
+}
+
+caf::error address_prefix_index::serialize(caf::serializer& sink) const {
+  return caf::error::eval([&] { return value_index::serialize(sink); },
+                          [&] { return sink(addresses_, postings_); });
+}
+
+caf::error address_prefix_index::deserialize(caf::deserializer& source) {
+  auto err
+    = caf::error::eval([&] { return value_index::deserialize(source); },
+                       [&] { return source(addresses_, postings_); });
+  if (err)
+    return err;
+  if (addresses_.size() != postings_.size())
+    return caf::make_error(ec::parse_error, "address prefix index has",
+                           addresses_.size(), "addresses but",
+                           postings_.size(), "postings");
+  // Restoring the positions allows for appending after deserialization.
+  positions_.clear();
+  positions_.reserve(addresses_.size());
+  for (size_t i = 0; i < addresses_.size(); ++i)
+    positions_.emplace(addresses_[i], i);
+  directory_.clear();
+  return caf::none;
+}
+
+std::vector<std::pair<subnet, uint64_t>>
+address_prefix_index::top_prefixes(uint8_t length, size_t k) const {
+  update_directory();
+  // Addresses with the same prefix are adjacent in the directory, so a single
+  // pass suffices to count the rows per prefix.
+  std::vector<std::pair<subnet, uint64_t>> result;
+  for (auto pos : directory_) {
+    const auto& addr = addresses_[pos];
+    auto prefix = subnet{
+      addr, addr.is_v4() ? std::min(length, uint8_t{32}) : length};
+    auto n = rank(postings_[pos]);
+    if (!result.empty() && result.back().first == prefix)
+      result.back().second += n;
+    else
+      result.emplace_back(prefix, n);
+  }
+  auto by_rows = [](const auto& x, const auto& y) {
+    return x.second != y.second ? x.second > y.second : x.first < y.first;
+  };
+  auto mid = result.begin() + std::min(k, result.size());
+  std::partial_sort(result.begin(), mid, result.end(), by_rows);
+  result.erase(mid, result.end());
+  return result;
+}
+
+bool address_prefix_index::append_impl(data_view x, id pos) {
+  auto addr = caf::get_if<view<address>>(&x);
+  if (!addr)
+    return false;
+  auto [it, inserted] = positions_.try_emplace(*addr, addresses_.size());
+  if (inserted) {
+    addresses_.push_back(*addr);
+    postings_.emplace_back();
+  }
+  auto& postings = postings_[it->second];
+  postings.append_bits(false, pos - postings.size());
+  postings.append_bit(true);
+  return true;
+}
+
+caf::expected<ids>
+address_prefix_index::lookup_impl(relational_operator op,
+                                  data_view d) const {
+  auto finish = [&](ids result, bool negate) -> ids {
+    if (result.size() < offset())
+      result.append_bits(false, offset() - result.size());
+    if (negate)
+      result.flip();
+    return result;
+  };
+  return caf::visit(
+    detail::overload{
+      [&](auto x) -> caf::expected<ids> {
+        return caf::make_error(ec::type_clash, materialize(x));
+      },
+      [&](view<address> x) -> caf::expected<ids> {
+        if (!(op == relational_operator::equal
+              || op == relational_operator::not_equal))
+          return caf::make_error(ec::unsupported_operator, op);
+        return finish(lookup_address(x),
+                      op == relational_operator::not_equal);
+      },
+      [&](view<subnet> x) -> caf::expected<ids> {
+        if (!(op == relational_operator::in
+              || op == relational_operator::not_in))
+          return caf::make_error(ec::unsupported_operator, op);
+        return finish(lookup_subnet(x), op == relational_operator::not_in);
+      },
+      [&](view<list> xs) { return detail::container_lookup(*this, op, xs); },
+    },
+    d);
+}
+
+size_t address_prefix_index::memusage_impl() const {
+  auto acc = addresses_.capacity() * sizeof(address)
+             + directory_.capacity() * sizeof(size_t)
+             + positions_.size() * sizeof(std::pair<address, size_t>);
+  for (const auto& postings : postings_)
+    acc += postings.memusage();
+  return acc;
+}
+
+void address_prefix_index::update_directory() const {
+  auto first = directory_.size();
+  if (first == addresses_.size())
+    return;
+  directory_.reserve(addresses_.size());
+  for (auto i = first; i < addresses_.size(); ++i)
+    directory_.push_back(i);
+  auto by_address
+    = [&](size_t x, size_t y) { return addresses_[x] < addresses_[y]; };
+  auto mid = directory_.begin() + first;
+  std::sort(mid, directory_.end(), by_address);
+  std::inplace_merge(directory_.begin(), mid, directory_.end(), by_address);
+}
+
+ids address_prefix_index::lookup_subnet(const subnet& x) const {
+  update_directory();
+  // The network address is the smallest address in the subnet, and all
+  // other addresses of the subnet follow it immediately.
+  auto first = std::lower_bound(
+    directory_.cbegin(), directory_.cend(), x.network(),
+    [&](size_t pos, const address& addr) { return addresses_[pos] < addr; });
+  auto last = std::find_if_not(first, directory_.cend(), [&](size_t pos) {
+    return x.contains(addresses_[pos]);
+  });
+  if (first == last)
+    return ids{};
+  // Combining all postings at once avoids re-encoding the growing result
+  // for every address in the subnet.
+  return nary_or(postings_iterator{first, postings_},
+                 postings_iterator{last, postings_});
+}
+
+ids address_prefix_index::lookup_address(const address& x) const {
+  if (auto it = positions_.find(x); it != positions_.end())
+    return postings_[it->second];
+  return ids{};
+}
+
+} // namespace vast
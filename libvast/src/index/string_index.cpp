@@ -10,7 +10,10 @@
 
 #include "vast/bitmap_algorithms.hpp"
 #include "vast/defaults.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/detail/regex.hpp"
 #include "vast/index/container_lookup.hpp"
 #include "vast/type.hpp"
 
@@ -18,24 +21,53 @@
 #include <caf/serializer.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
+#include <optional>
+#include <vector>
+
 namespace vast {
 
+namespace {
+
+/// Packs the n-gram that starts at *xs* into an integer.
+uint32_t make_ngram(const char* xs) {
+  static_assert(string_index::ngram_size == 3);
+  return static_cast<uint32_t>(static_cast<uint8_t>(xs[0])) << 16
+         | static_cast<uint32_t>(static_cast<uint8_t>(xs[1])) << 8
+         | static_cast<uint32_t>(static_cast<uint8_t>(xs[2]));
+}
+
+} // namespace
+
 string_index::string_index(vast::type t, caf::settings opts)
   : value_index{std::move(t), std::move(opts)} {
   max_length_
     = caf::get_or(options(), "max-size", defaults::index::max_string_size);
   auto b = base::uniform(10, std::log10(max_length_) + !!(max_length_ % 10));
   length_ = length_bitmap_index{std::move(b)};
+  ngrams_enabled_ = has_attribute(type(), "ngrams");
 }
 
 caf::error string_index::serialize(caf::serializer& sink) const {
+  // The n-gram index exists only for types with the `#ngrams` attribute, so
+  // indexes of all other types keep their previous format.
   return caf::error::eval([&] { return value_index::serialize(sink); },
-                          [&] { return sink(max_length_, length_, chars_); });
+                          [&] { return sink(max_length_, length_, chars_); },
+                          [&]() -> caf::error {
+                            if (!ngrams_enabled_)
+                              return caf::none;
+                            return sink(ngrams_);
+                          });
 }
 
 caf::error string_index::deserialize(caf::deserializer& source) {
   return caf::error::eval([&] { return value_index::deserialize(source); },
-                          [&] { return source(max_length_, length_, chars_); });
+                          [&] { return source(max_length_, length_, chars_); },
+                          [&]() -> caf::error {
+                            if (!ngrams_enabled_)
+                              return caf::none;
+                            return source(ngrams_);
+                          });
 }
 
 bool string_index::append_impl(data_view x, id pos) {
@@ -53,9 +85,82 @@ bool string_index::append_impl(data_view x, id pos) {
   }
   length_.skip(pos - length_.size());
   length_.append(length);
+  if (ngrams_enabled_)
+    append_ngrams(*str, pos);
+  return true;
+}
+
+bool string_index::append_run_impl(const value_run& xs, id pos) {
+  auto strs = caf::get_if<span<const std::string_view>>(&xs);
+  if (!strs)
+    return false;
+  auto n = strs->size();
+  auto lengths = std::vector<uint32_t>(n);
+  auto longest = size_t{0};
+  for (size_t j = 0; j < n; ++j) {
+    auto length = std::min((*strs)[j].size(), max_length_);
+    lengths[j] = detail::narrow_cast<uint32_t>(length);
+    longest = std::max(longest, length);
+  }
+  if (longest > chars_.size())
+    chars_.resize(longest, char_bitmap_index{8});
+  // The character index at position i only holds the strings that are longer
+  // than i, so we append the maximal sub-runs of such strings in bulk.
+  auto bytes = std::vector<uint8_t>{};
+  bytes.reserve(n);
+  for (size_t i = 0; i < longest; ++i) {
+    size_t j = 0;
+    while (j < n) {
+      if (lengths[j] <= i) {
+        ++j;
+        continue;
+      }
+      auto first = j;
+      bytes.clear();
+      for (; j < n && lengths[j] > i; ++j)
+        bytes.push_back(static_cast<uint8_t>((*strs)[j][i]));
+      chars_[i].skip(pos + first - chars_[i].size());
+      chars_[i].append(span<const uint8_t>{bytes.data(), bytes.size()});
+    }
+  }
+  length_.skip(pos - length_.size());
+  length_.append(span<const uint32_t>{lengths.data(), lengths.size()});
+  if (ngrams_enabled_)
+    for (size_t j = 0; j < n; ++j)
+      append_ngrams((*strs)[j], pos + j);
   return true;
 }
 
+void string_index::append_ngrams(std::string_view str, id pos) {
+  VAST_ASSERT(ngrams_enabled_);
+  // Unlike the character index, the n-gram index covers the entire string.
+  for (size_t i = 0; i + ngram_size <= str.size(); ++i) {
+    auto& postings = ngrams_[make_ngram(str.data() + i)];
+    // Skip n-grams that occur repeatedly in the same string.
+    if (postings.size() > pos)
+      continue;
+    postings.append_bits(false, pos - postings.size());
+    postings.append_bit(true);
+  }
+}
+
+ids string_index::ngram_candidates(std::string_view str) const {
+  VAST_ASSERT(ngrams_enabled_);
+  VAST_ASSERT(str.size() >= ngram_size);
+  auto result = ids{offset(), true};
+  for (size_t i = 0; i + ngram_size <= str.size(); ++i) {
+    auto postings = ngrams_.find(make_ngram(str.data() + i));
+    if (postings == ngrams_.end())
+      return ids{offset(), false};
+    auto bm = ids{postings->second};
+    bm.append_bits(false, offset() - bm.size());
+    result &= bm;
+    if (all<0>(result))
+      break;
+  }
+  return result;
+}
+
 caf::expected<ids>
 string_index::lookup_impl(relational_operator op, data_view x) const {
   auto f = detail::overload{
@@ -98,27 +203,83 @@ string_index::lookup_impl(relational_operator op, data_view x) const {
         case relational_operator::not_ni: {
           if (str_size == 0)
             return ids{offset(), op == relational_operator::ni};
-          if (str_size > chars_.size())
-            return ids{offset(), op == relational_operator::not_ni};
-          // TODO: Be more clever than iterating over all k-grams (#45).
+          // The strings that contain all n-grams of the query are a superset
+          // of the result. We verify them with the character index, so that
+          // the result is exact and can serve as a count estimate. Only
+          // strings that exceed the character index remain unverified.
+          auto candidates = ids{offset(), true};
+          auto unverified = ids{offset(), false};
+          if (ngrams_enabled_ && str.size() >= ngram_size) {
+            candidates = ngram_candidates(str);
+            if (all<0>(candidates))
+              return ids{offset(), op == relational_operator::not_ni};
+            unverified
+              = length_.lookup(relational_operator::greater_equal,
+                               detail::narrow_cast<uint32_t>(max_length_));
+            unverified.append_bits(false, offset() - unverified.size());
+            unverified &= candidates;
+          }
           ids result{offset(), false};
-          for (auto i = 0u; i < chars_.size() - str_size + 1; ++i) {
-            ids substr{offset(), true};
-            auto skip = false;
-            for (auto j = 0u; j < str_size; ++j) {
-              auto bm
-                = chars_[i + j].lookup(relational_operator::equal, str[j]);
-              if (all<0>(bm)) {
-                skip = true;
-                break;
+          if (str_size <= chars_.size()) {
+            for (auto i = 0u; i < chars_.size() - str_size + 1; ++i) {
+              ids substr = candidates;
+              auto skip = false;
+              for (auto j = 0u; j < str_size; ++j) {
+                auto bm
+                  = chars_[i + j].lookup(relational_operator::equal, str[j]);
+                if (all<0>(bm)) {
+                  skip = true;
+                  break;
+                }
+                substr &= bm;
               }
-              substr &= bm;
+              if (!skip)
+                result |= substr;
             }
-            if (!skip)
-              result |= substr;
           }
+          // The unverified strings may or may not match, so they belong to
+          // the candidates of both operators.
           if (op == relational_operator::not_ni)
             result.flip();
+          result |= unverified;
+          return result;
+        }
+      }
+    },
+    [&](view<pattern> pat) -> caf::expected<ids> {
+      switch (op) {
+        default:
+          return caf::make_error(ec::unsupported_operator, op);
+        case relational_operator::not_match:
+          return ids{offset(), true};
+        case relational_operator::match: {
+          // The index cannot evaluate regular expressions, but every match
+          // contains the literals that the pattern requires. The strings that
+          // contain all of them are a superset of the result, and the
+          // candidate check removes false positives.
+          auto rx = pat.compiled();
+          if (!rx)
+            return std::move(rx.error());
+          // Without n-grams, the substring lookup only sees the first
+          // `max_length_` characters, so truncated strings remain candidates.
+          auto truncated = std::optional<ids>{};
+          auto result = ids{offset(), true};
+          for (const auto& literal : (*rx)->required_literals()) {
+            auto candidates = lookup_impl(relational_operator::ni,
+                                          std::string_view{literal});
+            if (!candidates)
+              return candidates;
+            if (!ngrams_enabled_ || literal.size() < ngram_size) {
+              if (!truncated)
+                truncated
+                  = length_.lookup(relational_operator::greater_equal,
+                                   detail::narrow_cast<uint32_t>(max_length_));
+              *candidates |= *truncated;
+            }
+            result &= *candidates;
+            if (all<0>(result))
+              break;
+          }
           return result;
         }
       }
@@ -132,6 +293,8 @@ size_t string_index::memusage_impl() const {
   size_t acc = length_.memusage();
   for (const auto& char_index : chars_)
     acc += char_index.memusage();
+  for (const auto& [ngram, postings] : ngrams_)
+    acc += sizeof(ngram) + postings.memusage();
   return acc;
 }
 
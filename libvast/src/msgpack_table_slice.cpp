@@ -14,6 +14,7 @@
 #include "vast/die.hpp"
 #include "vast/fbs/table_slice.hpp"
 #include "vast/fbs/utils.hpp"
+#include "vast/ids.hpp"
 #include "vast/logger.hpp"
 #include "vast/msgpack.hpp"
 #include "vast/value_index.hpp"
@@ -301,6 +302,23 @@ void msgpack_table_slice<FlatBuffer>::append_column_to_index(
   }
 }
 
+template <class FlatBuffer>
+ids msgpack_table_slice<FlatBuffer>::evaluate_column(
+  table_slice::size_type column, const type& t, relational_operator op,
+  const data& rhs) const {
+  const auto& offset_table = *slice_.offset_table();
+  auto view = as_bytes(*slice_.data());
+  auto rhs_view = make_view(rhs);
+  auto result = ids{};
+  for (size_t row = 0; row < rows(); ++row) {
+    auto xs = msgpack::overlay{view.subspan(offset_table[row])};
+    xs.next(column);
+    auto x = to_canonical(t, decode(xs, t));
+    result.append_bit(evaluate_view(x, op, rhs_view));
+  }
+  return result;
+}
+
 template <class FlatBuffer>
 data_view
 msgpack_table_slice<FlatBuffer>::at(table_slice::size_type row,
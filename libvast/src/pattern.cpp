@@ -10,8 +10,10 @@
 
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/data.hpp"
+#include "vast/detail/regex.hpp"
 #include "vast/pattern.hpp"
 
+#include <atomic>
 #include <regex>
 
 namespace vast {
@@ -27,24 +29,50 @@ pattern pattern::glob(std::string_view str) {
 pattern::pattern(std::string str) : str_(std::move(str)) {
 }
 
+pattern::pattern(const pattern& other)
+  : str_{other.str_}, regex_{std::atomic_load(&other.regex_)} {
+}
+
+pattern& pattern::operator=(const pattern& other) {
+  str_ = other.str_;
+  regex_ = std::atomic_load(&other.regex_);
+  return *this;
+}
+
 bool pattern::match(std::string_view str) const {
-  return std::regex_match(str.begin(), str.end(), std::regex{str_});
+  auto rx = compiled();
+  return rx && (*rx)->match(str);
 }
 
 bool pattern::search(std::string_view str) const {
-  return std::regex_search(str.begin(), str.end(), std::regex{str_});
+  auto rx = compiled();
+  return rx && (*rx)->search(str);
 }
 
 const std::string& pattern::string() const {
   return str_;
 }
 
+caf::expected<std::shared_ptr<const detail::regex>> pattern::compiled() const {
+  if (auto result = std::atomic_load(&regex_))
+    return result;
+  auto rx = detail::regex::make(str_);
+  if (!rx)
+    return std::move(rx.error());
+  // Concurrent callers may compile the pattern more than once, but they
+  // all publish equivalent results.
+  auto result = std::make_shared<const detail::regex>(std::move(*rx));
+  std::atomic_store(&regex_, result);
+  return result;
+}
+
 pattern& pattern::operator+=(const pattern& other) {
   return *this += std::string_view{other.str_};
 }
 
 pattern& pattern::operator+=(std::string_view other) {
   str_ += other;
+  regex_ = nullptr;
   return *this;
 }
 
@@ -57,6 +85,7 @@ pattern& pattern::operator|=(std::string_view other) {
   str_ += ")|(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  regex_ = nullptr;
   return *this;
 }
 
@@ -69,6 +98,7 @@ pattern& pattern::operator&=(std::string_view other) {
   str_ += ")(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  regex_ = nullptr;
   return *this;
 }
 
@@ -10,6 +10,7 @@
 
 #include "vast/bitmap.hpp"
 #include "vast/bitmap_algorithms.hpp"
+#include "vast/compression.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/table_slice.hpp"
 #include "vast/detail/assert.hpp"
@@ -46,13 +47,33 @@ caf::expected<segment> segment::make(chunk_ptr chunk) {
                            FLATBUFFERS_MAX_BUFFER_SIZE);
   auto s = fbs::GetSegment(chunk->data());
   VAST_ASSERT(s); // `GetSegment` is just a cast, so this cant become null.
-  if (s->segment_type() != fbs::segment::Segment::v0)
-    return caf::make_error(ec::format_error, "unsupported segment version");
-  return segment{std::move(chunk)};
+  switch (s->segment_type()) {
+    case fbs::segment::Segment::v0: {
+      auto data = chunk;
+      return segment{std::move(chunk), std::move(data)};
+    }
+    case fbs::segment::Segment::v1: {
+      auto segment_v1 = s->segment_as_v1();
+      auto method = static_cast<compression>(segment_v1->compression());
+      if (method == compression::none || !segment_v1->data())
+        return caf::make_error(ec::format_error, "invalid compressed segment");
+      auto data = decompress(method, as_bytes(*segment_v1->data()),
+                             segment_v1->decompressed_size());
+      if (!data)
+        return std::move(data.error());
+      if (fbs::GetSegment((*data)->data())->segment_type()
+          != fbs::segment::Segment::v0)
+        return caf::make_error(ec::format_error, "unsupported segment version "
+                                                 "in compressed segment");
+      return segment{std::move(chunk), std::move(*data)};
+    }
+    default:
+      return caf::make_error(ec::format_error, "unsupported segment version");
+  }
 }
 
 uuid segment::id() const {
-  auto segment = fbs::GetSegment(chunk_->data());
+  auto segment = fbs::GetSegment(data_->data());
   auto segment_v0 = segment->segment_as_v0();
   uuid result;
   if (auto error = unpack(*segment_v0->uuid(), result))
@@ -62,7 +83,7 @@ uuid segment::id() const {
 
 vast::ids segment::ids() const {
   vast::ids result;
-  auto segment = fbs::GetSegment(chunk_->data());
+  auto segment = fbs::GetSegment(data_->data());
   auto segment_v0 = segment->segment_as_v0();
   for (auto interval : *segment_v0->ids()) {
     result.append_bits(false, interval->begin() - result.size());
@@ -72,7 +93,7 @@ vast::ids segment::ids() const {
 }
 
 size_t segment::num_slices() const {
-  auto segment = fbs::GetSegment(chunk_->data());
+  auto segment = fbs::GetSegment(data_->data());
   auto segment_v0 = segment->segment_as_v0();
   return segment_v0->slices()->size();
 }
@@ -81,10 +102,14 @@ chunk_ptr segment::chunk() const {
   return chunk_;
 }
 
+size_t segment::memory_usage() const {
+  return data_ == chunk_ ? chunk_->size() : chunk_->size() + data_->size();
+}
+
 caf::expected<std::vector<table_slice>>
 segment::lookup(const vast::ids& xs) const {
   std::vector<table_slice> result;
-  auto segment = fbs::GetSegment(chunk_->data())->segment_as_v0();
+  auto segment = fbs::GetSegment(data_->data())->segment_as_v0();
   if (!segment)
     return caf::make_error(ec::format_error, "invalid segment version");
   VAST_ASSERT(segment->ids()->size() == segment->slices()->size());
@@ -94,7 +119,7 @@ segment::lookup(const vast::ids& xs) const {
   };
   auto g = [&](const auto& zip) {
     auto&& [interval, flat_slice] = zip;
-    auto slice = table_slice{*flat_slice, chunk_, table_slice::verify::yes};
+    auto slice = table_slice{*flat_slice, data_, table_slice::verify::yes};
     slice.offset(interval->begin());
     VAST_ASSERT(slice.offset() == interval->begin());
     VAST_ASSERT(slice.offset() + slice.rows() == interval->end());
@@ -118,7 +143,8 @@ segment::lookup(const vast::ids& xs) const {
   return result;
 }
 
-segment::segment(chunk_ptr chk) : chunk_{std::move(chk)} {
+segment::segment(chunk_ptr chk, chunk_ptr data)
+  : chunk_{std::move(chk)}, data_{std::move(data)} {
   // nop
 }
 
@@ -24,8 +24,11 @@
 
 namespace vast {
 
-segment_builder::segment_builder(size_t initial_buffer_size)
-  : builder_{initial_buffer_size} {
+segment_builder::segment_builder(size_t initial_buffer_size,
+                                 compression method, int level)
+  : compression_{method},
+    compression_level_{level},
+    builder_{initial_buffer_size} {
   reset();
 }
 
@@ -58,7 +61,55 @@ segment segment_builder::finish() {
   fbs::FinishSegmentBuffer(builder_, segment_offset);
   auto chk = fbs::release(builder_);
   reset();
-  return segment{std::move(chk)};
+  if (compression_ != compression::none) {
+    if (auto compressed = compress(chk))
+      return segment{std::move(*compressed), std::move(chk)};
+    else
+      VAST_WARN("{} failed to compress segment: {}",
+                detail::pretty_type_name(this), render(compressed.error()));
+  }
+  auto data = chk;
+  return segment{std::move(chk), std::move(data)};
+}
+
+caf::expected<chunk_ptr>
+segment_builder::compress(const chunk_ptr& chunk) const {
+  auto bytes
+    = vast::compress(compression_, compression_level_, as_bytes(chunk));
+  if (!bytes)
+    return bytes.error();
+  // We copy the metadata of the uncompressed segment so that the archive can
+  // register the compressed segment without decompressing it.
+  auto segment_v0 = fbs::GetSegment(chunk->data())->segment_as_v0();
+  uuid id;
+  if (auto err = unpack(*segment_v0->uuid(), id))
+    return err;
+  auto intervals = std::vector<fbs::interval::v0>{};
+  intervals.reserve(segment_v0->ids()->size());
+  for (auto interval : *segment_v0->ids())
+    intervals.push_back(*interval);
+  flatbuffers::FlatBufferBuilder builder{bytes->size() + 1024};
+  auto uuid_offset = pack(builder, id);
+  if (!uuid_offset)
+    return uuid_offset.error();
+  auto ids_offset = builder.CreateVectorOfStructs(intervals);
+  auto data_offset = builder.CreateVector(
+    reinterpret_cast<const uint8_t*>(bytes->data()), bytes->size());
+  fbs::segment::v1Builder segment_v1_builder{builder};
+  segment_v1_builder.add_uuid(*uuid_offset);
+  segment_v1_builder.add_ids(ids_offset);
+  segment_v1_builder.add_events(segment_v0->events());
+  segment_v1_builder.add_compression(
+    static_cast<fbs::segment::Compression>(compression_));
+  segment_v1_builder.add_decompressed_size(chunk->size());
+  segment_v1_builder.add_data(data_offset);
+  auto segment_v1_offset = segment_v1_builder.Finish();
+  fbs::SegmentBuilder segment_builder{builder};
+  segment_builder.add_segment_type(vast::fbs::segment::Segment::v1);
+  segment_builder.add_segment(segment_v1_offset.Union());
+  auto segment_offset = segment_builder.Finish();
+  fbs::FinishSegmentBuffer(builder, segment_offset);
+  return fbs::release(builder);
 }
 
 caf::expected<std::vector<table_slice>>
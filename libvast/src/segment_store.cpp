@@ -49,6 +49,29 @@ caf::expected<table_slice> segment_store::lookup::next() {
   return *it_++;
 }
 
+caf::expected<segment_store::lookup::segment_slices>
+segment_store::lookup::next_segment() {
+  if (buffer_ && it_ != buffer_->end()) {
+    auto result = std::vector<table_slice>(it_, buffer_->end());
+    it_ = buffer_->end();
+    return segment_slices{std::move(result)};
+  }
+  if (first_ == candidates_.end())
+    return caf::no_error;
+  auto& cand = *first_;
+  if (cand != store_.builder_.id() && !store_.cached(cand)) {
+    ++first_;
+    auto chunk = store_.map_segment(cand);
+    if (!chunk)
+      return std::move(chunk.error());
+    return segment_slices{std::move(*chunk)};
+  }
+  auto slices = handle_segment();
+  if (!slices)
+    return std::move(slices.error());
+  return segment_slices{std::move(*slices)};
+}
+
 caf::expected<std::vector<table_slice>>
 segment_store::lookup::handle_segment() {
   if (first_ == candidates_.end())
@@ -77,12 +100,12 @@ segment_store::lookup::handle_segment() {
 // TODO: return expected<segment_store_ptr> for better error propagation.
 segment_store_ptr
 segment_store::make(std::filesystem::path dir, size_t max_segment_size,
-                    size_t in_memory_segments) {
+                    size_t in_memory_segments, compression method, int level) {
   VAST_TRACE_SCOPE("{} {} {}", VAST_ARG(dir), VAST_ARG(max_segment_size),
                    VAST_ARG(in_memory_segments));
   VAST_ASSERT(max_segment_size > 0);
-  auto result = segment_store_ptr{
-    new segment_store{std::move(dir), max_segment_size, in_memory_segments}};
+  auto result = segment_store_ptr{new segment_store{
+    std::move(dir), max_segment_size, in_memory_segments, method, level}};
   if (auto err = result->register_segments())
     return nullptr;
   return result;
@@ -90,13 +113,17 @@ segment_store::make(std::filesystem::path dir, size_t max_segment_size,
 
 segment_store::segment_store(std::filesystem::path dir,
                              uint64_t max_segment_size,
-                             size_t in_memory_segments)
+                             size_t in_memory_segments, compression method,
+                             int level)
   : dir_{std::move(dir)},
     max_segment_size_{max_segment_size},
+    compression_{method},
+    compression_level_{level},
     cache_{in_memory_segments},
     // TODO: Make vast.max-segment-size a hard instead of a soft limit, such
     // that we do not need to multiplay with an arbitrary value above 1 here.
-    builder_{detail::narrow_cast<size_t>(max_segment_size * 1.1)} {
+    builder_{detail::narrow_cast<size_t>(max_segment_size * 1.1), method,
+             level} {
   // nop
 }
 
@@ -214,7 +241,8 @@ caf::error segment_store::erase(const ids& xs) {
       size_estimate += as_bytes(slice).size();
     size_estimate *= 1.1;
     // Create a new segment from the remaining slices.
-    segment_builder tmp_builder{size_estimate};
+    segment_builder tmp_builder{size_estimate, compression_,
+                                compression_level_};
     segment_builder* builder = &tmp_builder;
     if constexpr (std::is_same_v<decltype(seg), segment_builder&>) {
       // If `update` got called with a builder then we simply use that by
@@ -345,7 +373,7 @@ void segment_store::inspect_status(caf::settings& xs,
     put(xs, "events", num_events_);
     auto mem = builder_.table_slice_bytes();
     for (auto& segment : cache_)
-      mem += segment.second.chunk()->size();
+      mem += segment.second.memory_usage();
     put(xs, "memory-usage", mem);
   }
   if (v >= system::status_verbosity::detailed) {
@@ -390,34 +418,43 @@ segment_store::register_segment(const std::filesystem::path& filename) {
   auto s = fbs::GetSegment(chk->get()->data());
   if (s == nullptr)
     return caf::make_error(ec::format_error, "segment integrity check failed");
-  auto s0 = s->segment_as_v0();
-  if (!s0)
-    return caf::make_error(ec::format_error, "unknown segment version");
-  num_events_ += s0->events();
-  uuid segment_uuid;
-  if (auto error = unpack(*s0->uuid(), segment_uuid))
-    return error;
-  VAST_DEBUG("{} found segment {}", detail::pretty_type_name(this),
-             segment_uuid);
-  for (auto interval : *s0->ids())
-    if (!segments_.inject(interval->begin(), interval->end(), segment_uuid))
-      return caf::make_error(ec::unspecified, "failed to update range_map");
-  return caf::none;
+  // Compressed segments carry the same uncompressed metadata as regular
+  // segments, so we can register both without touching the table slices.
+  auto register_metadata = [&](const auto* segment) -> caf::error {
+    num_events_ += segment->events();
+    uuid segment_uuid;
+    if (auto error = unpack(*segment->uuid(), segment_uuid))
+      return error;
+    VAST_DEBUG("{} found segment {}", detail::pretty_type_name(this),
+               segment_uuid);
+    for (auto interval : *segment->ids())
+      if (!segments_.inject(interval->begin(), interval->end(), segment_uuid))
+        return caf::make_error(ec::unspecified, "failed to update range_map");
+    return caf::none;
+  };
+  if (auto s0 = s->segment_as_v0())
+    return register_metadata(s0);
+  if (auto s1 = s->segment_as_v1())
+    return register_metadata(s1);
+  return caf::make_error(ec::format_error, "unknown segment version");
 }
 
-caf::expected<segment> segment_store::load_segment(uuid id) const {
+caf::expected<chunk_ptr> segment_store::map_segment(uuid id) const {
   auto filename = segment_path() / to_string(id);
   VAST_DEBUG("{} mmaps segment from {}", detail::pretty_type_name(this),
              filename);
-  auto chk = chunk::mmap(filename);
+  return chunk::mmap(filename);
+}
+
+caf::expected<segment> segment_store::load_segment(uuid id) const {
+  auto chk = map_segment(id);
   if (!chk)
     return std::move(chk.error());
   if (auto segment = segment::make(std::move(*chk))) {
     return segment;
   } else {
-    VAST_ERROR("{} failed to load segment at {} with error: {}",
-               detail::pretty_type_name(this), filename,
-               render(segment.error()));
+    VAST_ERROR("{} failed to load segment {} with error: {}",
+               detail::pretty_type_name(this), id, render(segment.error()));
     return std::move(segment.error());
   }
 }
@@ -441,15 +478,15 @@ caf::error segment_store::select_segments(const ids& selection,
 uint64_t segment_store::drop(segment& x) {
   uint64_t erased_events = 0;
   auto segment_id = x.id();
-  // TODO: discuss whether we want to allow accessing a segment through the
-  // flatbuffers API. The (heavy-weight) altnerative here would be to create a
-  // custom iterator so that a segment can be iterated as a list of table_slice
-  // instances.
-  auto s = fbs::GetSegment(x.chunk()->data());
-  auto s0 = s->segment_as_v0();
-  for (auto flat_slice : *s0->slices()) {
-    auto slice = table_slice{*flat_slice, x.chunk(), table_slice::verify::no};
-    erased_events += slice.rows();
+  // Go through the segment API rather than the persisted chunk, because the
+  // latter holds a compressed segment when compression is enabled.
+  if (auto slices = x.lookup(x.ids())) {
+    for (auto& slice : *slices)
+      erased_events += slice.rows();
+  } else {
+    VAST_WARN("{} failed to count events of segment {}: {}",
+              detail::pretty_type_name(this), segment_id,
+              render(slices.error()));
   }
   VAST_INFO("{} erases entire segment {}", detail::pretty_type_name(this),
             segment_id);
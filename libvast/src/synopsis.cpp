@@ -8,6 +8,7 @@
 
 #include "vast/synopsis.hpp"
 
+#include "vast/bloom_filter_synopsis.hpp"
 #include "vast/bool_synopsis.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/error.hpp"
@@ -94,19 +95,26 @@ pack(flatbuffers::FlatBufferBuilder& builder, const synopsis_ptr& synopsis,
     synopsis_builder.add_qualified_record_field(*column_name);
     synopsis_builder.add_bool_synopsis(&bool_synopsis);
     return synopsis_builder.Finish();
-  } else {
-    auto data = fbs::serialize_bytes(builder, synopsis);
-    if (!data)
-      return data.error();
-    fbs::opaque_synopsis::v0Builder opaque_builder(builder);
-    opaque_builder.add_data(*data);
-    auto opaque_synopsis = opaque_builder.Finish();
-    fbs::synopsis::v0Builder synopsis_builder(builder);
-    synopsis_builder.add_qualified_record_field(*column_name);
-    synopsis_builder.add_opaque_synopsis(opaque_synopsis);
-    return synopsis_builder.Finish();
   }
-  return caf::make_error(ec::logic_error, "unreachable");
+  if (auto bfptr = dynamic_cast<bloom_filter_synopsis_base*>(ptr)) {
+    // Synopses without a native layout fall back to the opaque one below.
+    if (auto native = bfptr->pack_native(builder)) {
+      fbs::synopsis::v0Builder synopsis_builder(builder);
+      synopsis_builder.add_qualified_record_field(*column_name);
+      synopsis_builder.add_bloom_filter_synopsis(*native);
+      return synopsis_builder.Finish();
+    }
+  }
+  auto data = fbs::serialize_bytes(builder, synopsis);
+  if (!data)
+    return data.error();
+  fbs::opaque_synopsis::v0Builder opaque_builder(builder);
+  opaque_builder.add_data(*data);
+  auto opaque_synopsis = opaque_builder.Finish();
+  fbs::synopsis::v0Builder synopsis_builder(builder);
+  synopsis_builder.add_qualified_record_field(*column_name);
+  synopsis_builder.add_opaque_synopsis(opaque_synopsis);
+  return synopsis_builder.Finish();
 }
 
 caf::error unpack(const fbs::synopsis::v0& synopsis, synopsis_ptr& ptr) {
@@ -123,6 +131,9 @@ caf::error unpack(const fbs::synopsis::v0& synopsis, synopsis_ptr& ptr) {
       os->data()->size());
     if (auto error = sink(ptr))
       return error;
+  } else if (auto bfs = synopsis.bloom_filter_synopsis()) {
+    if (auto error = unpack(*bfs, ptr))
+      return error;
   } else {
     return caf::make_error(ec::format_error, "no synopsis type");
   }
@@ -51,15 +51,28 @@ command::opts_builder add_index_opts(command::opts_builder ob) {
                                        "partition")
     .add<size_t>("max-resident-partitions", "maximum number of in-memory "
                                             "partitions")
+    .add<size_t>("active-partitions", "number of concurrently filled "
+                                      "partitions")
     .add<size_t>("max-taste-partitions", "maximum number of immediately "
                                          "scheduled partitions")
-    .add<size_t>("max-queries,q", "maximum number of concurrent queries");
+    .add<size_t>("max-queries,q", "maximum number of concurrent queries")
+    .add<bool>("meta-index-blocked-bloom-filters", "use cache-blocked Bloom "
+                                                   "filters for new partition "
+                                                   "synopses")
+    .add<bool>("partition-local-evaluation", "evaluate queries within "
+                                             "passive partitions without "
+                                             "spawning indexer actors");
 }
 
 command::opts_builder add_archive_opts(command::opts_builder ob) {
   return std::move(ob)
     .add<size_t>("segments,s", "number of cached segments")
-    .add<size_t>("max-segment-size,m", "maximum segment size in MB");
+    .add<size_t>("max-segment-size,m", "maximum segment size in MB")
+    .add<std::string>("segment-compression", "compression algorithm of "
+                                             "segments (none, lz4, or zstd)")
+    .add<int>("segment-compression-level", "compression level of segments")
+    .add<size_t>("archive-workers", "number of workers that check archive "
+                                    "segments concurrently");
 }
 
 auto make_count_command() {
@@ -144,8 +157,10 @@ auto make_export_command() {
 #if VAST_ENABLE_ARROW
   export_->add_subcommand("arrow", "exports query results in Arrow format",
                           documentation::vast_export_arrow,
-                          opts("?vast.export.arrow"));
-
+                          opts("?vast.export.arrow")
+                            .add<bool>("file", "write one Arrow IPC file per "
+                                               "layout into the directory "
+                                               "given by --write"));
 #endif
   for (const auto& plugin : plugins::get()) {
     if (const auto* writer = plugin.as<writer_plugin>()) {
@@ -187,6 +202,8 @@ auto make_import_command() {
       .add<std::string>("listen,l", "the endpoint to listen on "
                                     "([host]:port/type)")
       .add<size_t>("max-events,n", "the maximum number of events to import")
+      .add<size_t>("parser-threads", "number of threads that parse the input "
+                                     "of line-based formats")
       .add<std::string>("read,r", "path to input where to read events from")
       .add<std::string>("read-timeout", "timeout for waiting for incoming data")
       .add<std::string>("schema,S", "alternate schema as string")
@@ -216,6 +233,13 @@ auto make_import_command() {
     "test", "imports random data for testing or benchmarking",
     documentation::vast_import_test,
     opts("?vast.import.test").add<size_t>("seed", "the PRNG seed"));
+#if VAST_ENABLE_ARROW
+  import_->add_subcommand("arrow",
+                          "imports Arrow IPC files or streams from STDIN or "
+                          "file",
+                          documentation::vast_import_arrow,
+                          opts("?vast.import.arrow"));
+#endif
   for (const auto& plugin : plugins::get()) {
     if (const auto* reader = plugin.as<reader_plugin>()) {
       auto opts_category
@@ -423,6 +447,9 @@ auto make_command_factory() {
     {"export zeek", make_writer_command("zeek")},
     {"get", get_command},
     {"infer", infer_command},
+#if VAST_ENABLE_ARROW
+    {"import arrow", import_command},
+#endif
     {"import csv", import_command},
     {"import json", import_command},
     {"import suricata", import_command},
@@ -27,6 +27,8 @@
 #include <caf/stream_sink.hpp>
 
 #include <algorithm>
+#include <unordered_map>
+#include <utility>
 
 namespace vast::system {
 
@@ -48,27 +50,117 @@ void archive_state::send_report() {
   self->send(accountant, std::move(r));
 }
 
-std::unique_ptr<segment_store::lookup> archive_state::next_session() {
-  while (!requests.empty()) {
-    auto& request = requests.front();
-    if (request.cancelled || request.ids_queue.empty()) {
-      // Not sure whether this is really necessary.
-      while (!request.ids_queue.empty()) {
-        request.ids_queue.front().second.deliver(atom::done_v);
-        request.ids_queue.pop();
-      }
-      requests.pop_front();
+void archive_state::schedule() {
+  if (resume_pending)
+    return;
+  resume_pending = true;
+  self->send(self, atom::internal_v, atom::resume_v);
+}
+
+bool archive_state::step() {
+  if (idle_workers.empty())
+    return false;
+  // Visit every request at most once, rotating each visited request to the
+  // back so that concurrent requests take turns.
+  for (auto n = requests.size(); n > 0; --n) {
+    auto request = requests.begin();
+    requests.splice(requests.end(), requests, request);
+    if (request->cancelled) {
+      request->session.reset();
+      if (request->pending == 0)
+        finish_session(request);
       continue;
     }
-    // We found an active request.
-    auto& [ids, rp] = request.ids_queue.front();
-    active_promise = std::move(rp);
-    session_ids = std::move(ids);
-    request.ids_queue.pop();
-    return store->extract(session_ids);
+    if (!request->session) {
+      if (request->pending > 0 || request->ids_queue.empty())
+        continue;
+      auto& [ids, rp] = request->ids_queue.front();
+      request->active_promise = std::move(rp);
+      request->session_ids = std::move(ids);
+      request->ids_queue.pop();
+      request->session = store->extract(request->session_ids);
+      if (!request->session) {
+        finish_session(request);
+        continue;
+      }
+    }
+    auto next = request->session->next_segment();
+    if (!next) {
+      // The session is exhausted or failed to load a segment.
+      if (next.error() != caf::no_error) {
+        VAST_ERROR("{} failed to retrieve slices: {}", self, next.error());
+        request->error = std::move(next.error());
+      }
+      request->session.reset();
+      if (request->pending == 0)
+        finish_session(request);
+      return true;
+    }
+    auto slices = caf::get_if<std::vector<table_slice>>(&*next);
+    if (slices && slices->empty())
+      return true;
+    auto worker = std::move(idle_workers.back());
+    idle_workers.pop_back();
+    ++request->pending;
+    auto handle_result = [this, request, worker](caf::error err) {
+      idle_workers.push_back(worker);
+      --request->pending;
+      if (err) {
+        VAST_ERROR("{} {}", self, err);
+        // We deliver the remaining promises of this request once the
+        // pending workers of the current session have finished.
+        request->cancelled = true;
+        if (!request->error)
+          request->error = std::move(err);
+      }
+      if (!request->session && request->pending == 0)
+        finish_session(request);
+      schedule();
+    };
+    if (slices) {
+      self
+        ->request(worker, caf::infinite, request->query, std::move(*slices),
+                  request->session_ids)
+        .then([=](atom::done) { handle_result(caf::none); },
+              [=](caf::error& err) { handle_result(std::move(err)); });
+      return true;
+    }
+    // Decoding a persisted segment may involve decompression, which we leave
+    // to the worker as well. The decoded segment comes back for caching.
+    self
+      ->request(worker, caf::infinite, request->query,
+                std::move(caf::get<chunk_ptr>(*next)), request->session_ids)
+      .then(
+        [=](segment& x) {
+          if (store)
+            store->cache(std::move(x));
+          handle_result(caf::none);
+        },
+        [=](caf::error& err) { handle_result(std::move(err)); });
+    return true;
+  }
+  VAST_TRACE("archive has no requests with outstanding work");
+  return false;
+}
+
+void archive_state::finish_session(std::list<request_state>::iterator request) {
+  VAST_ASSERT(!request->session);
+  VAST_ASSERT(request->pending == 0);
+  if (request->active_promise.pending()) {
+    if (request->error)
+      request->active_promise.deliver(std::exchange(request->error, {}));
+    else
+      request->active_promise.deliver(atom::done_v);
+  }
+  request->error = {};
+  if (request->cancelled) {
+    while (!request->ids_queue.empty()) {
+      request->ids_queue.front().second.deliver(atom::done_v);
+      request->ids_queue.pop();
+    }
   }
-  VAST_TRACE("archive has no requests");
-  return nullptr;
+  if (request->ids_queue.empty())
+    requests.erase(request);
 }
 
 caf::typed_response_promise<atom::done>
@@ -100,25 +192,28 @@ archive_state::file_request(vast::query query, const ids& xs) {
                query.cmd);
     requests.emplace_back(std::move(query), std::make_pair(xs, rp));
   }
-  if (!session) {
-    session = next_session();
-    // We just queued the work.
-    VAST_ASSERT(session);
-    self->send(self, atom::internal_v, atom::resume_v);
-  }
+  schedule();
   return rp;
 }
 
 archive_actor::behavior_type
 archive(archive_actor::stateful_pointer<archive_state> self,
         const std::filesystem::path& dir, size_t capacity,
-        size_t max_segment_size) {
+        size_t max_segment_size, compression method, int level,
+        size_t num_workers) {
   VAST_VERBOSE("{} initializes archive in {} with a maximum segment "
-               "size of {} and {} segments in memory",
-               self, dir, max_segment_size, capacity);
+               "size of {}, {} segments in memory, {} compression, and {} "
+               "workers",
+               self, dir, max_segment_size, capacity, to_string(method),
+               num_workers);
+  VAST_ASSERT(num_workers > 0);
   self->state.self = self;
-  self->state.store = segment_store::make(dir, max_segment_size, capacity);
+  self->state.store
+    = segment_store::make(dir, max_segment_size, capacity, method, level);
   VAST_ASSERT(self->state.store != nullptr);
+  for (size_t i = 0; i < num_workers; ++i)
+    self->state.idle_workers.push_back(
+      self->spawn<caf::linked>(archive_worker));
   self->set_exit_handler([self](const caf::exit_msg& msg) {
     VAST_DEBUG("{} got EXIT from {}", self, msg.source);
     self->state.send_report();
@@ -147,8 +242,10 @@ archive(archive_actor::stateful_pointer<archive_state> self,
                                          },
                                          request.query.cmd);
                      });
-    if (it != self->state.requests.end())
+    if (it != self->state.requests.end()) {
       it->cancelled = true;
+      self->state.schedule();
+    }
   });
   return {
     [self](vast::query query, const ids& xs) -> caf::result<atom::done> {
@@ -163,79 +260,9 @@ archive(archive_actor::stateful_pointer<archive_state> self,
       return self->state.file_request(std::move(query), xs);
     },
     [self](atom::internal, atom::resume) {
-      VAST_ASSERT(self->state.session);
-      VAST_ASSERT(!self->state.requests.empty());
-      if (self->state.requests.front().cancelled) {
-        self->state.active_promise.deliver(atom::done_v);
-        self->state.session = self->state.next_session();
-        if (!self->state.session)
-          // Nothing to do at the moment;
-          return;
-      };
-      auto& request = self->state.requests.front();
-      auto slice = self->state.session->next();
-      if (slice) {
-        // Add an lru cache for checkers in the archive state.
-        auto checker = expression{};
-        if (request.query.expr != expression{}) {
-          auto c = tailor(request.query.expr, slice->layout());
-          if (!c) {
-            VAST_ERROR("{} {}", self, c.error());
-            request.cancelled = true;
-            self->state.active_promise.deliver(c.error());
-            // We deliver the remaining promises in this request regularly in
-            // the next run of `next_session()`.
-            self->send(self, atom::internal_v, atom::resume_v);
-            return;
-          }
-          checker = prune_meta_predicates(std::move(*c));
-        }
-        caf::visit(detail::overload{
-                     [&](const query::count& count) {
-                       if (count.mode == query::count::estimate)
-                         die("logic error detected");
-                       auto result = count_matching(*slice, checker,
-                                                    self->state.session_ids);
-                       self->send(count.sink, result);
-                     },
-                     [&](const query::extract& extract) {
-                       if (extract.policy == query::extract::preserve_ids) {
-                         for (auto& sub_slice :
-                              select(*slice, self->state.session_ids)) {
-                           if (request.query.expr == expression{}) {
-                             self->send(extract.sink, sub_slice);
-                           } else {
-                             auto hits = evaluate(checker, sub_slice);
-                             for (auto& final_slice : select(sub_slice, hits))
-                               self->send(extract.sink, final_slice);
-                           }
-                         }
-                       } else {
-                         auto final_slice
-                           = filter(*slice, checker, self->state.session_ids);
-                         if (final_slice)
-                           self->send(extract.sink, *final_slice);
-                       }
-                     },
-                     [&](query::erase) { die("logic error detected"); },
-                   },
-                   request.query.cmd);
-      } else {
-        // We didn't get a slice from the segment store.
-        if (slice.error() != caf::no_error) {
-          VAST_ERROR("{} failed to retrieve slice: {}", self, slice.error());
-          self->state.active_promise.deliver(slice.error());
-        } else {
-          self->state.active_promise.deliver(atom::done_v);
-        }
-        // This session is done.
-        // We're at the end, check for more requests.
-        self->state.session = self->state.next_session();
-        if (!self->state.session)
-          // Nothing to do at the moment;
-          return;
-      }
-      self->send(self, atom::internal_v, atom::resume_v);
+      self->state.resume_pending = false;
+      if (self->state.step())
+        self->state.schedule();
     },
     [self](
       caf::stream<table_slice> in) -> caf::inbound_stream_slot<table_slice> {
@@ -286,6 +313,11 @@ archive(archive_actor::stateful_pointer<archive_state> self,
     [self](atom::status, status_verbosity v) {
       auto result = caf::settings{};
       auto& archive_status = put_dictionary(result, "archive");
+      if (v >= status_verbosity::detailed) {
+        put(archive_status, "requests", self->state.requests.size());
+        put(archive_status, "idle-workers",
+            self->state.idle_workers.size());
+      }
       if (v >= status_verbosity::debug)
         detail::fill_status_map(archive_status, self);
       self->state.store->inspect_status(archive_status, v);
@@ -304,4 +336,86 @@ archive(archive_actor::stateful_pointer<archive_state> self,
   };
 }
 
+namespace {
+
+/// Runs the candidate checks of a query over the table slices of a segment and
+/// sends the results to the query's sink.
+caf::error check_candidates(archive_worker_actor::pointer self,
+                            const vast::query& query,
+                            std::vector<table_slice>& slices, const ids& xs) {
+  // Segments mostly contain slices of few layouts, so we tailor the
+  // expression once per layout.
+  auto checkers = std::unordered_map<type, expression>{};
+  for (auto& slice : slices) {
+    auto checker = expression{};
+    if (query.expr != expression{}) {
+      auto layout = type{slice.layout()};
+      auto it = checkers.find(layout);
+      if (it == checkers.end()) {
+        auto c = tailor(query.expr, layout);
+        if (!c)
+          return std::move(c.error());
+        it = checkers
+               .emplace(std::move(layout), prune_meta_predicates(std::move(*c)))
+               .first;
+      }
+      checker = it->second;
+    }
+    caf::visit(detail::overload{
+                 [&](const query::count& count) {
+                   if (count.mode == query::count::estimate)
+                     die("logic error detected");
+                   auto result = count_matching(slice, checker, xs);
+                   self->send(count.sink, result);
+                 },
+                 [&](const query::extract& extract) {
+                   if (extract.policy == query::extract::preserve_ids) {
+                     for (auto& sub_slice : select(slice, xs)) {
+                       if (query.expr == expression{}) {
+                         self->send(extract.sink, sub_slice);
+                       } else {
+                         auto hits = evaluate(checker, sub_slice);
+                         for (auto& final_slice : select(sub_slice, hits))
+                           self->send(extract.sink, final_slice);
+                       }
+                     }
+                   } else {
+                     auto final_slice = filter(slice, checker, xs);
+                     if (final_slice)
+                       self->send(extract.sink, *final_slice);
+                   }
+                 },
+                 [&](const query::erase&) { die("logic error detected"); },
+               },
+               query.cmd);
+  }
+  return caf::none;
+}
+
+} // namespace
+
+archive_worker_actor::behavior_type
+archive_worker(archive_worker_actor::pointer self) {
+  return {
+    [self](const vast::query& query, std::vector<table_slice>& slices,
+           const ids& xs) -> caf::result<atom::done> {
+      if (auto err = check_candidates(self, query, slices, xs))
+        return err;
+      return atom::done_v;
+    },
+    [self](const vast::query& query, chunk_ptr& chunk,
+           const ids& xs) -> caf::result<segment> {
+      auto x = segment::make(std::move(chunk));
+      if (!x)
+        return std::move(x.error());
+      auto slices = x->lookup(xs);
+      if (!slices)
+        return std::move(slices.error());
+      if (auto err = check_candidates(self, query, *slices, xs))
+        return err;
+      return std::move(*x);
+    },
+  };
+}
+
 } // namespace vast::system
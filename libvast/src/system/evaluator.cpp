@@ -85,6 +85,11 @@ private:
 
 } // namespace
 
+ids evaluate_hits(const expression& expr,
+                  const evaluator_state::predicate_hits_map& hits) {
+  return caf::visit(ids_evaluator{hits}, expr);
+}
+
 evaluator_state::evaluator_state(
   evaluator_actor::stateful_pointer<evaluator_state> self)
   : self{self} {
@@ -121,7 +126,7 @@ void evaluator_state::handle_missing_result(const offset& position,
 }
 
 void evaluator_state::evaluate() {
-  auto expr_hits = caf::visit(ids_evaluator{predicate_hits}, expr);
+  auto expr_hits = evaluate_hits(expr, predicate_hits);
   VAST_DEBUG("{} got predicate_hits: {} expr_hits: {}", self, predicate_hits,
              expr_hits);
   auto delta = expr_hits - hits;
@@ -24,18 +24,37 @@
 #include "vast/table_slice_builder.hpp"
 #include "vast/table_slice_builder_factory.hpp"
 #include "vast/table_slice_column.hpp"
+#include "vast/time_window_planner.hpp"
 #include "vast/uuid.hpp"
 
 #include <caf/event_based_actor.hpp>
 #include <caf/settings.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <optional>
 
 using namespace std::chrono_literals;
 
 namespace vast::system {
 
+namespace {
+
+/// Checks whether a field holds the event timestamp.
+bool is_timestamp(const record_field& field) {
+  const type* t = &field.type;
+  if (t->name() == "timestamp")
+    return true;
+  while (auto x = caf::get_if<alias_type>(t)) {
+    t = &x->value_type;
+    if (t->name() == "timestamp")
+      return true;
+  }
+  return false;
+}
+
+} // namespace
+
 explorer_state::explorer_state(caf::event_based_actor*) {
   // nop
 }
@@ -80,6 +99,92 @@ void explorer_state::forward_results(vast::table_slice slice) {
   return;
 }
 
+void explorer_state::route_results(context_query& contexts,
+                                   vast::table_slice slice) {
+  std::vector<table_slice_column> timestamps;
+  if (before) {
+    for (const auto& field : slice.layout().fields)
+      if (is_timestamp(field))
+        if (auto column = table_slice_column::make(slice, field.name))
+          timestamps.push_back(std::move(*column));
+  }
+  std::optional<table_slice_column> by_column;
+  if (by) {
+    if (auto col = table_slice_column::make(slice, *by))
+      by_column.emplace(std::move(*col));
+    if (!by_column) {
+      VAST_DEBUG("{} drops results with {} because they have no column {}",
+                 self, slice.layout(), *by);
+      return;
+    }
+  }
+  vast::ids selection;
+  size_t num_selected = 0;
+  for (size_t row = 0; row < slice.rows(); ++row) {
+    auto key = by_column ? materialize((*by_column)[row]) : data{};
+    // Attribute the event to a context that contains it and has not yet
+    // reached the limit of events per result.
+    auto selected = false;
+    auto attribute = [&](size_t context) {
+      if (selected)
+        return;
+      auto& attributed = contexts.attributed[context];
+      if (limits.per_result && attributed >= limits.per_result)
+        return;
+      ++attributed;
+      selected = true;
+    };
+    if (before) {
+      for (auto& column : timestamps) {
+        auto x = column[row];
+        if (auto t = caf::get_if<vast::time>(&x))
+          contexts.query.lookup(key, *t, attribute);
+      }
+    } else {
+      contexts.query.lookup(key, vast::time{}, attribute);
+    }
+    if (!selected)
+      continue;
+    auto id = slice.offset() + row;
+    selection.append_bits(false, id - selection.size());
+    selection.append_bits(true, 1);
+    ++num_selected;
+  }
+  if (num_selected == slice.rows()) {
+    forward_results(std::move(slice));
+    return;
+  }
+  for (auto&& selected : vast::select(slice, selection))
+    forward_results(std::move(selected));
+}
+
+void explorer_state::query_contexts(time_window_planner::query query) {
+  auto str = to_string(query.expr());
+  VAST_TRACE_SCOPE("{} spawns new exporter with query {}", self, str);
+  auto exporter_invocation = invocation{{}, "spawn exporter", {str}};
+  caf::put(exporter_invocation.options, "vast.export.preserve-ids", true);
+  // We deliberately don't cap the exporter: busy contexts would exhaust a
+  // shared cap, leaving none for the others. Instead, `route_results`
+  // enforces the limit of events per result for every context individually.
+  ++running_exporters;
+  auto pending = std::make_shared<context_query>();
+  pending->query = std::move(query);
+  self->request(node, caf::infinite, atom::spawn_v, exporter_invocation)
+    .then(
+      [self = self, pending](caf::actor handle) {
+        auto exporter = caf::actor_cast<exporter_actor>(handle);
+        VAST_DEBUG("{} registers exporter {}", self, exporter);
+        self->state.contexts.emplace(exporter.address(), std::move(*pending));
+        self->monitor(exporter);
+        self->send(exporter, atom::sink_v, self);
+        self->send(exporter, atom::run_v);
+      },
+      [self = self](caf::error error) {
+        --self->state.running_exporters;
+        VAST_ERROR("{} failed to spawn exporter: {}", self, error);
+      });
+}
+
 caf::behavior
 explorer(caf::stateful_actor<explorer_state>* self, node_actor node,
          explorer_state::event_limits limits,
@@ -105,9 +210,10 @@ explorer(caf::stateful_actor<explorer_state>* self, node_actor node,
     if (st.initial_query_completed && st.running_exporters == 0)
       self->quit();
   };
-  self->set_down_handler([=]([[maybe_unused]] const caf::down_msg& msg) {
+  self->set_down_handler([=](const caf::down_msg& msg) {
     // Only the spawned EXPORTERs are expected to send down messages.
     auto& st = self->state;
+    st.contexts.erase(msg.source);
     --st.running_exporters;
     VAST_DEBUG("{} received DOWN from {} outstanding requests: {}", self,
                msg.source, st.running_exporters);
@@ -125,24 +231,20 @@ explorer(caf::stateful_actor<explorer_state>* self, node_actor node,
         return;
       }
       if (self->current_sender() != st.initial_exporter) {
-        st.forward_results(slice);
+        auto sender = caf::actor_cast<caf::actor_addr>(self->current_sender());
+        auto contexts = st.contexts.find(sender);
+        if (contexts == st.contexts.end()) {
+          VAST_WARN("{} received table slices from unknown sender {}", self,
+                    sender);
+          return;
+        }
+        st.route_results(contexts->second, std::move(slice));
         return;
       }
       // Don't bother making new queries if we discard all results anyways.
       if (st.num_sent >= st.limits.total)
         return;
       auto&& layout = slice.layout();
-      auto is_timestamp = [](const record_field& field) {
-        const type* t = &field.type;
-        if (t->name() == "timestamp")
-          return true;
-        while (auto x = caf::get_if<alias_type>(t)) {
-          t = &x->value_type;
-          if (t->name() == "timestamp")
-            return true;
-        }
-        return false;
-      };
       auto it = std::find_if(layout.fields.begin(), layout.fields.end(),
                              is_timestamp);
       if (it == layout.fields.end()) {
@@ -162,76 +264,34 @@ explorer(caf::stateful_actor<explorer_state>* self, node_actor node,
       VAST_DEBUG("{} uses {} to construct timebox", self, it->name);
       auto column = table_slice_column::make(slice, it->name);
       VAST_ASSERT(column);
+      auto planner = time_window_planner{
+        st.by, defaults::explore::max_windows_per_query};
       for (size_t i = 0; i < column->size(); ++i) {
         auto data_view = (*column)[i];
         auto x = caf::get_if<vast::time>(&data_view);
         // Skip if no value
         if (!x)
           continue;
-        std::optional<vast::expression> before_expr;
-        if (st.before)
-          before_expr = predicate{type_extractor{time_type{}.name("timestamp")},
-                                  relational_operator::greater_equal,
-                                  data{*x - *st.before}};
-
-        std::optional<vast::expression> after_expr;
-        if (st.after)
-          after_expr
-            = predicate{type_extractor{time_type{}.name("timestamp")},
-                        relational_operator::less_equal, data{*x + *st.after}};
-        std::optional<vast::expression> by_expr;
+        // Without a temporal constraint, the contexts span the entire time
+        // range and merge into one.
+        auto first = st.before ? *x - *st.before : vast::time::min();
+        auto last = st.after ? *x + *st.after : vast::time::max();
+        auto key = data{};
         if (st.by) {
           VAST_ASSERT(by_column); // Should have been checked above.
           auto ci = (*by_column)[i];
           if (caf::get_if<caf::none_t>(&ci))
             continue;
-          // TODO: Make `predicate` accept a data_view as well to save
-          // the call to `materialize()`.
-          by_expr = predicate{field_extractor{*st.by},
-                              relational_operator::equal, materialize(ci)};
+          key = materialize(ci);
         }
-        auto build_conjunction
-          = [](std::optional<expression>&& lhs,
-               std::optional<expression>&& rhs) -> std::optional<expression> {
-          if (lhs && rhs)
-            return conjunction{std::move(*lhs), std::move(*rhs)};
-          if (lhs)
-            return std::move(lhs);
-          if (rhs)
-            return std::move(rhs);
-          return std::nullopt;
-        };
-        auto temporal_expr
-          = build_conjunction(std::move(before_expr), std::move(after_expr));
-        auto spatial_expr = std::move(by_expr);
-        auto expr = build_conjunction(std::move(temporal_expr),
-                                      std::move(spatial_expr));
-        // We should have checked during argument parsing that `expr` has at
-        // least one constraint.
-        VAST_ASSERT(expr);
-        auto query = to_string(*expr);
-        VAST_TRACE_SCOPE("{} spawns new exporter with query {}", self, query);
-        auto exporter_invocation = invocation{{}, "spawn exporter", {query}};
-        caf::put(exporter_invocation.options, "vast.export.preserve-ids", true);
-        if (st.limits.per_result)
-          caf::put(exporter_invocation.options, "vast.export.max-events",
-                   st.limits.per_result);
-        ++self->state.running_exporters;
-        self
-          ->request(st.node, caf::infinite, atom::spawn_v, exporter_invocation)
-          .then(
-            [=](caf::actor handle) {
-              auto exporter = caf::actor_cast<exporter_actor>(handle);
-              VAST_DEBUG("{} registers exporter {}", self, exporter);
-              self->monitor(exporter);
-              self->send(exporter, atom::sink_v, self);
-              self->send(exporter, atom::run_v);
-            },
-            [=](caf::error error) {
-              --self->state.running_exporters;
-              VAST_ERROR("{} failed to spawn exporter: {}", self, error);
-            });
+        planner.add(first, last, std::move(key));
       }
+      [[maybe_unused]] auto num_contexts = planner.size();
+      auto queries = planner.plan();
+      VAST_DEBUG("{} combines {} contexts into {} queries", self, num_contexts,
+                 queries.size());
+      for (auto& query : queries)
+        st.query_contexts(std::move(query));
     },
     [=](atom::provision, exporter_actor exporter) {
       self->state.initial_exporter = exporter.address();
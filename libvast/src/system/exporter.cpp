@@ -31,10 +31,21 @@
 #include <caf/stream_slot.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 namespace vast::system {
 
 namespace {
 
+/// The upper bound for the number of partitions in a single request to the
+/// INDEX. Partitions spend part of their time loading from disk, so we
+/// oversubscribe the available cores.
+size_t max_window() {
+  return std::max(size_t{2}, 2 * size_t{std::thread::hardware_concurrency()});
+}
+
 void ship_results(exporter_actor::stateful_pointer<exporter_state> self) {
   VAST_TRACE_SCOPE("");
   auto& st = self->state;
@@ -128,12 +139,11 @@ void request_more_hits(exporter_actor::stateful_pointer<exporter_state> self) {
   // hits by the INDEX.
   VAST_ASSERT(st.query.received < st.query.expected);
   auto remaining = st.query.expected - st.query.received;
-  // TODO: Figure out right number of partitions to ask for. For now, we
-  // bound the number by an arbitrary constant.
-  auto n = std::min(remaining, size_t{2});
+  auto n = std::min(remaining, st.window.size());
   // Store how many partitions we schedule with our request. When receiving
   // 'done', we add this number to `received`.
   st.query.scheduled = n;
+  st.batch_start = std::chrono::steady_clock::now();
   // Request more hits from the INDEX.
   VAST_DEBUG("{} asks index to process {} more partitions", self, n);
   self->send(st.index, st.id, detail::narrow<uint32_t>(n));
@@ -278,6 +288,9 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
             if (partitions > 0) {
               self->state.query.expected = partitions;
               self->state.query.scheduled = scheduled;
+              self->state.window = query_window{
+                std::max(size_t{scheduled}, size_t{1}), max_window()};
+              self->state.batch_start = std::chrono::steady_clock::now();
             } else {
               shutdown(self);
             }
@@ -320,6 +333,9 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
         caf::settings exp;
         put(exp, "expression", to_string(self->state.expr));
         put(exp, "start", caf::deep_to_string(self->state.start));
+        put(exp, "partition-window", self->state.window.size());
+        put(exp, "partition-latency",
+            to_string(self->state.window.partition_latency()));
         auto& xs = put_list(result, "queries");
         xs.emplace_back(std::move(exp));
         detail::fill_status_map(exporter_status, self);
@@ -342,6 +358,12 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
       caf::timespan runtime
         = std::chrono::system_clock::now() - self->state.start;
       self->state.query.runtime = runtime;
+      // Results that we could not ship yet indicate that the sink does not
+      // keep up with the partitions we schedule.
+      auto batch_runtime
+        = std::chrono::steady_clock::now() - self->state.batch_start;
+      self->state.window.complete(self->state.query.scheduled, batch_runtime,
+                                  self->state.query.cached > 0);
       self->state.query.received += self->state.query.scheduled;
       if (self->state.query.received < self->state.query.expected) {
         VAST_DEBUG("{} received hits from {}/{} partitions", self,
@@ -57,7 +57,9 @@
 #include <chrono>
 #include <ctime>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <string_view>
 #include <unistd.h>
 
 using namespace std::chrono;
@@ -66,7 +68,7 @@ using namespace std::chrono;
 //
 // The index is implemented as a stream stage that hooks into the table slice
 // stream coming from the importer, and forwards them to the current active
-// partition
+// partition of their layout group
 //
 //              table slice              table slice                      table slice column
 //   importer ----------------> index ---------------> active partition ------------------------> indexer
@@ -105,8 +107,70 @@ using namespace std::chrono;
 
 namespace vast::system {
 
+size_t layout_group(const table_slice& slice, size_t num_groups) {
+  VAST_ASSERT(num_groups > 0);
+  if (num_groups == 1)
+    return 0;
+  return std::hash<std::string_view>{}(slice.layout().name()) % num_groups;
+}
+
+bool active_partition_selector::operator()(const layout_group_filter& filter,
+                                           const table_slice& slice) const {
+  return layout_group(slice, filter.num_groups) == filter.group;
+}
+
 namespace {
 
+/// The state of a FLUSH RELAY actor.
+struct flush_relay_state {
+  /// The listener that waits for all active partitions to flush.
+  flush_listener_actor listener;
+
+  /// The active partitions that did not flush yet.
+  std::vector<caf::actor_addr> pending;
+
+  /// Removes a partition from the pending ones and notifies the listener
+  /// after the last one.
+  void done(flush_listener_actor::stateful_pointer<flush_relay_state> self,
+            const caf::actor_addr& partition) {
+    auto it = std::find(pending.begin(), pending.end(), partition);
+    if (it == pending.end())
+      return;
+    pending.erase(it);
+    if (!pending.empty())
+      return;
+    self->send(listener, atom::flush_v);
+    self->quit();
+  }
+
+  constexpr static inline auto name = "flush-relay";
+};
+
+/// Notifies a flush listener once all of the given active partitions flushed.
+/// A partition that terminates before flushing counts as flushed, since it
+/// would otherwise keep the listener waiting forever.
+flush_listener_actor::behavior_type
+flush_relay(flush_listener_actor::stateful_pointer<flush_relay_state> self,
+            flush_listener_actor listener,
+            const std::vector<active_partition_actor>& partitions) {
+  self->state.listener = std::move(listener);
+  for (const auto& partition : partitions) {
+    self->monitor(partition);
+    self->state.pending.push_back(partition.address());
+  }
+  self->set_down_handler([self](const caf::down_msg& msg) {
+    VAST_DEBUG("{} received DOWN from active partition {} before it flushed",
+               self, msg.source);
+    self->state.done(self, msg.source);
+  });
+  return {
+    [self](atom::flush) {
+      self->state.done(self, caf::actor_cast<caf::actor_addr>(
+                               self->current_sender()));
+    },
+  };
+}
+
 caf::error extract_partition_synopsis(
   const std::filesystem::path& partition_path,
   const std::filesystem::path& partition_synopsis_path) {
@@ -155,7 +219,7 @@ partition_actor partition_factory::operator()(const uuid& id) const {
   const auto path = state_.partition_path(id);
   VAST_DEBUG("{} loads partition {} for path {}", state_.self, id, path);
   return state_.self->spawn(passive_partition, id, filesystem_, path,
-                            state_.store);
+                            state_.store, state_.partition_local_evaluation);
 }
 
 filesystem_actor& partition_factory::filesystem() {
@@ -215,10 +279,10 @@ caf::error index_state::load_from_disk() {
           return error;
       }
       auto chunk = chunk::mmap(synopsis_dir);
-      if (!chunk) {
-        VAST_WARN("{} could not mmap partition at {}", self, part_dir);
-        continue;
-      }
+      if (!chunk)
+        return caf::make_error(ec::filesystem_error, "failed to mmap partition "
+                                                     "synopsis",
+                               synopsis_dir, chunk.error());
       const auto* ps_flatbuffer
         = fbs::GetPartitionSynopsis(chunk->get()->data());
       partition_synopsis ps;
@@ -226,6 +290,8 @@ caf::error index_state::load_from_disk() {
           != fbs::partition_synopsis::PartitionSynopsis::v0)
         return caf::make_error(ec::format_error, "invalid partition synopsis "
                                                  "version");
+      // The synopses copy what they need, so the file is unmapped again when
+      // the chunk goes out of scope.
       if (auto error = unpack(*ps_flatbuffer->partition_synopsis_as_v0(), ps))
         return error;
       meta_index_bytes += ps.memusage();
@@ -305,17 +371,27 @@ void index_state::add_flush_listener(flush_listener_actor listener) {
 void index_state::notify_flush_listeners() {
   VAST_DEBUG("{} sends 'flush' messages to {} listeners", self,
              flush_listeners.size());
+  auto actors = std::vector<active_partition_actor>{};
+  for (const auto& active : active_partitions)
+    if (active.actor)
+      actors.push_back(active.actor);
   for (auto& listener : flush_listeners) {
-    if (active_partition.actor)
-      self->send(active_partition.actor, atom::subscribe_v, atom::flush_v,
-                 listener);
-    else
+    if (actors.empty()) {
       self->send(listener, atom::flush_v);
+      continue;
+    }
+    // The listener must wait for all active partitions, including the ones
+    // that terminate before they flush.
+    auto relay = self->spawn(flush_relay, listener, actors);
+    for (const auto& actor : actors)
+      self->send(actor, atom::subscribe_v, atom::flush_v, relay);
   }
   flush_listeners.clear();
 }
 
-void index_state::create_active_partition() {
+void index_state::create_active_partition(size_t group) {
+  VAST_ASSERT(group < active_partitions.size());
+  auto& active_partition = active_partitions[group];
   auto id = uuid::random();
   caf::settings index_opts;
   index_opts["cardinality"] = partition_capacity;
@@ -325,17 +401,24 @@ void index_state::create_active_partition() {
   put(synopsis_options, "max-partition-size", partition_capacity);
   put(synopsis_options, "address-synopsis-fp-rate", meta_index_fp_rate);
   put(synopsis_options, "string-synopsis-fp-rate", meta_index_fp_rate);
+  put(synopsis_options, "blocked-bloom-filters",
+      meta_index_blocked_bloom_filters);
   active_partition.actor
     = self->spawn(::vast::system::active_partition, id, filesystem, index_opts,
                   synopsis_options, store);
   active_partition.stream_slot
     = stage->add_outbound_path(active_partition.actor);
+  stage->out().set_filter(active_partition.stream_slot,
+                          layout_group_filter{group, active_partitions.size()});
   active_partition.capacity = partition_capacity;
   active_partition.id = id;
-  VAST_DEBUG("{} created new partition {}", self, id);
+  VAST_DEBUG("{} created new partition {} for layout group {}", self, id,
+             group);
 }
 
-void index_state::decomission_active_partition() {
+void index_state::decomission_active_partition(size_t group) {
+  VAST_ASSERT(group < active_partitions.size());
+  auto& active_partition = active_partitions[group];
   auto id = active_partition.id;
   auto actor = std::exchange(active_partition.actor, {});
   unpersisted[id] = actor;
@@ -379,6 +462,14 @@ void index_state::decomission_active_partition() {
       });
 }
 
+active_partition_actor
+index_state::find_active_partition(const uuid& id) const {
+  for (const auto& active : active_partitions)
+    if (active.actor != nullptr && active.id == id)
+      return active.actor;
+  return {};
+}
+
 caf::typed_response_promise<caf::settings>
 index_state::status(status_verbosity v) const {
   using caf::put;
@@ -415,7 +506,10 @@ index_state::status(status_verbosity v) const {
     }
     put(index_status, "meta-index-bytes", meta_index_bytes);
     put(index_status, "num-active-partitions",
-        active_partition.actor == nullptr ? 0 : 1);
+        std::count_if(active_partitions.begin(), active_partitions.end(),
+                      [](const auto& active) {
+                        return active.actor != nullptr;
+                      }));
     put(index_status, "num-cached-partitions", inmem_partitions.size());
     put(index_status, "num-unpersisted-partitions", unpersisted.size());
     auto& partitions = put_dictionary(index_status, "partitions");
@@ -451,9 +545,10 @@ index_state::status(status_verbosity v) const {
     };
     // Resident partitions.
     auto& active = caf::put_list(partitions, "active");
-    active.reserve(1);
-    if (active_partition.actor != nullptr)
-      partition_status(active_partition.id, active_partition.actor, active);
+    active.reserve(active_partitions.size());
+    for (const auto& active_partition : active_partitions)
+      if (active_partition.actor != nullptr)
+        partition_status(active_partition.id, active_partition.actor, active);
     auto& cached = put_list(partitions, "cached");
     cached.reserve(inmem_partitions.size());
     for (const auto& [id, actor] : inmem_partitions)
@@ -479,21 +574,19 @@ index_state::collect_query_actors(query_state& lookup,
     return result;
   // Prefer partitions that are already available in RAM.
   auto partition_is_loaded = [&](const uuid& candidate) {
-    return (active_partition.actor != nullptr
-            && active_partition.id == candidate)
+    return find_active_partition(candidate) != nullptr
            || (unpersisted.count(candidate) != 0u)
            || inmem_partitions.contains(candidate);
   };
-  std::partition(lookup.partitions.begin(), lookup.partitions.end(),
-                 partition_is_loaded);
+  std::stable_partition(lookup.partitions.begin(), lookup.partitions.end(),
+                        partition_is_loaded);
   // Helper function to spin up EVALUATOR actors for a single partition.
   auto spin_up = [&](const uuid& partition_id) -> partition_actor {
     // We need to first check whether the ID is the active partition or one
     // of our unpersisted ones. Only then can we dispatch to our LRU cache.
     partition_actor part;
-    if (active_partition.actor != nullptr
-        && active_partition.id == partition_id)
-      part = active_partition.actor;
+    if (auto active = find_active_partition(partition_id))
+      part = active;
     else if (auto it = unpersisted.find(partition_id); it != unpersisted.end())
       part = it->second;
     else if (auto it = persisted_partitions.find(partition_id);
@@ -595,14 +688,22 @@ index(index_actor::stateful_pointer<index_state> self, store_actor store,
       filesystem_actor filesystem, const std::filesystem::path& dir,
       size_t partition_capacity, size_t max_inmem_partitions,
       size_t taste_partitions, size_t num_workers,
-      const std::filesystem::path& meta_index_dir, double meta_index_fp_rate) {
-  VAST_TRACE_SCOPE("{} {} {} {} {} {} {}", VAST_ARG(filesystem), VAST_ARG(dir),
-                   VAST_ARG(partition_capacity), VAST_ARG(max_inmem_partitions),
-                   VAST_ARG(taste_partitions), VAST_ARG(num_workers),
-                   VAST_ARG(meta_index_dir), VAST_ARG(meta_index_fp_rate));
+      const std::filesystem::path& meta_index_dir, double meta_index_fp_rate,
+      bool meta_index_blocked_bloom_filters, bool partition_local_evaluation,
+      size_t num_active_partitions) {
+  VAST_TRACE_SCOPE("{} {} {} {} {} {} {} {} {} {} {}", VAST_ARG(filesystem),
+                   VAST_ARG(dir), VAST_ARG(partition_capacity),
+                   VAST_ARG(max_inmem_partitions), VAST_ARG(taste_partitions),
+                   VAST_ARG(num_workers),
+                   VAST_ARG(meta_index_dir), VAST_ARG(meta_index_fp_rate),
+                   VAST_ARG(meta_index_blocked_bloom_filters),
+                   VAST_ARG(partition_local_evaluation),
+                   VAST_ARG(num_active_partitions));
+  VAST_ASSERT(num_active_partitions > 0);
   VAST_VERBOSE("{} initializes index in {} with a maximum partition "
-               "size of {} events and {} resident partitions",
-               self, dir, partition_capacity, max_inmem_partitions);
+               "size of {} events, {} active and {} resident partitions",
+               self, dir, partition_capacity, num_active_partitions,
+               max_inmem_partitions);
   if (dir != meta_index_dir)
     VAST_VERBOSE("{} uses {} for meta index data", self, meta_index_dir);
   // Set members.
@@ -618,6 +719,10 @@ index(index_actor::stateful_pointer<index_state> self, store_actor store,
   self->state.inmem_partitions.factory().filesystem() = self->state.filesystem;
   self->state.inmem_partitions.resize(max_inmem_partitions);
   self->state.meta_index_fp_rate = meta_index_fp_rate;
+  self->state.meta_index_blocked_bloom_filters
+    = meta_index_blocked_bloom_filters;
+  self->state.partition_local_evaluation = partition_local_evaluation;
+  self->state.active_partitions.resize(num_active_partitions);
   self->state.meta_index_bytes = 0;
   // Read persistent state.
   if (auto err = self->state.load_from_disk()) {
@@ -637,15 +742,16 @@ index(index_actor::stateful_pointer<index_state> self, store_actor store,
       VAST_ASSERT(x.encoding() != table_slice_encoding::none);
       auto&& layout = x.layout();
       self->state.stats.layouts[layout.name()].count += x.rows();
-      auto& active = self->state.active_partition;
+      auto group = layout_group(x, self->state.active_partitions.size());
+      auto& active = self->state.active_partitions[group];
       if (!active.actor) {
-        self->state.create_active_partition();
+        self->state.create_active_partition(group);
       } else if (x.rows() > active.capacity) {
         VAST_DEBUG("{} exceeds active capacity by {} rows", self,
                    x.rows() - active.capacity);
-        self->state.decomission_active_partition();
+        self->state.decomission_active_partition(group);
         self->state.flush_to_disk();
-        self->state.create_active_partition();
+        self->state.create_active_partition(group);
       }
       out.push(x);
       if (active.capacity == self->state.partition_capacity
@@ -676,7 +782,9 @@ index(index_actor::stateful_pointer<index_state> self, store_actor store,
         // importer.
         self->send_exit(self, err);
       }
-    });
+    },
+    caf::policy::arg<caf::broadcast_downstream_manager<
+      table_slice, layout_group_filter, active_partition_selector>>{});
   self->set_exit_handler([self](const caf::exit_msg& msg) {
     VAST_DEBUG("{} received EXIT from {} with reason: {}", self, msg.source,
                msg.reason);
@@ -685,9 +793,11 @@ index(index_actor::stateful_pointer<index_state> self, store_actor store,
     self->state.stage->out().fan_out_flush();
     self->state.stage->out().close(); // closes outbound paths
     self->state.stage->out().force_emit_batches();
-    // Bring down active partition.
-    if (self->state.active_partition.actor)
-      self->state.decomission_active_partition();
+    // Bring down active partitions.
+    for (size_t group = 0; group < self->state.active_partitions.size();
+         ++group)
+      if (self->state.active_partitions[group].actor)
+        self->state.decomission_active_partition(group);
     // Collect partitions for termination.
     // TODO: We must actor_cast to caf::actor here because 'shutdown' operates
     // on 'std::vector<caf::actor>' only. That should probably be generalized in
@@ -762,8 +872,9 @@ index(index_actor::stateful_pointer<index_state> self, store_actor store,
         return {};
       }
       std::vector<uuid> candidates;
-      if (self->state.active_partition.actor)
-        candidates.push_back(self->state.active_partition.id);
+      for (const auto& active : self->state.active_partitions)
+        if (active.actor)
+          candidates.push_back(active.id);
       for (const auto& [id, _] : self->state.unpersisted)
         candidates.push_back(id);
       auto rp = self->make_response_promise<void>();
@@ -774,11 +885,14 @@ index(index_actor::stateful_pointer<index_state> self, store_actor store,
             std::vector<uuid> midx_candidates) mutable {
             VAST_DEBUG("{} got initial candidates {} and from meta-index {}",
                        self, candidates, midx_candidates);
-            candidates.insert(candidates.end(), midx_candidates.begin(),
-                              midx_candidates.end());
-            std::sort(candidates.begin(), candidates.end());
-            candidates.erase(std::unique(candidates.begin(), candidates.end()),
-                             candidates.end());
+            // The active and unpersisted partitions hold the most recent
+            // events, so we keep them in front to schedule them first.
+            auto num_recent = candidates.size();
+            for (auto& candidate : midx_candidates)
+              if (std::find(candidates.begin(),
+                            candidates.begin() + num_recent, candidate)
+                  == candidates.begin() + num_recent)
+                candidates.push_back(candidate);
             if (candidates.empty()) {
               VAST_DEBUG("{} returns without result: no partitions qualify",
                          self);
@@ -17,7 +17,10 @@
 #include "vast/concept/printable/vast/type.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/ewah_arena.hpp"
 #include "vast/expression.hpp"
+#include "vast/fbs/partition.hpp"
+#include "vast/fbs/utils.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/accountant.hpp"
 #include "vast/system/instrumentation.hpp"
@@ -36,13 +39,28 @@ namespace vast::system {
 
 namespace {
 
+/// Serializes a value index into a `fbs::value_index::v0` flatbuffer. The
+/// blocks of all bitmaps are stored out of line, so that a passive partition
+/// can use them in place without deserializing them.
 vast::chunk_ptr chunkify(const value_index_ptr& idx) {
   std::vector<char> buf;
-  caf::binary_serializer sink{nullptr, buf};
-  auto error = sink(idx);
-  if (error)
-    return nullptr;
-  return chunk::make(std::move(buf));
+  ewah_arena arena;
+  {
+    auto guard = arena.activate();
+    caf::binary_serializer sink{nullptr, buf};
+    if (auto error = sink(idx))
+      return nullptr;
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  auto blocks = arena.blocks();
+  auto ewah_blocks = builder.CreateVector(blocks.data(), blocks.size());
+  auto data = builder.CreateVector(
+    reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
+  fbs::value_index::v0Builder vbuilder(builder);
+  vbuilder.add_data(data);
+  vbuilder.add_ewah_blocks(ewah_blocks);
+  builder.Finish(vbuilder.Finish());
+  return fbs::release(builder);
 }
 
 } // namespace
@@ -79,8 +97,9 @@ active_indexer(active_indexer_actor::stateful_pointer<indexer_state> self,
           if (self->state.has_skip_attribute)
             return;
           for (auto& column : columns)
-            for (size_t i = 0; i < column.size(); ++i)
-              self->state.idx->append(column[i], column.slice().offset() + i);
+            if (auto appended = self->state.idx->append(column); !appended)
+              VAST_WARN("{} failed to append column: {}", self,
+                        render(appended.error()));
         },
         [=](caf::unit_t&, const caf::error& err) {
           VAST_TRACE("indexer is closing stream");
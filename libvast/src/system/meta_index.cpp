@@ -25,7 +25,11 @@
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
 #include <type_traits>
+#include <utility>
 
 namespace vast::system {
 
@@ -36,12 +40,65 @@ size_t meta_index_state::memusage() const {
   return result;
 }
 
+namespace {
+
+// Inserts a value into a sorted vector unless it is already present.
+void insert_sorted(std::vector<uuid>& xs, const uuid& x) {
+  auto i = std::lower_bound(xs.begin(), xs.end(), x);
+  if (i == xs.end() || *i != x)
+    xs.insert(i, x);
+}
+
+// Removes a value from a sorted vector.
+void erase_sorted(std::vector<uuid>& xs, const uuid& x) {
+  auto i = std::lower_bound(xs.begin(), xs.end(), x);
+  if (i != xs.end() && *i == x)
+    xs.erase(i);
+}
+
+} // namespace
+
+void meta_index_state::index(const uuid& partition,
+                             const partition_synopsis& ps) {
+  for (const auto& [field, syn] : ps.field_synopses_) {
+    insert_sorted(layout_partitions[field.layout_name], partition);
+    insert_sorted(field_partitions[field], partition);
+    if (const auto* ts = dynamic_cast<const time_synopsis*>(syn.get()))
+      time_ranges[field].insert(ts->min(), ts->max(), partition);
+  }
+}
+
+void meta_index_state::unindex(const uuid& partition,
+                               const partition_synopsis& ps) {
+  auto erase_from = [&](auto& map, const auto& key) {
+    if (auto it = map.find(key); it != map.end()) {
+      erase_sorted(it->second, partition);
+      if (it->second.empty())
+        map.erase(it);
+    }
+  };
+  for (const auto& [field, syn] : ps.field_synopses_) {
+    erase_from(layout_partitions, field.layout_name);
+    erase_from(field_partitions, field);
+    if (auto it = time_ranges.find(field); it != time_ranges.end()) {
+      it->second.erase(partition);
+      if (it->second.empty())
+        time_ranges.erase(it);
+    }
+  }
+}
+
 void meta_index_state::erase(const uuid& partition) {
-  synopses.erase(partition);
+  if (auto it = synopses.find(partition); it != synopses.end()) {
+    unindex(partition, it->second);
+    synopses.erase(it);
+  }
 }
 
 void meta_index_state::merge(const uuid& partition, partition_synopsis&& ps) {
-  synopses.emplace(partition, std::move(ps));
+  auto [it, inserted] = synopses.emplace(partition, std::move(ps));
+  if (inserted)
+    index(partition, it->second);
 }
 
 void meta_index_state::create_from(std::map<uuid, partition_synopsis>&& ps) {
@@ -55,6 +112,12 @@ void meta_index_state::create_from(std::map<uuid, partition_synopsis>&& ps) {
               return lhs.first < rhs.first;
             });
   synopses = decltype(synopses)::make_unsafe(std::move(flat_data));
+  layout_partitions.clear();
+  field_partitions.clear();
+  time_ranges.clear();
+  // Iterating in partition order appends to the end of the sorted vectors.
+  for (const auto& [partition, synopsis] : synopses)
+    index(partition, synopsis);
 }
 
 partition_synopsis& meta_index_state::at(const uuid& partition) {
@@ -128,51 +191,123 @@ std::vector<uuid> meta_index_state::lookup(const expression& expr) const {
   return result;
 }
 
-std::vector<uuid> meta_index_state::lookup_impl(const expression& expr) const {
+namespace {
+
+// Translates a predicate on a time synopsis into the closed range that a
+// partition's [min, max] interval must overlap with to satisfy it. This
+// mirrors the semantics of `min_max_synopsis::lookup`.
+std::optional<std::pair<time, time>>
+time_range(relational_operator op, const data& rhs) {
+  const auto* x = caf::get_if<time>(&rhs);
+  if (!x)
+    return std::nullopt;
+  constexpr auto lowest = time::min();
+  constexpr auto highest = time::max();
+  constexpr auto epsilon = duration{1};
+  switch (op) {
+    default:
+      return std::nullopt;
+    case relational_operator::equal:
+      return std::pair{*x, *x};
+    case relational_operator::less:
+      // An empty range is represented by lo > hi.
+      if (*x == lowest)
+        return std::pair{highest, lowest};
+      return std::pair{lowest, *x - epsilon};
+    case relational_operator::less_equal:
+      return std::pair{lowest, *x};
+    case relational_operator::greater:
+      if (*x == highest)
+        return std::pair{highest, lowest};
+      return std::pair{*x + epsilon, highest};
+    case relational_operator::greater_equal:
+      return std::pair{*x, highest};
+  }
+}
+
+// Estimates how expensive and how unselective the lookup of an expression is.
+// Conjunctions evaluate their operands in ascending order of this rank, so
+// that the cheap and selective lookups shrink the candidate set that the
+// expensive ones have to probe.
+int rank(const expression& expr) {
+  auto f = detail::overload{
+    [](const predicate& x) {
+      if (caf::holds_alternative<meta_extractor>(x.lhs))
+        return 0;
+      if (const auto* d = caf::get_if<data>(&x.rhs)) {
+        if (time_range(x.op, *d))
+          return 1;
+        if (x.op == relational_operator::equal
+            || x.op == relational_operator::in)
+          return 2;
+      }
+      return 3;
+    },
+    [](const conjunction&) { return 4; },
+    [](const disjunction&) { return 5; },
+    // Negations always yield all partitions and should come last.
+    [](const negation&) { return 6; },
+    [](caf::none_t) { return 6; },
+  };
+  return caf::visit(f, expr);
+}
+
+} // namespace
+
+std::vector<uuid>
+meta_index_state::lookup_impl(const expression& expr,
+                              const std::vector<uuid>* candidates) const {
   VAST_ASSERT(!caf::holds_alternative<caf::none_t>(expr));
+  VAST_ASSERT(!candidates
+              || std::is_sorted(candidates->begin(), candidates->end()));
   // The partition UUIDs must be sorted, otherwise the invariants of the
   // inplace union and intersection algorithms are violated, leading to
   // wrong results. So all places where we return an assembled set must
-  // ensure the post-condition of returning a sorted list. We currently
-  // rely on `flat_map` already traversing them in the correct order, so
-  // no separate sorting step is required.
+  // ensure the post-condition of returning a sorted list. The secondary
+  // lookup structures store partition IDs in sorted order, but results
+  // assembled from multiple of them must be sorted explicitly.
   using result_type = std::vector<uuid>;
-  result_type memoized_partitions;
   auto all_partitions = [&] {
-    if (!memoized_partitions.empty() || synopses.empty())
-      return memoized_partitions;
-    memoized_partitions.reserve(synopses.size());
-    std::transform(synopses.begin(), synopses.end(),
-                   std::back_inserter(memoized_partitions),
+    if (candidates)
+      return *candidates;
+    result_type result;
+    result.reserve(synopses.size());
+    std::transform(synopses.begin(), synopses.end(), std::back_inserter(result),
                    [](auto& x) { return x.first; });
-    std::sort(memoized_partitions.begin(), memoized_partitions.end());
-    return memoized_partitions;
+    return result;
   };
   auto f = detail::overload{
     [&](const conjunction& x) -> result_type {
       VAST_ASSERT(!x.empty());
-      auto i = x.begin();
-      auto result = lookup_impl(*i);
-      if (!result.empty())
-        for (++i; i != x.end(); ++i) {
-          // TODO: A conjunction means that we can restrict the lookup to the
-          // remaining candidates. This could be achived by passing the `result`
-          // set to `lookup` along with the child expression.
-          auto xs = lookup_impl(*i);
-          if (xs.empty())
-            return xs; // short-circuit
-          detail::inplace_intersect(result, xs);
-          VAST_ASSERT(std::is_sorted(result.begin(), result.end()));
-        }
+      // Evaluate the most selective operands first and restrict the lookups
+      // of the remaining operands to the surviving candidates.
+      std::vector<const expression*> operands;
+      operands.reserve(x.size());
+      for (const auto& op : x)
+        operands.push_back(&op);
+      std::stable_sort(operands.begin(), operands.end(),
+                       [](const expression* lhs, const expression* rhs) {
+                         return rank(*lhs) < rank(*rhs);
+                       });
+      auto i = operands.begin();
+      auto result = lookup_impl(**i, candidates);
+      if (candidates)
+        detail::inplace_intersect(result, *candidates);
+      for (++i; i != operands.end() && !result.empty(); ++i) {
+        auto xs = lookup_impl(**i, &result);
+        if (xs.empty())
+          return xs; // short-circuit
+        detail::inplace_intersect(result, xs);
+        VAST_ASSERT(std::is_sorted(result.begin(), result.end()));
+      }
       return result;
     },
     [&](const disjunction& x) -> result_type {
       result_type result;
-      auto string_synopsis_memo = detail::stable_set<std::string>{};
       for (const auto& op : x) {
         // TODO: A disjunction means that we can restrict the lookup to the
         // set of partitions that are outside of the current result set.
-        auto xs = lookup_impl(op);
+        auto xs = lookup_impl(op, candidates);
         VAST_ASSERT(std::is_sorted(xs.begin(), xs.end()));
         if (xs.size() == synopses.size())
           return xs; // short-circuit
@@ -193,50 +328,79 @@ std::vector<uuid> meta_index_state::lookup_impl(const expression& expr) const {
       // Performs a lookup on all *matching* synopses with operator and
       // data from the predicate of the expression. The match function
       // uses a qualified_record_field to determine whether the synopsis should
-      // be queried.
+      // be queried. Only partitions that contain a matching field are probed,
+      // and time ranges are resolved using the interval tree of the field.
       auto search = [&](auto match) {
         VAST_ASSERT(caf::holds_alternative<data>(x.rhs));
         const auto& rhs = caf::get<data>(x.rhs);
+        auto range = time_range(x.op, rhs);
+        size_t probed = 0;
         result_type result;
-        for (const auto& [part_id, part_syn] : synopses) {
-          for (const auto& [field, syn] : part_syn.field_synopses_) {
-            if (match(field)) {
-              auto cleaned_type = vast::type{field.type}.attributes({});
-              // We rely on having a field -> nullptr mapping here for the
-              // fields that don't have their own synopsis.
-              if (syn) {
-                auto opt = syn->lookup(x.op, make_view(rhs));
-                if (!opt || *opt) {
-                  VAST_TRACE("{} selects {} at predicate {}",
-                             detail::pretty_type_name(this), part_id, x);
-                  result.push_back(part_id);
-                  break;
-                }
-                // The field has no dedicated synopsis. Check if there is one
-                // for the type in general.
-              } else if (auto it = part_syn.type_synopses_.find(cleaned_type);
-                         it != part_syn.type_synopses_.end() && it->second) {
-                auto opt = it->second->lookup(x.op, make_view(rhs));
-                if (!opt || *opt) {
-                  VAST_TRACE("{} selects {} at predicate {}",
-                             detail::pretty_type_name(this), part_id, x);
-                  result.push_back(part_id);
-                  break;
-                }
-              } else {
-                // The meta index couldn't rule out this partition, so we have
-                // to include it in the result set.
-                result.push_back(part_id);
-                break;
-              }
+        auto probe = [&](const qualified_record_field& field,
+                         const uuid& part_id) {
+          ++probed;
+          auto part_syn = synopses.find(part_id);
+          VAST_ASSERT(part_syn != synopses.end());
+          auto it = part_syn->second.field_synopses_.find(field);
+          VAST_ASSERT(it != part_syn->second.field_synopses_.end());
+          // We rely on having a field -> nullptr mapping here for the
+          // fields that don't have their own synopsis.
+          const auto* syn = it->second.get();
+          if (!syn) {
+            // The field has no dedicated synopsis. Check if there is one
+            // for the type in general.
+            auto cleaned_type = vast::type{field.type}.attributes({});
+            auto& type_synopses = part_syn->second.type_synopses_;
+            if (auto jt = type_synopses.find(cleaned_type);
+                jt != type_synopses.end())
+              syn = jt->second.get();
+          }
+          // The meta index couldn't rule out this partition if there is no
+          // applicable synopsis, so we have to include it in the result set.
+          auto opt = syn ? syn->lookup(x.op, make_view(rhs))
+                         : std::optional<bool>{};
+          if (!opt || *opt) {
+            VAST_TRACE("{} selects {} at predicate {}",
+                       detail::pretty_type_name(this), part_id, x);
+            result.push_back(part_id);
+          }
+        };
+        for (const auto& [field, partitions] : field_partitions) {
+          if (!match(field))
+            continue;
+          // Time synopses resolve range queries via the interval tree, as
+          // long as every partition has a time synopsis for the field.
+          if (range) {
+            if (auto it = time_ranges.find(field);
+                it != time_ranges.end()
+                && it->second.size() == partitions.size()) {
+              it->second.overlapping(range->first, range->second,
+                                     [&](const uuid& part_id) {
+                                       result.push_back(part_id);
+                                     });
+              continue;
             }
           }
+          // Iterate over the smaller one of the two sorted lists, and look up
+          // the elements in the other one.
+          if (candidates && candidates->size() < partitions.size()) {
+            for (const auto& part_id : *candidates)
+              if (std::binary_search(partitions.begin(), partitions.end(),
+                                     part_id))
+                probe(field, part_id);
+          } else {
+            for (const auto& part_id : partitions)
+              if (!candidates
+                  || std::binary_search(candidates->begin(), candidates->end(),
+                                        part_id))
+                probe(field, part_id);
+          }
         }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
         VAST_DEBUG(
-          "{} checked {} partitions for predicate {} and got {} results",
-          detail::pretty_type_name(this), synopses.size(), x, result.size());
-        // Some calling paths require the result to be sorted.
-        VAST_ASSERT(std::is_sorted(result.begin(), result.end()));
+          "{} probed {} synopses for predicate {} and got {} results",
+          detail::pretty_type_name(this), probed, x, result.size());
         return result;
       };
       auto extract_expr = detail::overload{
@@ -245,46 +409,37 @@ std::vector<uuid> meta_index_state::lookup_impl(const expression& expr) const {
             // We don't have to look into the synopses for type queries, just
             // at the layout names.
             result_type result;
-            for (const auto& [part_id, part_syn] : synopses) {
-              for (const auto& pair : part_syn.field_synopses_) {
-                // TODO: provide an overload for view of evaluate() so that
-                // we can use string_view here. Fortunately type names are
-                // short, so we're probably not hitting the allocator due to
-                // SSO.
-                auto type_name = data{pair.first.layout_name};
-                if (evaluate(type_name, x.op, d)) {
-                  result.push_back(part_id);
-                  break;
-                }
-              }
+            for (const auto& [layout_name, partitions] : layout_partitions) {
+              // TODO: provide an overload for view of evaluate() so that
+              // we can use string_view here. Fortunately type names are
+              // short, so we're probably not hitting the allocator due to
+              // SSO.
+              if (evaluate(data{layout_name}, x.op, d))
+                detail::inplace_unify(result, partitions);
             }
             VAST_ASSERT(std::is_sorted(result.begin(), result.end()));
             return result;
           } else if (lhs.kind == meta_extractor::field) {
-            // We don't have to look into the synopses for type queries, just
-            // at the layout names.
+            // We don't have to look into the synopses for field queries, just
+            // at the field names.
             result_type result;
             const auto* s = caf::get_if<std::string>(&d);
             if (!s) {
               VAST_WARN("#field meta queries only support string "
                         "comparisons");
             } else {
-              for (const auto& synopsis : synopses) {
-                // Compare the desired field name with each field in the
-                // partition.
-                auto matching = [&] {
-                  for (const auto& pair : synopsis.second.field_synopses_) {
-                    auto fqn = pair.first.fqn();
-                    if (detail::ends_with(fqn, *s))
-                      return true;
-                  }
-                  return false;
-                }();
-                // Only insert the partition if both sides are equal, i.e. the
-                // operator is "positive" and matching is true, or both are
-                // negative.
-                if (!is_negated(x.op) == matching)
-                  result.push_back(synopsis.first);
+              for (const auto& [field, partitions] : field_partitions)
+                if (detail::ends_with(field.fqn(), *s))
+                  detail::inplace_unify(result, partitions);
+              // Only include the partitions if both sides are equal, i.e. the
+              // operator is "positive" and matching is true, or both are
+              // negative.
+              if (is_negated(x.op)) {
+                auto matching = std::move(result);
+                result.clear();
+                auto all = all_partitions();
+                std::set_difference(all.begin(), all.end(), matching.begin(),
+                                    matching.end(), std::back_inserter(result));
               }
             }
             VAST_ASSERT(std::is_sorted(result.begin(), result.end()));
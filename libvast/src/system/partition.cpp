@@ -20,7 +20,9 @@
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/notifying_stream_manager.hpp"
+#include "vast/detail/overload.hpp"
 #include "vast/detail/settings.hpp"
+#include "vast/ewah_arena.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/fbs/partition.hpp"
 #include "vast/fbs/utils.hpp"
@@ -28,7 +30,9 @@
 #include "vast/ids.hpp"
 #include "vast/logger.hpp"
 #include "vast/qualified_record_field.hpp"
+#include "vast/si_literals.hpp"
 #include "vast/synopsis.hpp"
+#include "vast/system/evaluator.hpp"
 #include "vast/system/indexer.hpp"
 #include "vast/system/shutdown.hpp"
 #include "vast/system/status_verbosity.hpp"
@@ -38,6 +42,7 @@
 #include "vast/time.hpp"
 #include "vast/type.hpp"
 #include "vast/value_index.hpp"
+#include "vast/view.hpp"
 
 #include <caf/attach_continuous_stream_stage.hpp>
 #include <caf/broadcast_downstream_manager.hpp>
@@ -47,8 +52,10 @@
 #include <flatbuffers/base.h> // FLATBUFFERS_MAX_BUFFER_SIZE
 #include <flatbuffers/flatbuffers.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <memory>
+#include <optional>
 
 namespace vast::system {
 
@@ -72,6 +79,56 @@ void active_partition_state::notify_flush_listeners() {
   flush_listeners.clear();
 }
 
+void active_partition_state::handle_input_closed() {
+  if (std::exchange(inbound_closed, true))
+    return;
+  VAST_DEBUG("{} received all table slices", self);
+  // Persisting waits for the stream to close, so that no table slice is lost.
+  if (persistence_promise.pending())
+    self->send(self, atom::internal_v, atom::persist_v, atom::resume_v);
+}
+
+namespace {
+
+/// Estimates the size of the partition flatbuffer, so that the builder can
+/// allocate its buffer once instead of repeatedly growing and copying it.
+size_t packed_size_hint(const active_partition_state& x) {
+  using namespace binary_byte_literals;
+  // Leave some headroom for the layout, the type ids, and the vtables.
+  auto result = size_t{64_KiB};
+  for ([[maybe_unused]] const auto& [id, chunk] : x.chunks)
+    result += chunk->size();
+  if (x.synopsis)
+    result += x.synopsis->memusage();
+  return std::min(result, size_t{FLATBUFFERS_MAX_BUFFER_SIZE});
+}
+
+/// Deserializes the value index at a certain position of a passive partition.
+caf::expected<value_index_ptr>
+unpack_value_index(const passive_partition_state& state, size_t position) {
+  auto qualified_index = state.flatbuffer->indexes()->Get(position);
+  auto index = qualified_index->index();
+  auto data = index->data();
+  value_index_ptr result;
+  auto error = [&] {
+    // Partitions with native bitmap blocks let the bitmaps of the value
+    // index reference the memory-mapped partition instead of copying them.
+    if (auto blocks = index->ewah_blocks()) {
+      auto arena = ewah_arena{
+        state.partition_chunk,
+        span<const uint64_t>{blocks->data(), blocks->size()}};
+      auto guard = arena.activate();
+      return fbs::deserialize_bytes(data, result);
+    }
+    return fbs::deserialize_bytes(data, result);
+  }();
+  if (error)
+    return error;
+  return result;
+}
+
+} // namespace
+
 /// Gets the INDEXER at a certain position.
 indexer_actor passive_partition_state::indexer_at(size_t position) const {
   VAST_ASSERT(position < indexers.size());
@@ -79,21 +136,38 @@ indexer_actor passive_partition_state::indexer_at(size_t position) const {
   // Deserialize the value index and spawn a passive_indexer lazily when it is
   // requested for the first time.
   if (!indexer) {
-    auto qualified_index = flatbuffer->indexes()->Get(position);
-    auto index = qualified_index->index();
-    auto data = index->data();
-    value_index_ptr state_ptr;
-    if (auto error = fbs::deserialize_bytes(data, state_ptr)) {
+    auto state_ptr = unpack_value_index(*this, position);
+    if (!state_ptr) {
       VAST_ERROR("{} failed to deserialize indexer at {} with error: "
                  "{}",
-                 self, position, render(error));
+                 self, position, render(state_ptr.error()));
       return {};
     }
-    indexer = self->spawn(passive_indexer, id, std::move(state_ptr));
+    indexer = self->spawn(passive_indexer, id, std::move(*state_ptr));
   }
   return indexer;
 }
 
+/// Gets the value index at a certain position.
+const value_index*
+passive_partition_state::value_index_at(size_t position) const {
+  VAST_ASSERT(position < value_indexes.size());
+  auto& idx = value_indexes[position];
+  // Deserialize the value index lazily when it is requested for the first
+  // time.
+  if (!idx) {
+    auto result = unpack_value_index(*this, position);
+    if (!result) {
+      VAST_ERROR("{} failed to deserialize value index at {} with error: "
+                 "{}",
+                 self, position, render(result.error()));
+      return nullptr;
+    }
+    idx = std::move(*result);
+  }
+  return idx.get();
+}
+
 namespace {
 
 // The functions in this namespace take PartitionState as template argument
@@ -117,22 +191,21 @@ fetch_indexer(const PartitionState& state, const data_extractor& dx,
   return {};
 }
 
-/// Retrieves an INDEXER for a predicate with a data extractor.
-/// @param dx The extractor.
-/// @param op The operator (only used to precompute ids for type queries.
+/// Computes the IDs that satisfy a predicate with a meta extractor.
+/// @param ex The extractor.
+/// @param op The operator of the predicate.
 /// @param x The literal side of the predicate.
+/// @returns The matching IDs, or `std::nullopt` if the predicate is
+///          unsupported.
 /// @relates active_partition_state
 /// @relates passive_partition_state
 template <typename PartitionState>
-indexer_actor
-fetch_indexer(const PartitionState& state, const meta_extractor& ex,
-              relational_operator op, const data& x) {
-  VAST_TRACE_SCOPE("{} {} {}", VAST_ARG(ex), VAST_ARG(op), VAST_ARG(x));
+std::optional<ids> meta_ids(const PartitionState& state,
+                            const meta_extractor& ex, relational_operator op,
+                            const data& x) {
   ids row_ids;
   if (ex.kind == meta_extractor::type) {
     // We know the answer immediately: all IDs that are part of the table.
-    // However, we still have to "lift" this result into an actor for the
-    // EVALUATOR.
     for (auto& [name, ids] : state.type_ids)
       if (evaluate(name, op, x))
         row_ids |= ids;
@@ -142,7 +215,7 @@ fetch_indexer(const PartitionState& state, const meta_extractor& ex,
       VAST_WARN("{} #field meta queries only support string "
                 "comparisons",
                 state.self);
-      return {};
+      return std::nullopt;
     }
     auto neg = is_negated(op);
     for (const auto& field : record_type::each{state.combined_layout}) {
@@ -166,18 +239,38 @@ fetch_indexer(const PartitionState& state, const meta_extractor& ex,
     }
   } else {
     VAST_WARN("{} got unsupported attribute: {}", state.self, ex.kind);
-    return {};
+    return std::nullopt;
   }
+  return row_ids;
+}
+
+/// Retrieves an INDEXER for a predicate with a data extractor.
+/// @param dx The extractor.
+/// @param op The operator (only used to precompute ids for type queries.
+/// @param x The literal side of the predicate.
+/// @relates active_partition_state
+/// @relates passive_partition_state
+template <typename PartitionState>
+indexer_actor
+fetch_indexer(const PartitionState& state, const meta_extractor& ex,
+              relational_operator op, const data& x) {
+  VAST_TRACE_SCOPE("{} {} {}", VAST_ARG(ex), VAST_ARG(op), VAST_ARG(x));
+  auto row_ids = meta_ids(state, ex, op, x);
+  if (!row_ids)
+    return {};
+  // We know the answer immediately, but we still have to "lift" this result
+  // into an actor for the EVALUATOR.
   // TODO: Spawning a one-shot actor is quite expensive. Maybe the
   //       partition could instead maintain this actor lazily.
-  return state.self->spawn([row_ids]() -> indexer_actor::behavior_type {
-    return {
-      [=](const curried_predicate&) { return row_ids; },
-      [](atom::shutdown) {
-        VAST_DEBUG("one-shot indexer received shutdown request");
-      },
-    };
-  });
+  return state.self->spawn(
+    [row_ids = std::move(*row_ids)]() -> indexer_actor::behavior_type {
+      return {
+        [=](const curried_predicate&) { return row_ids; },
+        [](atom::shutdown) {
+          VAST_DEBUG("one-shot indexer received shutdown request");
+        },
+      };
+    });
 }
 
 /// Returns all INDEXERs that are involved in evaluating the expression.
@@ -217,6 +310,57 @@ evaluate(const PartitionState& state, const expression& expr) {
   return result;
 }
 
+/// Evaluates an expression synchronously against the value indexes of a
+/// passive partition, without involving EVALUATOR and INDEXER actors.
+/// @returns The IDs of all events that may satisfy *expr*, or `std::nullopt`
+///          if no predicate of *expr* applies to the partition.
+/// @relates passive_partition_state
+std::optional<ids>
+evaluate_locally(const passive_partition_state& state, const expression& expr) {
+  evaluator_state::predicate_hits_map hits;
+  for (auto& [position, predicate] : resolve(expr, state.combined_layout)) {
+    // Structured bindings cannot be captured by the lambdas below.
+    const auto& pred = predicate;
+    auto v = detail::overload{
+      [&](const meta_extractor& ex, const data& x) -> std::optional<ids> {
+        return meta_ids(state, ex, pred.op, x);
+      },
+      [&](const data_extractor& dx, const data& x) -> std::optional<ids> {
+        if (dx.offset.empty())
+          return std::nullopt;
+        auto index = state.combined_layout.flat_index_at(dx.offset);
+        if (!index) {
+          VAST_WARN("{} got invalid offset for the combined layout {}",
+                    state.self, state.combined_layout);
+          return std::nullopt;
+        }
+        const auto* idx = state.value_index_at(*index);
+        if (!idx)
+          return std::nullopt;
+        auto rep = to_internal(idx->type(), make_view(x));
+        auto result = idx->lookup(pred.op, rep);
+        if (!result) {
+          VAST_WARN("{} failed to look up predicate {}: {}", state.self, pred,
+                    render(result.error()));
+          return ids{};
+        }
+        return std::move(*result);
+      },
+      [](const auto&, const auto&) -> std::optional<ids> {
+        return std::nullopt;
+      },
+    };
+    if (auto result = caf::visit(v, pred.lhs, pred.rhs)) {
+      auto& [count, accumulated_hits] = hits[position];
+      ++count;
+      accumulated_hits |= *result;
+    }
+  }
+  if (hits.empty())
+    return std::nullopt;
+  return evaluate_hits(expr, hits);
+}
+
 } // namespace
 
 bool partition_selector::operator()(const qualified_record_field& filter,
@@ -239,11 +383,25 @@ pack(flatbuffers::FlatBufferBuilder& builder, const active_partition_state& x) {
       return caf::make_error(ec::logic_error, "no chunk for for actor id "
                                                 + to_string(actor_id));
     auto& chunk = chunk_it->second;
-    auto data = builder.CreateVector(
-      reinterpret_cast<const uint8_t*>(chunk->data()), chunk->size());
+    // The INDEXER delivers its value index as a standalone flatbuffer.
+    const auto* chunk_data = reinterpret_cast<const uint8_t*>(chunk->data());
+    auto verifier = flatbuffers::Verifier{chunk_data, chunk->size()};
+    const auto* index
+      = verifier.VerifyBuffer<fbs::value_index::v0>(nullptr)
+          ? flatbuffers::GetRoot<fbs::value_index::v0>(chunk_data)
+          : nullptr;
+    if (!index || !index->data())
+      return caf::make_error(ec::format_error, "invalid value index for field "
+                                                 + qf.field_name);
+    auto data
+      = builder.CreateVector(index->data()->data(), index->data()->size());
+    auto ewah_blocks = flatbuffers::Offset<flatbuffers::Vector<uint64_t>>{};
+    if (auto blocks = index->ewah_blocks())
+      ewah_blocks = builder.CreateVector(blocks->data(), blocks->size());
     auto fieldname = builder.CreateString(qf.field_name);
     fbs::value_index::v0Builder vbuilder(builder);
     vbuilder.add_data(data);
+    vbuilder.add_ewah_blocks(ewah_blocks);
     auto vindex = vbuilder.Finish();
     fbs::qualified_value_index::v0Builder qbuilder(builder);
     qbuilder.add_field_name(fieldname);
@@ -340,6 +498,7 @@ unpack(const fbs::partition::v0& partition, passive_partition_state& state) {
   // vector must be the same as in `combined_layout`. The actual indexers are
   // deserialized and spawned lazily on demand.
   state.indexers.resize(indexes->size());
+  state.value_indexes.resize(indexes->size());
   VAST_DEBUG("{} found {} indexers for partition {}", state.name,
              indexes->size(), state.id);
   auto type_ids = partition.type_ids();
@@ -502,23 +661,18 @@ active_partition_actor::behavior_type active_partition(
       self->state.persisted_indexers = 0;
       self->state.persistence_promise
         = self->make_response_promise<std::shared_ptr<partition_synopsis>>();
-      self->send(self, atom::internal_v, atom::persist_v, atom::resume_v);
+      // Otherwise, closing the stream resumes the request.
+      if (self->state.inbound_closed)
+        self->send(self, atom::internal_v, atom::persist_v, atom::resume_v);
       return self->state.persistence_promise;
     },
     [self](atom::internal, atom::persist, atom::resume) {
       VAST_TRACE("{} resumes persist atom {}", self,
                  self->state.indexers.size());
-      if (self->state.streaming_initiated
-          && self->state.stage->inbound_paths().empty()) {
-        self->state.stage->out().fan_out_flush();
-        self->state.stage->out().close();
-        self->state.stage->out().force_emit_batches();
-      } else {
-        using namespace std::chrono_literals;
-        self->delayed_send(self, 50ms, atom::internal_v, atom::persist_v,
-                           atom::resume_v);
-        return;
-      }
+      VAST_ASSERT(self->state.inbound_closed);
+      self->state.stage->out().fan_out_flush();
+      self->state.stage->out().close();
+      self->state.stage->out().force_emit_batches();
       if (self->state.indexers.empty()) {
         self->state.persistence_promise.deliver(
           caf::make_error(ec::logic_error, "partition has no indexers"));
@@ -556,8 +710,11 @@ active_partition_actor::behavior_type active_partition(
               // Shrink synopses for addr fields to optimal size.
               self->state.synopsis->shrink();
               // Create the partition flatbuffer.
-              flatbuffers::FlatBufferBuilder builder;
+              flatbuffers::FlatBufferBuilder builder{
+                packed_size_hint(self->state)};
               auto partition = pack(builder, self->state);
+              // The flatbuffer now holds a copy of every value index.
+              self->state.chunks.clear();
               if (!partition) {
                 VAST_ERROR("{} failed to serialize {} with error: {}", self,
                            self->state.name, render(partition.error()));
@@ -706,9 +863,10 @@ active_partition_actor::behavior_type active_partition(
 partition_actor::behavior_type passive_partition(
   partition_actor::stateful_pointer<passive_partition_state> self, uuid id,
   filesystem_actor filesystem, const std::filesystem::path& path,
-  store_actor store) {
+  store_actor store, bool local_evaluation) {
   self->state.self = self;
   self->state.store = std::move(store);
+  self->state.local_evaluation = local_evaluation;
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     VAST_DEBUG("{} received EXIT from {} with reason: {}", self, msg.source,
                msg.reason);
@@ -821,6 +979,19 @@ partition_actor::behavior_type passive_partition(
       if (self->state.indexers.empty())
         return caf::make_error(ec::system_error, "can not handle query because "
                                                  "shutdown was requested");
+      if (self->state.local_evaluation) {
+        auto hits = evaluate_locally(self->state, query.expr);
+        if (!hits)
+          return atom::done_v;
+        auto* count = caf::get_if<query::count>(&query.cmd);
+        if (count && count->mode == query::count::estimate) {
+          self->send(count->sink, rank(*hits));
+          return atom::done_v;
+        }
+        auto rp = self->make_response_promise<atom::done>();
+        rp.delegate(self->state.store, std::move(query), std::move(*hits));
+        return rp;
+      }
       auto triples = evaluate(self->state, query.expr);
       if (triples.empty())
         return atom::done_v;
@@ -848,7 +1019,7 @@ partition_actor::behavior_type passive_partition(
       caf::put(result, "size", self->state.partition_chunk->size());
       size_t mem_indexers = 0;
       for (size_t i = 0; i < self->state.indexers.size(); ++i) {
-        if (self->state.indexers[i])
+        if (self->state.indexers[i] || self->state.value_indexes[i])
           mem_indexers += sizeof(indexer_state)
                           + self->state.flatbuffer->indexes()
                               ->Get(i)
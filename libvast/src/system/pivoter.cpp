@@ -13,6 +13,7 @@
 #include "vast/command.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
+#include "vast/defaults.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/expression.hpp"
 #include "vast/logger.hpp"
@@ -76,6 +77,45 @@ pivoter_state::pivoter_state(caf::event_based_actor*) {
   // nop
 }
 
+void pivoter_state::query_values(const std::string& field, list values) {
+  auto num_values = values.size();
+  auto expr
+    = conjunction{predicate{meta_extractor{meta_extractor::type},
+                            relational_operator::equal, data{target}},
+                  predicate{field_extractor{field}, relational_operator::in,
+                            data{std::move(values)}}};
+  // TODO(ch9411): Drop the conversion to a string when node actors can
+  //               be spawned without going through an invocation.
+  auto query = to_string(expr);
+  VAST_DEBUG("{} queries for {} {}", self, num_values, field);
+  VAST_TRACE_SCOPE("{} spawns new exporter with query {}", self, query);
+  auto exporter_options = caf::settings{};
+  caf::put(exporter_options, "vast.export.disable-taxonomies", true);
+  auto exporter_invocation
+    = invocation{std::move(exporter_options), "spawn exporter", {query}};
+  ++running_exporters;
+  self->request(node, caf::infinite, atom::spawn_v, exporter_invocation)
+    .then(
+      [self = self](caf::actor handle) {
+        auto exporter = caf::actor_cast<exporter_actor>(handle);
+        VAST_DEBUG("{} registers exporter {}", self, exporter);
+        self->monitor(exporter);
+        self->send(exporter, atom::sink_v, self->state.sink);
+        self->send(exporter, atom::run_v);
+      },
+      [self = self](caf::error error) {
+        --self->state.running_exporters;
+        VAST_ERROR("{} failed to spawn exporter: {}", self, render(error));
+      });
+}
+
+void pivoter_state::flush() {
+  for (auto& [field, values] : pending)
+    if (!values.empty())
+      query_values(field, std::move(values));
+  pending.clear();
+}
+
 caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self, node_actor node,
                       std::string target, expression expr) {
   auto& st = self->state;
@@ -106,7 +146,7 @@ caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self, node_actor node,
                  st.target);
       auto column = table_slice_column::make(slice, pivot_field->name);
       VAST_ASSERT(column);
-      auto xs = list{};
+      auto& xs = st.pending[pivot_field->name];
       for (size_t i = 0; i < column->size(); ++i) {
         auto data = materialize((*column)[i]);
         auto x = caf::get_if<std::string>(&data);
@@ -119,42 +159,25 @@ caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self, node_actor node,
         xs.push_back(*x);
         st.requested_ids.insert(*x);
       }
-      if (xs.empty()) {
-        VAST_DEBUG("{} already queried for all {}", self, pivot_field->name);
-        return;
+      if (xs.size() >= defaults::pivot::max_values_per_query) {
+        st.query_values(pivot_field->name, std::move(xs));
+        xs.clear();
+      }
+      // Query for the pending values once the mailbox holds no more slices
+      // that arrived together with this one, so that pivots never wait for
+      // the original query to complete.
+      if (!st.flush_scheduled) {
+        st.flush_scheduled = true;
+        self->send(self, atom::flush_v);
       }
-      auto expr
-        = conjunction{predicate{meta_extractor{meta_extractor::type},
-                                relational_operator::equal, data{st.target}},
-                      predicate{field_extractor{pivot_field->name},
-                                relational_operator::in, data{xs}}};
-      // TODO(ch9411): Drop the conversion to a string when node actors can
-      //               be spawned without going through an invocation.
-      auto query = to_string(expr);
-      VAST_DEBUG("{} queries for {} {}", self, xs.size(), pivot_field->name);
-      VAST_TRACE_SCOPE("{} spawns new exporter with query {}", self, query);
-      auto exporter_options = caf::settings{};
-      caf::put(exporter_options, "vast.export.disable-taxonomies", true);
-      auto exporter_invocation
-        = invocation{std::move(exporter_options), "spawn exporter", {query}};
-      ++self->state.running_exporters;
-      self->request(st.node, caf::infinite, atom::spawn_v, exporter_invocation)
-        .then(
-          [=](caf::actor handle) {
-            auto exporter = caf::actor_cast<exporter_actor>(handle);
-            VAST_DEBUG("{} registers exporter {}", self, exporter);
-            self->monitor(exporter);
-            self->send(exporter, atom::sink_v, self->state.sink);
-            self->send(exporter, atom::run_v);
-          },
-          [=](caf::error error) {
-            --self->state.running_exporters;
-            VAST_ERROR("{} failed to spawn exporter: {}", self, render(error));
-          });
-      ;
+    },
+    [=](atom::flush) {
+      self->state.flush_scheduled = false;
+      self->state.flush();
     },
     [=](std::string name, query_status) {
       VAST_DEBUG("{} received final status from {}", self, name);
+      self->state.flush();
       self->state.initial_query_completed = true;
       quit_if_done();
     },
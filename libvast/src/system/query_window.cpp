@@ -0,0 +1,55 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/system/query_window.hpp"
+
+#include "vast/detail/assert.hpp"
+
+#include <algorithm>
+
+namespace vast::system {
+
+query_window::query_window(size_t initial, size_t max) noexcept
+  : size_{std::min(initial, max)}, max_{max} {
+  VAST_ASSERT(initial > 0);
+  VAST_ASSERT(max > 0);
+}
+
+size_t query_window::size() const noexcept {
+  return size_;
+}
+
+duration query_window::partition_latency() const noexcept {
+  return partition_latency_;
+}
+
+void query_window::complete(size_t partitions, duration latency,
+                            bool backpressure) noexcept {
+  if (partitions == 0)
+    return;
+  auto per_partition = latency / static_cast<duration::rep>(partitions);
+  // The partitions of a batch are evaluated concurrently. While there are
+  // idle workers, a larger batch takes about as long as a smaller one, so the
+  // latency per partition drops. Once the workers are saturated, the batch
+  // latency grows with the batch size and the per-partition latency stalls.
+  if (backpressure) {
+    // Evaluating more partitions only piles up more results.
+    size_ = std::max(size_t{1}, size_ / 2);
+  } else if (partition_latency_ == duration::zero()
+             || per_partition < partition_latency_ * 7 / 8) {
+    size_ = std::min(max_, size_ * 2);
+  } else if (per_partition > partition_latency_ * 5 / 4) {
+    size_ = std::max(size_t{1}, size_ - size_ / 4);
+  } else {
+    // Keep probing carefully for spare capacity.
+    size_ = std::min(max_, size_ + 1);
+  }
+  partition_latency_ = per_partition;
+}
+
+} // namespace vast::system
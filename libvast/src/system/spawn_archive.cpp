@@ -8,6 +8,7 @@
 
 #include "vast/system/spawn_archive.hpp"
 
+#include "vast/compression.hpp"
 #include "vast/defaults.hpp"
 #include "vast/error.hpp"
 #include "vast/logger.hpp"
@@ -25,6 +26,8 @@
 #include <caf/settings.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <algorithm>
+
 using namespace vast::binary_byte_literals;
 
 namespace vast::system {
@@ -39,8 +42,20 @@ spawn_archive(node_actor::stateful_pointer<node_state> self,
   auto max_segment_size
     = 1_MiB
       * get_or(args.inv.options, "vast.max-segment-size", sd::max_segment_size);
+  auto compression_name = get_or(args.inv.options, "vast.segment-compression",
+                                 sd::segment_compression);
+  auto compression = parse_compression(compression_name);
+  if (!compression)
+    return compression.error();
+  auto compression_level = get_or(args.inv.options,
+                                  "vast.segment-compression-level",
+                                  sd::segment_compression_level);
+  auto num_workers = std::max(
+    get_or(args.inv.options, "vast.archive-workers", sd::archive_workers),
+    size_t{1});
   auto handle
-    = self->spawn(archive, args.dir / args.label, segments, max_segment_size);
+    = self->spawn(archive, args.dir / args.label, segments, max_segment_size,
+                  *compression, compression_level, num_workers);
   VAST_VERBOSE("{} spawned the archive", self);
   if (auto [accountant] = self->state.registry.find<accountant_actor>();
       accountant)
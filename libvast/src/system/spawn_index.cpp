@@ -17,6 +17,7 @@
 
 #include <caf/typed_event_based_actor.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <string_view>
 
@@ -47,7 +48,11 @@ spawn_index(node_actor::stateful_pointer<node_state> self,
     opt("vast.max-taste-partitions", sd::taste_partitions),
     opt("vast.max-queries", sd::num_query_supervisors),
     std::filesystem::path{opt("vast.meta-index-dir", indexdir.string())},
-    opt("vast.meta-index-fp-rate", sd::string_synopsis_fp_rate));
+    opt("vast.meta-index-fp-rate", sd::string_synopsis_fp_rate),
+    opt("vast.meta-index-blocked-bloom-filters",
+        sd::meta_index_blocked_bloom_filters),
+    opt("vast.partition-local-evaluation", sd::partition_local_evaluation),
+    std::max(opt("vast.active-partitions", sd::active_partitions), size_t{1}));
   VAST_VERBOSE("{} spawned the index", self);
   if (accountant)
     self->send(handle, caf::actor_cast<accountant_actor>(accountant));
@@ -327,6 +327,23 @@ void table_slice::append_column_to_index(table_slice::size_type column,
   return visit(f, as_flatbuffer(chunk_));
 }
 
+ids table_slice::evaluate_column(table_slice::size_type column, const type& t,
+                                 relational_operator op,
+                                 const data& rhs) const {
+  if (const auto* alias = caf::get_if<alias_type>(&t))
+    return evaluate_column(column, alias->value_type, op, rhs);
+  VAST_ASSERT(column < columns());
+  auto f = detail::overload{
+    [&]() noexcept -> ids {
+      die("cannot evaluate column of invalid table slice");
+    },
+    [&](const auto& encoded) noexcept {
+      return state(encoded, state_)->evaluate_column(column, t, op, rhs);
+    },
+  };
+  return visit(f, as_flatbuffer(chunk_));
+}
+
 data_view table_slice::at(table_slice::size_type row,
                           table_slice::size_type column) const {
   VAST_ASSERT(row < rows());
@@ -571,63 +588,77 @@ uint64_t rows(const std::vector<table_slice>& slices) {
 
 namespace {
 
-struct row_evaluator {
-  row_evaluator(const table_slice& slice, size_t row)
-    : slice_{slice}, row_{row} {
+/// Evaluates an expression over a table slice column by column. Every
+/// predicate resolves its column once and checks all rows in a single pass,
+/// yielding one bitmap per predicate with one bit per row. The connectives
+/// combine these bitmaps with bitwise operations.
+class column_evaluator {
+public:
+  explicit column_evaluator(const table_slice& slice) : slice_{slice} {
     // nop
   }
 
-  template <class T>
-  bool operator()(const data& d, const T& x) {
-    return (*this)(x, d);
+  ids operator()(caf::none_t) {
+    return constant(false);
   }
 
-  template <class T, class U>
-  bool operator()(const T&, const U&) {
-    return false;
+  ids operator()(const conjunction& c) {
+    auto result = constant(true);
+    for (const auto& op : c) {
+      // No need to evaluate the remaining operands if no row qualifies.
+      if (!any<1>(result))
+        break;
+      result &= caf::visit(*this, op);
+    }
+    return result;
   }
 
-  bool operator()(caf::none_t) {
-    return false;
+  ids operator()(const disjunction& d) {
+    auto result = constant(false);
+    for (const auto& op : d) {
+      // No need to evaluate the remaining operands if all rows qualify.
+      if (all<1>(result))
+        break;
+      result |= caf::visit(*this, op);
+    }
+    return result;
   }
 
-  bool operator()(const conjunction& c) {
-    return std::all_of(c.begin(), c.end(),
-                       [&](const auto& op) { return caf::visit(*this, op); });
+  ids operator()(const negation& n) {
+    auto result = caf::visit(*this, n.expr());
+    result.flip();
+    return result;
   }
 
-  bool operator()(const disjunction& d) {
-    return std::any_of(d.begin(), d.end(),
-                       [&](const auto& op) { return caf::visit(*this, op); });
+  ids operator()(const predicate& p) {
+    op_ = p.op;
+    return caf::visit(*this, p.lhs, p.rhs);
   }
 
-  bool operator()(const negation& n) {
-    return !caf::visit(*this, n.expr());
+  template <class T>
+  ids operator()(const data& d, const T& x) {
+    return (*this)(x, d);
   }
 
-  bool operator()(const predicate& p) {
-    op_ = p.op;
-    return caf::visit(*this, p.lhs, p.rhs);
+  template <class T, class U>
+  ids operator()(const T&, const U&) {
+    return constant(false);
   }
 
-  bool operator()(const meta_extractor& e, const data& d) {
-    // TODO: Transform this AST node into a constant-time lookup node (e.g.,
-    // data_extractor). It's not necessary to iterate over the schema for
-    // every row; this should happen upfront.
-    auto&& layout = slice_.layout();
-    // TODO: type and field queries don't produce false positives in the
-    // partition. Is there actually any reason to do the check here?
+  ids operator()(const meta_extractor& e, const data& d) {
+    // Meta extractors do not depend on the values in the slice, so we
+    // evaluate them once for all rows.
+    const auto& layout = slice_.layout();
     if (e.kind == meta_extractor::type)
-      return evaluate(layout.name(), op_, d);
+      return constant(evaluate(layout.name(), op_, d));
     if (e.kind == meta_extractor::field) {
       const auto* s = caf::get_if<std::string>(&d);
       if (!s) {
         VAST_WARN("#field can only compare with string");
-        return false;
+        return constant(false);
       }
       auto result = false;
       auto neg = is_negated(op_);
-      // auto abs_op = neg ? negate(op_) : op_;
       for (const auto& field : record_type::each{layout}) {
         auto fqn = layout.name() + "." + field.key();
         if (detail::ends_with(fqn, *s)) {
@@ -635,62 +666,81 @@ struct row_evaluator {
           break;
         }
       }
-      return neg ? !result : result;
+      return constant(neg ? !result : result);
     }
-    return false;
+    return constant(false);
   }
 
-  bool operator()(const type_extractor&, const data&) {
+  ids operator()(const type_extractor&, const data&) {
     die("type extractor should have been resolved at this point");
   }
 
-  bool operator()(const field_extractor&, const data&) {
+  ids operator()(const field_extractor&, const data&) {
     die("field extractor should have been resolved at this point");
   }
 
-  bool operator()(const data_extractor& e, const data& d) {
+  ids operator()(const data_extractor& e, const data& d) {
     auto col = slice_.layout().flat_index_at(e.offset);
     VAST_ASSERT(col);
-    auto lhs = to_canonical(e.type, slice_.at(row_, *col, e.type));
-    auto rhs = make_data_view(d);
-    return evaluate_view(lhs, op_, rhs);
+    return slice_.evaluate_column(*col, e.type, op_, d);
+  }
+
+private:
+  ids constant(bool bit) const {
+    return ids{slice_.rows(), bit};
   }
 
   const table_slice& slice_;
-  size_t row_;
   relational_operator op_ = {};
 };
 
+/// Computes the set of rows in a slice that are contained in the hints and
+/// match the expression.
+/// @param slice The input table slice.
+/// @param expr The expression to evaluate.
+/// @param hints An ID set for pruning the events that need to be considered.
+/// @returns The set of selected IDs, or `std::nullopt` if all rows qualify.
+std::optional<ids>
+matching(const table_slice& slice, const expression& expr, const ids& hints) {
+  const auto offset = slice.offset();
+  auto slice_ids = make_ids({{offset, offset + slice.rows()}});
+  auto selection = slice_ids;
+  if (!hints.empty())
+    selection &= hints;
+  auto selection_rank = rank(selection);
+  if (selection_rank == 0)
+    return ids{};
+  if (expr == expression{}) {
+    // Do all rows qualify?
+    if (rank(slice_ids) == selection_rank)
+      return std::nullopt;
+    return selection;
+  }
+  return selection & evaluate(expr, slice);
+}
+
 } // namespace
 
 ids evaluate(const expression& expr, const table_slice& slice) {
-  // TODO: switch to a column-based evaluation strategy where it makes sense.
   ids result;
   result.append(false, slice.offset());
-  for (size_t row = 0; row != slice.rows(); ++row) {
-    auto x = caf::visit(row_evaluator{slice, row}, expr);
-    result.append_bit(x);
-  }
+  result.append(caf::visit(column_evaluator{slice}, expr));
   return result;
 }
 
 std::optional<table_slice>
 filter(const table_slice& slice, const expression& expr, const ids& hints) {
   VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
-  const auto offset = slice.offset();
-  auto slice_ids = make_ids({{offset, offset + slice.rows()}});
-  auto selection = slice_ids;
-  if (!hints.empty())
-    selection &= hints;
+  auto selection = matching(slice, expr, hints);
+  // Do all rows qualify?
+  if (!selection)
+    return slice;
   // Do no rows qualify?
-  auto selection_rank = rank(selection);
+  auto selection_rank = rank(*selection);
   if (selection_rank == 0)
     return std::nullopt;
-  if (expr == expression{}) {
-    // Do all rows qualify?
-    if (rank(slice_ids) == selection_rank)
-      return slice;
-  }
+  if (selection_rank == slice.rows())
+    return slice;
   // Get the desired encoding, and the already serialized layout.
   auto f = detail::overload{
     []() noexcept -> std::pair<table_slice_encoding, span<const std::byte>> {
@@ -712,28 +762,17 @@ filter(const table_slice& slice, const expression& expr, const ids& hints) {
     = factory<table_slice_builder>::make(implementation_id, slice.layout());
   VAST_ASSERT(builder);
   auto flat_layout = flatten(slice.layout());
-  auto check = [&](row_evaluator eval) {
-    if (expr == expression{})
-      return true;
-    return caf::visit(eval, expr);
-  };
-  for (auto id : select(selection)) {
+  const auto offset = slice.offset();
+  for (auto id : select(*selection)) {
     VAST_ASSERT(id >= offset);
     auto row = id - offset;
     VAST_ASSERT(row < slice.rows());
-    if (check(row_evaluator{slice, row})) {
-      for (size_t column = 0; column < flat_layout.fields.size(); ++column) {
-        auto cell_value
-          = slice.at(row, column, flat_layout.fields[column].type);
-        auto ret = builder->add(cell_value);
-        VAST_ASSERT(ret);
-      }
+    for (size_t column = 0; column < flat_layout.fields.size(); ++column) {
+      auto cell_value = slice.at(row, column, flat_layout.fields[column].type);
+      auto ret = builder->add(cell_value);
+      VAST_ASSERT(ret);
     }
   }
-  if (builder->rows() == 0)
-    return std::nullopt;
-  if (builder->rows() == slice.rows())
-    return slice;
   auto new_slice = builder->finish(serialized_layout);
   VAST_ASSERT(new_slice.encoding() != table_slice_encoding::none);
   return new_slice;
@@ -751,49 +790,11 @@ std::optional<table_slice> filter(const table_slice& slice, const ids& hints) {
 uint64_t count_matching(const table_slice& slice, const expression& expr,
                         const ids& hints) {
   VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
-  const auto offset = slice.offset();
-  auto slice_ids = make_ids({{offset, offset + slice.rows()}});
-  auto selection = slice_ids;
-  if (!hints.empty())
-    selection &= hints;
-  // Do no rows qualify?
-  auto selection_rank = rank(selection);
-  if (selection_rank == 0)
-    return 0;
-  if (expr == expression{}) {
-    // Do all rows qualify?
-    if (rank(slice_ids) == selection_rank)
-      return slice.rows();
-  }
-  // Get the desired encoding, and the already serialized layout.
-  auto f = detail::overload{
-    []() noexcept -> std::pair<table_slice_encoding, span<const std::byte>> {
-      die("cannot filter an invalid table slice");
-    },
-    [&](const auto& encoded) noexcept {
-      return std::pair{
-        builder_id(state(encoded, slice.state_)->encoding),
-        span{reinterpret_cast<const std::byte*>(encoded.layout()->data()),
-             encoded.layout()->size()}};
-    },
-  };
-  table_slice_encoding implementation_id;
-  span<const std::byte> serialized_layout = {};
-  std::tie(implementation_id, serialized_layout)
-    = visit(f, as_flatbuffer(slice.chunk_));
-  auto check = [&](row_evaluator eval) -> uint64_t {
-    if (expr == expression{})
-      return 1u;
-    return static_cast<uint64_t>(caf::visit(eval, expr));
-  };
-  uint64_t cnt = 0u;
-  for (auto id : select(selection)) {
-    VAST_ASSERT(id >= offset);
-    auto row = id - offset;
-    VAST_ASSERT(row < slice.rows());
-    cnt += check(row_evaluator{slice, row});
-  }
-  return cnt;
+  auto selection = matching(slice, expr, hints);
+  // Do all rows qualify?
+  if (!selection)
+    return slice.rows();
+  return rank(*selection);
 }
 
 } // namespace vast
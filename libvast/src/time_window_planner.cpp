@@ -0,0 +1,124 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "vast/time_window_planner.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/type.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace vast {
+
+namespace {
+
+/// Builds the predicates for a merged time range and the keys of its windows.
+expression make_range_expression(const std::optional<std::string>& key_field,
+                                 time first, time last, list keys) {
+  std::vector<expression> xs;
+  auto timestamp = type_extractor{time_type{}.name("timestamp")};
+  if (first != time::min())
+    xs.emplace_back(predicate{timestamp, relational_operator::greater_equal,
+                              data{first}});
+  if (last != time::max())
+    xs.emplace_back(
+      predicate{timestamp, relational_operator::less_equal, data{last}});
+  if (key_field) {
+    if (keys.size() == 1)
+      xs.emplace_back(predicate{field_extractor{*key_field},
+                                relational_operator::equal,
+                                std::move(keys.front())});
+    else
+      xs.emplace_back(predicate{field_extractor{*key_field},
+                                relational_operator::in, data{std::move(keys)}});
+  }
+  // An unbounded window without a key selects all events, which we express as
+  // a range over the entire time domain.
+  if (xs.empty())
+    return predicate{timestamp, relational_operator::greater_equal,
+                     data{time::min()}};
+  if (xs.size() == 1)
+    return std::move(xs.front());
+  return conjunction{std::move(xs)};
+}
+
+} // namespace
+
+const expression& time_window_planner::query::expr() const noexcept {
+  return expr_;
+}
+
+size_t time_window_planner::query::size() const noexcept {
+  return size_;
+}
+
+time_window_planner::time_window_planner(std::optional<std::string> key_field,
+                                         size_t max_ranges_per_query)
+  : key_field_{std::move(key_field)},
+    max_ranges_per_query_{max_ranges_per_query} {
+  VAST_ASSERT(max_ranges_per_query_ > 0);
+}
+
+size_t time_window_planner::add(time first, time last, data key) {
+  VAST_ASSERT(first <= last);
+  VAST_ASSERT(key_field_ || caf::holds_alternative<caf::none_t>(key));
+  windows_.push_back({first, last, std::move(key), num_windows_});
+  return num_windows_++;
+}
+
+size_t time_window_planner::size() const noexcept {
+  return windows_.size();
+}
+
+std::vector<time_window_planner::query> time_window_planner::plan() {
+  std::vector<query> result;
+  std::stable_sort(windows_.begin(), windows_.end(),
+                   [](const window& lhs, const window& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  std::vector<expression> ranges;
+  query current;
+  auto finish = [&] {
+    if (ranges.empty())
+      return;
+    if (ranges.size() == 1)
+      current.expr_ = std::move(ranges.front());
+    else
+      current.expr_ = disjunction{std::move(ranges)};
+    result.push_back(std::move(current));
+    ranges.clear();
+    current = {};
+  };
+  for (auto first = windows_.begin(); first != windows_.end();) {
+    // Merge all windows that overlap with the current range. The keys keep
+    // the order in which they first appear, which keeps the queries stable.
+    auto last = first->last;
+    auto keys = list{};
+    auto seen = std::unordered_set<data>{};
+    auto next = first;
+    for (; next != windows_.end() && next->first <= last; ++next) {
+      last = std::max(last, next->last);
+      if (seen.insert(next->key).second)
+        keys.push_back(next->key);
+      current.windows_[next->key].insert(next->first, next->last, next->id);
+      ++current.size_;
+    }
+    ranges.push_back(
+      make_range_expression(key_field_, first->first, last, std::move(keys)));
+    if (ranges.size() == max_ranges_per_query_)
+      finish();
+    first = next;
+  }
+  finish();
+  windows_.clear();
+  num_windows_ = 0;
+  return result;
+}
+
+} // namespace vast
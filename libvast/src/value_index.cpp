@@ -8,6 +8,8 @@
 
 #include "vast/value_index.hpp"
 
+#include "vast/table_slice.hpp"
+#include "vast/table_slice_column.hpp"
 #include "vast/value_index_factory.hpp"
 
 #include <caf/deserializer.hpp>
@@ -46,6 +48,31 @@ caf::expected<void> value_index::append(data_view x, id pos) {
   return caf::no_error;
 }
 
+caf::expected<void> value_index::append(const table_slice_column& column) {
+  auto pos = column.slice().offset();
+  auto off = offset();
+  if (pos < off)
+    // Can only append at the end
+    return caf::make_error(ec::unspecified, pos, '<', off);
+  column.slice().append_column_to_index(column.index(), *this);
+  return caf::no_error;
+}
+
+caf::expected<void> value_index::append_run(const value_run& xs, id pos) {
+  auto off = offset();
+  if (pos < off)
+    // Can only append at the end
+    return caf::make_error(ec::unspecified, pos, '<', off);
+  auto n = caf::visit([](const auto& run) { return run.size(); }, xs);
+  if (n == 0)
+    return caf::no_error;
+  if (!append_run_impl(xs, pos))
+    return caf::make_error(ec::unimplemented, "append_run_impl");
+  mask_.append_bits(false, pos - mask_.size());
+  mask_.append_bits(true, n);
+  return caf::no_error;
+}
+
 caf::expected<ids>
 value_index::lookup(relational_operator op, data_view x) const {
   // When x is nil, we can answer the query right here.
@@ -84,6 +111,10 @@ size_t value_index::memusage() const {
   return mask_.memusage() + none_.memusage() + memusage_impl();
 }
 
+bool value_index::append_run_impl(const value_run&, id) {
+  return false;
+}
+
 value_index::size_type value_index::offset() const {
   return std::max(none_.size(), mask_.size());
 }
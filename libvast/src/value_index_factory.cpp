@@ -14,6 +14,7 @@
 #include "vast/detail/bit.hpp"
 #include "vast/detail/type_traits.hpp"
 #include "vast/index/address_index.hpp"
+#include "vast/index/address_prefix_index.hpp"
 #include "vast/index/arithmetic_index.hpp"
 #include "vast/index/enumeration_index.hpp"
 #include "vast/index/hash_index.hpp"
@@ -57,6 +58,10 @@ value_index_ptr make(type x, caf::settings opts) {
     }
   }
   if (auto a = find_attribute(x, "index")) {
+    if constexpr (std::is_same_v<T, address_index>)
+      if (auto value = a->value; value && *value == "prefix"sv)
+        return std::make_unique<address_prefix_index>(std::move(x),
+                                                      std::move(opts));
     if (auto value = a->value)
       if (*value == "hash"sv) {
         auto i = opts.find("cardinality");
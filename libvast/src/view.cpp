@@ -10,16 +10,17 @@
 
 #include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/detail/regex.hpp"
 #include "vast/type.hpp"
 
 #include <algorithm>
-#include <regex>
 
 namespace vast {
 
 // -- pattern_view ------------------------------------------------------------
 
-pattern_view::pattern_view(const pattern& x) : pattern_{x.string()} {
+pattern_view::pattern_view(const pattern& x)
+  : pattern_{x.string()}, source_{&x} {
   // nop
 }
 
@@ -32,13 +33,24 @@ std::string_view pattern_view::string() const {
 }
 
 bool pattern_view::match(std::string_view x) const {
-  return std::regex_match(x.begin(), x.end(),
-                          std::regex{pattern_.begin(), pattern_.end()});
+  auto rx = compiled();
+  return rx && (*rx)->match(x);
 }
 
 bool pattern_view::search(std::string_view x) const {
-  return std::regex_search(x.begin(), x.end(),
-                           std::regex{pattern_.begin(), pattern_.end()});
+  auto rx = compiled();
+  return rx && (*rx)->search(x);
+}
+
+caf::expected<std::shared_ptr<const detail::regex>>
+pattern_view::compiled() const {
+  if (source_)
+    return source_->compiled();
+  // Views into table slices have no pattern to cache the compiled expression.
+  auto rx = detail::regex::make(pattern_);
+  if (!rx)
+    return std::move(rx.error());
+  return std::make_shared<const detail::regex>(std::move(*rx));
 }
 
 bool operator==(pattern_view x, pattern_view y) noexcept {
@@ -11,10 +11,13 @@
 #include "vast/address_synopsis.hpp"
 
 #include "vast/address.hpp"
+#include "vast/chunk.hpp"
 #include "vast/concept/hashable/hash_append.hpp"
 #include "vast/concept/hashable/xxhash.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/address.hpp"
+#include "vast/fbs/utils.hpp"
+#include "vast/qualified_record_field.hpp"
 #include "vast/si_literals.hpp"
 #include "vast/synopsis.hpp"
 #include "vast/synopsis_factory.hpp"
@@ -108,4 +111,56 @@ TEST(updated params after shrinking) {
   CHECK(!r2);
 }
 
+TEST(blocked bloom filters) {
+  opts["buffer-input-data"] = true;
+  opts["blocked-bloom-filters"] = true;
+  opts["max-partition-size"] = 1_Mi;
+  auto ptr = factory<synopsis>::make(address_type{}, opts);
+  REQUIRE_NOT_EQUAL(ptr, nullptr);
+  ptr->add(to_addr_view("192.168.0.1"));
+  ptr->add(to_addr_view("192.168.0.2"));
+  auto shrunk = ptr->shrink();
+  REQUIRE_NOT_EQUAL(shrunk, nullptr);
+  // The layout must survive shrinking and serialization, because it
+  // determines the concrete synopsis type.
+  CHECK(has_blocked_layout(shrunk->type()));
+  using blocked_synopsis
+    = address_synopsis<xxhash64, policy::partitioning::blocked>;
+  auto recovered = roundtrip(std::move(shrunk));
+  REQUIRE(recovered);
+  CHECK(dynamic_cast<blocked_synopsis*>(recovered.get()) != nullptr);
+  CHECK(unbox(recovered->lookup(relational_operator::equal,
+                                to_addr_view("192.168.0.2"))));
+}
+
+TEST(native flatbuffer layout) {
+  auto t = address_type{}.attributes({{"synopsis", "bloomfilter(1000,0.1)"}});
+  for (auto blocked : {false, true}) {
+    MESSAGE("blocked layout: " << blocked);
+    auto x = factory<synopsis>::make(blocked ? annotate_blocked_layout(t) : t,
+                                     opts);
+    REQUIRE_NOT_EQUAL(x, nullptr);
+    x->add(to_addr_view("192.168.0.1"));
+    x->add(to_addr_view("10.0.0.1"));
+    flatbuffers::FlatBufferBuilder builder;
+    auto offset = unbox(pack(builder, x, qualified_record_field{}));
+    builder.Finish(offset);
+    auto chunk = fbs::release(builder);
+    const auto* packed = flatbuffers::GetRoot<fbs::synopsis::v0>(
+      reinterpret_cast<const uint8_t*>(chunk->data()));
+    REQUIRE(packed->bloom_filter_synopsis() != nullptr);
+    synopsis_ptr y;
+    REQUIRE_EQUAL(unpack(*packed, y), caf::none);
+    REQUIRE_NOT_EQUAL(y, nullptr);
+    CHECK_EQUAL(*y, *x);
+    CHECK_EQUAL(y->memusage(), x->memusage());
+    MESSAGE("the unpacked synopsis owns its bits");
+    chunk = nullptr;
+    CHECK(unbox(
+      y->lookup(relational_operator::equal, to_addr_view("192.168.0.1"))));
+    CHECK(unbox(
+      y->lookup(relational_operator::equal, to_addr_view("10.0.0.1"))));
+  }
+}
+
 FIXTURE_SCOPE_END()
@@ -17,6 +17,7 @@
 #  include "vast/concept/parseable/to.hpp"
 #  include "vast/concept/parseable/vast/address.hpp"
 #  include "vast/concept/parseable/vast/subnet.hpp"
+#  include "vast/ids.hpp"
 #  include "vast/test/fixtures/table_slices.hpp"
 #  include "vast/test/test.hpp"
 #  include "vast/type.hpp"
@@ -224,6 +225,35 @@ TEST(single column - subnet) {
   CHECK_ROUNDTRIP(slice);
 }
 
+TEST(single column - evaluate) {
+  using vast::address;
+  using vast::subnet;
+  using vast::to;
+  auto check = [](const table_slice& slice, const type& t,
+                  relational_operator op, const data& rhs,
+                  std::initializer_list<id_range> expected) {
+    auto result = slice.evaluate_column(0, t, op, rhs);
+    CHECK_EQUAL(result, make_ids(expected, slice.rows()));
+  };
+  auto counts = make_single_column_slice<count_type>(0_c, 1_c, caf::none, 3_c);
+  check(counts, count_type{}, relational_operator::equal, 1_c, {{1}});
+  check(counts, count_type{}, relational_operator::not_equal, 1_c,
+        {{0}, {2, 4}});
+  check(counts, count_type{}, relational_operator::greater_equal, 1_c,
+        {{1}, {3}});
+  auto a1 = unbox(to<address>("172.16.7.1"));
+  auto a2 = unbox(to<address>("2001:db8::"));
+  auto addrs = make_single_column_slice<address_type>(caf::none, a1, a2);
+  auto sn = unbox(to<subnet>("172.16.0.0/16"));
+  check(addrs, address_type{}, relational_operator::in, sn, {{1}});
+  check(addrs, address_type{}, relational_operator::not_in, sn, {{0}, {2}});
+  check(addrs, address_type{}, relational_operator::equal, a2, {{2}});
+  auto strs = make_single_column_slice<string_type>("foobar"sv, caf::none,
+                                                    "bar"sv);
+  check(strs, string_type{}, relational_operator::ni, "oba"s, {{0}});
+  check(strs, string_type{}, relational_operator::equal, "bar"s, {{2}});
+}
+
 TEST(single column - list of integers) {
   auto t = list_type{integer_type{}};
   record_type layout{record_field{"values", t}};
@@ -221,3 +221,34 @@ TEST(bloom filter - duplicate tracking) {
   CHECK(x.lookup(42));
   CHECK(!x.add(42));
 }
+
+TEST(bloom filter - blocked partitioning) {
+  bloom_filter_parameters xs;
+  xs.n = 10_k;
+  xs.p = 0.01;
+  auto x = vast::test::unbox(
+    make_bloom_filter<xxhash64, double_hasher, policy::partitioning::blocked>(
+      xs));
+  CHECK_EQUAL(x.size() % 512, 0u);
+  for (auto i = 0; i < 10'000; ++i)
+    x.add(i);
+  auto false_negatives = 0;
+  for (auto i = 0; i < 10'000; ++i)
+    if (!x.lookup(i))
+      ++false_negatives;
+  CHECK_EQUAL(false_negatives, 0);
+  // The blocked layout has a slightly higher false-positive rate than the
+  // requested one, but it must stay in the same ballpark.
+  auto false_positives = 0;
+  for (auto i = 10'000; i < 110'000; ++i)
+    if (x.lookup(i))
+      ++false_positives;
+  CHECK_LESS(false_positives, 3'000);
+  MESSAGE("persistence");
+  std::vector<char> buf;
+  REQUIRE_EQUAL(detail::serialize(buf, x), caf::none);
+  bloom_filter<xxhash64, double_hasher, policy::partitioning::blocked> y;
+  REQUIRE_EQUAL(detail::deserialize(buf, y), caf::none);
+  CHECK(x == y);
+  CHECK(y.lookup(42));
+}
@@ -17,7 +17,9 @@
 #include "vast/detail/deserialize.hpp"
 #include "vast/detail/order.hpp"
 #include "vast/detail/serialize.hpp"
+#include "vast/ewah_bitmap.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/span.hpp"
 #include "vast/test/fixtures/actor_system.hpp"
 #include "vast/test/test.hpp"
 
@@ -469,6 +471,58 @@ TEST(multi-level range coder) {
   }
 }
 
+TEST(bulk encoding) {
+  auto xs = std::vector<uint64_t>{};
+  for (auto i = 0u; i < 300; ++i)
+    xs.push_back(i % 7 == 0 ? 255 : (i * 37) % 200);
+  auto check = [&](auto single, auto bulk, auto ops, auto values) {
+    // Interleave a skip and single values with two bulk-encoded runs that
+    // span several blocks.
+    using value_type = typename decltype(single)::value_type;
+    auto ys = std::vector<value_type>(xs.begin(), xs.end());
+    auto first = span<const value_type>{ys.data(), 130};
+    auto second = span<const value_type>{ys.data() + 130, ys.size() - 130};
+    single.skip(3);
+    bulk.skip(3);
+    for (auto x : first)
+      single.encode(x);
+    bulk.encode(first);
+    single.encode(42);
+    bulk.encode(42);
+    for (auto x : second)
+      single.encode(x);
+    bulk.encode(second);
+    REQUIRE_EQUAL(single.size(), bulk.size());
+    for (auto op : ops)
+      for (auto x : values)
+        CHECK_EQUAL(to_string(single.decode(op, x)),
+                    to_string(bulk.decode(op, x)));
+  };
+  auto all_ops = std::vector{
+    relational_operator::less,      relational_operator::less_equal,
+    relational_operator::equal,     relational_operator::not_equal,
+    relational_operator::greater,   relational_operator::greater_equal};
+  auto equality_ops
+    = std::vector{relational_operator::equal, relational_operator::not_equal};
+  MESSAGE("range coder");
+  check(range_coder<ewah_bitmap>{255}, range_coder<ewah_bitmap>{255}, all_ops,
+        std::vector<uint64_t>{0, 1, 42, 199, 254, 255});
+  MESSAGE("bitslice coder");
+  check(bitslice_coder<ewah_bitmap>{8}, bitslice_coder<ewah_bitmap>{8},
+        equality_ops, std::vector<uint64_t>{0, 1, 42, 199, 255});
+  MESSAGE("multi-level range coder");
+  using multi_level_range_coder = multi_level_coder<range_coder<ewah_bitmap>>;
+  check(multi_level_range_coder{base::uniform(8, 3)},
+        multi_level_range_coder{base::uniform(8, 3)}, all_ops,
+        std::vector<uint64_t>{0, 1, 42, 199, 255});
+  MESSAGE("singleton coder");
+  xs.assign(xs.size(), 0);
+  for (auto i = 0u; i < xs.size(); i += 3)
+    xs[i] = 1;
+  check(singleton_coder<ewah_bitmap>{}, singleton_coder<ewah_bitmap>{},
+        equality_ops, std::vector<bool>{false, true});
+}
+
 TEST(serialization range coder) {
   range_coder<null_bitmap> x{100}, c;
   fill(x, 42, 84, 42, 21, 30);
@@ -0,0 +1,131 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE compare_kernels
+
+#include "vast/detail/compare_kernels.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace vast;
+using namespace vast::detail;
+
+namespace {
+
+constexpr auto levels = {simd_level::scalar, simd_level::sse4_2,
+                         simd_level::avx2};
+
+// Renders the output blocks of a kernel as a string of zeros and ones.
+std::string render(const std::vector<uint64_t>& blocks, size_t n) {
+  std::string result;
+  for (size_t i = 0; i < n; ++i)
+    result += (blocks[i / 64] >> (i % 64)) & 1 ? '1' : '0';
+  return result;
+}
+
+template <class T>
+std::string run(simd_level level, relational_operator op,
+                const std::vector<T>& xs, T x) {
+  auto out = std::vector<uint64_t>((xs.size() + 63) / 64, ~uint64_t{0});
+  compare(level, op, xs.data(), xs.size(), x, out.data());
+  // Bits beyond the input must be zero.
+  if (xs.size() % 64 != 0)
+    CHECK_EQUAL(out.back() >> (xs.size() % 64), 0u);
+  return render(out, xs.size());
+}
+
+// Creates 130 values cycling through [-2, 2] to exercise full blocks as well
+// as the scalar tail.
+template <class T>
+std::vector<T> make_values(T offset) {
+  std::vector<T> result;
+  for (int i = 0; i < 130; ++i)
+    result.push_back(static_cast<T>(i % 5) + offset);
+  return result;
+}
+
+std::string expected(const std::string& pattern) {
+  std::string result;
+  while (result.size() < 130)
+    result += pattern;
+  result.resize(130);
+  return result;
+}
+
+} // namespace
+
+TEST(integer comparisons) {
+  auto xs = make_values<int64_t>(-2);
+  for (auto level : levels) {
+    MESSAGE("level: " << to_string(level));
+    auto x = int64_t{0};
+    CHECK_EQUAL(run(level, relational_operator::equal, xs, x),
+                expected("00100"));
+    CHECK_EQUAL(run(level, relational_operator::not_equal, xs, x),
+                expected("11011"));
+    CHECK_EQUAL(run(level, relational_operator::less, xs, x),
+                expected("11000"));
+    CHECK_EQUAL(run(level, relational_operator::less_equal, xs, x),
+                expected("11100"));
+    CHECK_EQUAL(run(level, relational_operator::greater, xs, x),
+                expected("00011"));
+    CHECK_EQUAL(run(level, relational_operator::greater_equal, xs, x),
+                expected("00111"));
+  }
+}
+
+TEST(count comparisons beyond the signed range) {
+  auto xs = make_values<uint64_t>(uint64_t{1} << 63);
+  for (auto level : levels) {
+    MESSAGE("level: " << to_string(level));
+    auto x = (uint64_t{1} << 63) + 2;
+    CHECK_EQUAL(run(level, relational_operator::less, xs, x),
+                expected("11000"));
+    CHECK_EQUAL(run(level, relational_operator::greater_equal, xs, x),
+                expected("00111"));
+    CHECK_EQUAL(run(level, relational_operator::greater, xs, uint64_t{1}),
+                expected("11111"));
+  }
+}
+
+TEST(real comparisons) {
+  auto xs = make_values<double>(-2.0);
+  for (auto level : levels) {
+    MESSAGE("level: " << to_string(level));
+    CHECK_EQUAL(run(level, relational_operator::equal, xs, 0.0),
+                expected("00100"));
+    CHECK_EQUAL(run(level, relational_operator::less_equal, xs, 0.0),
+                expected("11100"));
+    CHECK_EQUAL(run(level, relational_operator::greater, xs, 0.0),
+                expected("00011"));
+  }
+}
+
+TEST(address prefix checks) {
+  // Every third address lies in 10.0.0.0/8, represented as IPv4-mapped IPv6.
+  auto n = size_t{130};
+  auto addrs = std::vector<uint8_t>(n * 16);
+  for (size_t i = 0; i < n; ++i) {
+    addrs[i * 16 + 10] = 0xFF;
+    addrs[i * 16 + 11] = 0xFF;
+    addrs[i * 16 + 12] = i % 3 == 0 ? 10 : 11;
+    addrs[i * 16 + 15] = static_cast<uint8_t>(i);
+  }
+  uint8_t network[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 10};
+  uint8_t mask[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                      0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+  for (auto level : levels) {
+    MESSAGE("level: " << to_string(level));
+    auto out = std::vector<uint64_t>((n + 63) / 64);
+    mask_equal(level, addrs.data(), n, network, mask, out.data());
+    CHECK_EQUAL(render(out, n), expected("100"));
+  }
+}
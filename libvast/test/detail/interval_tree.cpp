@@ -0,0 +1,73 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE interval_tree
+
+#include "vast/detail/interval_tree.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace vast;
+using namespace vast::detail;
+
+namespace {
+
+std::vector<int>
+overlapping(const interval_tree<int, int>& tree, int lo, int hi) {
+  std::vector<int> result;
+  tree.overlapping(lo, hi, [&](int x) { result.push_back(x); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
+TEST(overlap queries) {
+  interval_tree<int, int> tree;
+  CHECK(overlapping(tree, 0, 100).empty());
+  tree.insert(10, 20, 1);
+  tree.insert(15, 25, 2);
+  tree.insert(30, 40, 3);
+  tree.insert(0, 100, 4);
+  tree.insert(42, 42, 5);
+  CHECK_EQUAL(tree.size(), 5u);
+  CHECK_EQUAL(overlapping(tree, 12, 12), (std::vector<int>{1, 4}));
+  CHECK_EQUAL(overlapping(tree, 20, 30), (std::vector<int>{1, 2, 3, 4}));
+  CHECK_EQUAL(overlapping(tree, 41, 43), (std::vector<int>{4, 5}));
+  CHECK_EQUAL(overlapping(tree, 101, 200), std::vector<int>{});
+  CHECK_EQUAL(overlapping(tree, -10, -1), std::vector<int>{});
+}
+
+TEST(erase) {
+  interval_tree<int, int> tree;
+  for (int i = 0; i < 10; ++i)
+    tree.insert(i * 10, i * 10 + 5, i);
+  CHECK_EQUAL(overlapping(tree, 0, 25), (std::vector<int>{0, 1, 2}));
+  CHECK_EQUAL(tree.erase(1), 1u);
+  CHECK_EQUAL(tree.erase(1), 0u);
+  CHECK_EQUAL(overlapping(tree, 0, 25), (std::vector<int>{0, 2}));
+  CHECK_EQUAL(tree.size(), 9u);
+}
+
+TEST(interleaved modifications and queries) {
+  interval_tree<int, int> tree;
+  for (int i = 9; i >= 5; --i)
+    tree.insert(i * 10, i * 10 + 5, i);
+  CHECK_EQUAL(overlapping(tree, 50, 65), (std::vector<int>{5, 6}));
+  for (int i = 4; i >= 0; --i)
+    tree.insert(i * 10, i * 10 + 5, i);
+  CHECK_EQUAL(tree.erase(6), 1u);
+  CHECK_EQUAL(tree.erase(2), 1u);
+  CHECK_EQUAL(overlapping(tree, 15, 65), (std::vector<int>{1, 3, 4, 5}));
+  tree.insert(61, 62, 10);
+  CHECK_EQUAL(overlapping(tree, 0, 100),
+              (std::vector<int>{0, 1, 3, 4, 5, 7, 8, 9, 10}));
+}
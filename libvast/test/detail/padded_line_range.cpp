@@ -0,0 +1,62 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE padded_line_range
+
+#include "vast/detail/padded_line_range.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace vast;
+using namespace vast::detail;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<std::string> lines(const std::string& input, size_t capacity) {
+  std::istringstream in{input};
+  auto range = padded_line_range{in, 8, capacity};
+  std::vector<std::string> result;
+  while (!range.done()) {
+    CHECK(!range.next_timeout(10ms));
+    if (!range.get().empty())
+      result.emplace_back(range.get());
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(line splitting) {
+  auto expected = std::vector<std::string>{"foo", "bar baz", "qux"};
+  CHECK_EQUAL(lines("foo\nbar baz\r\n\n\nqux\n", 1024), expected);
+  CHECK_EQUAL(lines("foo\nbar baz\nqux", 1024), expected);
+  CHECK_EQUAL(lines("", 1024), std::vector<std::string>{});
+}
+
+TEST(lines exceeding the buffer) {
+  auto long_line = std::string(100, 'x');
+  auto input = "a\n" + long_line + "\nb\n" + long_line;
+  auto expected = std::vector<std::string>{"a", long_line, "b", long_line};
+  CHECK_EQUAL(lines(input, 3), expected);
+}
+
+TEST(line numbers) {
+  std::istringstream in{"a\n\nb\n"};
+  auto range = padded_line_range{in, 8, 1024};
+  CHECK(!range.next_timeout(10ms));
+  CHECK_EQUAL(range.get(), "a");
+  CHECK_EQUAL(range.line_number(), 1u);
+  CHECK(!range.next_timeout(10ms));
+  CHECK_EQUAL(range.get(), "b");
+  CHECK_EQUAL(range.line_number(), 3u);
+}
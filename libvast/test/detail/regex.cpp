@@ -0,0 +1,98 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE regex
+
+#include "vast/detail/regex.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <caf/test/dsl.hpp>
+
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+using namespace vast::detail;
+
+namespace {
+
+/// Compares match and search results against `std::regex`.
+void check_against_std_regex(const std::string& pattern,
+                             const std::vector<std::string>& inputs) {
+  auto rx = unbox(regex::make(pattern));
+  auto reference = std::regex{pattern};
+  for (const auto& input : inputs) {
+    MESSAGE("/" << pattern << "/ on '" << input << "'");
+    CHECK_EQUAL(rx.match(input), std::regex_match(input, reference));
+    CHECK_EQUAL(rx.search(input), std::regex_search(input, reference));
+  }
+}
+
+} // namespace
+
+TEST(automaton agrees with std::regex) {
+  auto inputs = std::vector<std::string>{
+    "",    "a",      "ab",  "abc",   "xabcx", "aab",   "abab",
+    "123", "a1b",    "\n",  "a\nb",  "-",     "foo",   "foobarqux",
+    "x",   "abcabc", "foox", "fooba", "AbC",  "a.c",   "a c"};
+  auto patterns = std::vector<std::string>{
+    "",          "a",       "abc",        "a*",        "a+b",
+    "^abc$",     "ab|cd",   "(ab)+c",     "(?:a|b)*c", "a{2,3}",
+    "a{2,}",     "a{0}",    ".*foo.*",    "[a-c]+",    "[^a-c]",
+    "\\d+",      "\\w+",    "\\s",        "[\\d-]+",   "[a-]",
+    "x$|^y",     "$",       "^",          "^$",        "a$b",
+    "(a*)*",     "(a|)+b",  "a\\.c",      "\\x41",     "a.c",
+    "a??b",      "(abc){2}", "foo(bar|baz)qux"};
+  for (const auto& pattern : patterns) {
+    auto rx = unbox(regex::make(pattern));
+    CHECK(rx.is_automaton());
+    check_against_std_regex(pattern, inputs);
+  }
+}
+
+TEST(fallback to std::regex) {
+  auto rx = unbox(regex::make("(a+)b\\1"));
+  CHECK(!rx.is_automaton());
+  CHECK(rx.match("aabaa"));
+  CHECK(!rx.match("aaba"));
+  rx = unbox(regex::make("\\bfoo\\b"));
+  CHECK(!rx.is_automaton());
+  CHECK(rx.search("a foo b"));
+  CHECK(!rx.search("afoo"));
+}
+
+TEST(invalid expressions) {
+  CHECK(!regex::make("("));
+  CHECK(!regex::make("a{3,2}"));
+  CHECK(!regex::make("*a"));
+}
+
+TEST(linear time) {
+  // Backtracking engines take exponential time for this expression.
+  auto rx = unbox(regex::make("(a*)*b"));
+  CHECK(rx.is_automaton());
+  CHECK(!rx.search(std::string(100'000, 'a')));
+}
+
+TEST(required literals) {
+  auto literals = [](const std::string& pattern) {
+    return unbox(regex::make(pattern)).required_literals();
+  };
+  using strings = std::vector<std::string>;
+  CHECK_EQUAL(literals("foo"), strings{"foo"});
+  CHECK_EQUAL(literals("^foo.*bar$"), (strings{"bar", "foo"}));
+  CHECK_EQUAL(literals("Mozilla/5\\.0.*(Windows|Linux).*Firefox"),
+              (strings{"Mozilla/5.0", "Firefox"}));
+  CHECK_EQUAL(literals("(foo|foobar)x"), strings{"x"});
+  CHECK_EQUAL(literals("(abc)+d"), (strings{"abc", "d"}));
+  CHECK_EQUAL(literals("(abc){2}"), strings{"abcabc"});
+  CHECK_EQUAL(literals("a*|b"), strings{});
+  CHECK_EQUAL(literals("[ab]c?"), strings{});
+}
@@ -54,9 +54,11 @@ TEST(uuid roundtrip) {
 
 TEST(index roundtrip) {
   vast::system::index_state state(/*self = */ nullptr);
-  // The active partition is not supposed to appear in the
+  // The active partitions are not supposed to appear in the
   // created flatbuffer
-  state.active_partition.id = vast::uuid::random();
+  state.active_partitions.resize(2);
+  for (auto& active : state.active_partitions)
+    active.id = vast::uuid::random();
   // Both unpersisted and persisted partitions should show up in the created
   // flatbuffer.
   state.unpersisted[vast::uuid::random()] = nullptr;
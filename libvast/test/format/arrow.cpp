@@ -23,13 +23,18 @@
 #  include "vast/format/arrow.hpp"
 #  include "vast/table_slice.hpp"
 #  include "vast/test/fixtures/events.hpp"
+#  include "vast/test/fixtures/filesystem.hpp"
 #  include "vast/test/test.hpp"
 
 #  include <arrow/api.h>
 #  include <arrow/io/memory.h>
 #  include <arrow/ipc/reader.h>
+#  include <caf/settings.hpp>
 #  include <caf/sum_type.hpp>
 
+#  include <fstream>
+#  include <iterator>
+#  include <sstream>
 #  include <utility>
 
 using caf::get;
@@ -40,8 +45,25 @@ using namespace vast;
 
 #define REQUIRE_OK(expr) REQUIRE(expr.ok());
 
+namespace {
+
 // Needed to initialize the table slice builder factories.
-FIXTURE_SCOPE(arrow_tests, fixtures::events)
+struct fixture : fixtures::events, fixtures::filesystem {
+  std::vector<table_slice>
+  read(format::arrow::reader& reader, size_t max_slice_size) {
+    std::vector<table_slice> slices;
+    auto add_slice
+      = [&](table_slice slice) { slices.emplace_back(std::move(slice)); };
+    auto [err, num] = reader.read(100, max_slice_size, add_slice);
+    CHECK(err == ec::end_of_input);
+    CHECK_EQUAL(num, rows(zeek_conn_log));
+    return slices;
+  }
+};
+
+} // namespace
+
+FIXTURE_SCOPE(arrow_tests, fixture)
 
 TEST(arrow batch) {
   // Create a writer with a buffered output stream.
@@ -86,6 +108,65 @@ TEST(arrow batch) {
   CHECK_EQUAL(slice_id, zeek_conn_log.size());
 }
 
+TEST(arrow file round trip) {
+  caf::settings options;
+  caf::put(options, "vast.export.write", directory.string());
+  caf::put(options, "vast.export.arrow.file", true);
+  {
+    format::arrow::writer writer{options};
+    for (auto& slice : zeek_conn_log)
+      REQUIRE_EQUAL(writer.write(slice), caf::none);
+  }
+  auto path = directory / "zeek.conn.arrow";
+  REQUIRE(std::filesystem::exists(path));
+  caf::settings read_options;
+  caf::put(read_options, "vast.import.read", path.string());
+  format::arrow::reader reader{read_options};
+  auto slices = read(reader, 100);
+  REQUIRE_EQUAL(slices.size(), zeek_conn_log.size());
+  for (size_t i = 0; i < slices.size(); ++i) {
+    CHECK_EQUAL(slices[i].encoding(), table_slice_encoding::arrow);
+    CHECK_EQUAL(slices[i], zeek_conn_log[i]);
+  }
+  MESSAGE("read the file from an input stream");
+  auto file = std::ifstream{path, std::ios::binary};
+  REQUIRE(file);
+  format::arrow::reader stream_reader{
+    caf::settings{},
+    std::make_unique<std::istringstream>(
+      std::string{std::istreambuf_iterator<char>{file},
+                  std::istreambuf_iterator<char>{}})};
+  slices = read(stream_reader, 100);
+  REQUIRE_EQUAL(slices.size(), zeek_conn_log.size());
+  for (size_t i = 0; i < slices.size(); ++i)
+    CHECK_EQUAL(slices[i], zeek_conn_log[i]);
+}
+
+TEST(arrow stream round trip) {
+  format::arrow::writer writer;
+  auto stream = arrow::io::BufferOutputStream::Create(
+    1024, arrow::default_memory_pool());
+  REQUIRE_OK(stream);
+  writer.out(*stream);
+  for (auto& slice : zeek_conn_log)
+    REQUIRE_EQUAL(writer.write(slice), caf::none);
+  writer.layout(record_type{});
+  auto buffer = (*stream)->Finish();
+  REQUIRE_OK(buffer);
+  MESSAGE("read the stream and split record batches into smaller slices");
+  auto in = std::make_unique<std::istringstream>((*buffer)->ToString());
+  format::arrow::reader reader{caf::settings{}, std::move(in)};
+  auto slices = read(reader, 5);
+  REQUIRE_EQUAL(slices.size(), 5u);
+  auto [first, second] = split(zeek_conn_log[0], 5);
+  CHECK_EQUAL(slices[0], first);
+  CHECK_EQUAL(slices[1], second);
+  std::tie(first, second) = split(zeek_conn_log[1], 5);
+  CHECK_EQUAL(slices[2], first);
+  CHECK_EQUAL(slices[3], second);
+  CHECK_EQUAL(slices[4], zeek_conn_log[2]);
+}
+
 FIXTURE_SCOPE_END()
 
 #endif // VAST_ENABLE_ARROW
@@ -8,11 +8,13 @@
 
 #include "vast/format/json.hpp"
 
+#include "vast/format/json/default_selector.hpp"
 #include "vast/format/json/suricata_selector.hpp"
 
 #define SUITE format
 
 #include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
 #include "vast/concept/parseable/vast/json.hpp"
 #include "vast/concept/parseable/vast/time.hpp"
 #include "vast/table_slice_builder_factory.hpp"
@@ -111,6 +113,44 @@ TEST(json to data) {
   CHECK_EQUAL(materialize(slice.at(0, 17)), data{reference});
 }
 
+TEST(json strings outlive the parsed document) {
+  auto layout = record_type{{"s", string_type{}},
+                            {"a", address_type{}},
+                            {"t", time_type{}}}
+                  .name("layout");
+  auto inputs = std::array{
+    R"json({"s": "foo", "a": "10.0.0.1", "t": "2011-08-12+14:59:11"})json"s,
+    R"json({"s": "bar", "a": "10.0.0.2", "t": "2011-08-13+14:59:11"})json"s,
+  };
+  for (auto encoding :
+       {table_slice_encoding::arrow, table_slice_encoding::msgpack}) {
+    MESSAGE("encoding: " << to_string(encoding));
+    auto builder = factory<table_slice_builder>::make(encoding, layout);
+    REQUIRE(builder);
+    // Reusing the parser overwrites the strings of the previous document, so
+    // the builder must not keep referring to them.
+    ::simdjson::dom::parser p;
+    for (const auto& input : inputs) {
+      auto el = p.parse(input);
+      REQUIRE(el.error() == ::simdjson::error_code::SUCCESS);
+      auto obj = el.value().get_object();
+      REQUIRE(obj.error() == ::simdjson::error_code::SUCCESS);
+      REQUIRE_EQUAL(format::json::add(*builder, obj.value(), layout),
+                    caf::none);
+    }
+    auto slice = builder->finish();
+    REQUIRE_EQUAL(slice.rows(), 2u);
+    CHECK_EQUAL(slice.at(0, 0), data{"foo"s});
+    CHECK_EQUAL(slice.at(1, 0), data{"bar"s});
+    CHECK_EQUAL(materialize(slice.at(0, 1)),
+                data{unbox(to<address>("10.0.0.1"))});
+    CHECK_EQUAL(materialize(slice.at(1, 1)),
+                data{unbox(to<address>("10.0.0.2"))});
+    CHECK_EQUAL(materialize(slice.at(1, 2)),
+                data{unbox(to<vast::time>("2011-08-13+14:59:11"))});
+  }
+}
+
 TEST_DISABLED(json suricata) {
   using reader_type = format::json::reader<format::json::suricata_selector>;
   auto input = std::make_unique<std::istringstream>(std::string{eve_log});
@@ -126,6 +166,35 @@ TEST_DISABLED(json suricata) {
   CHECK(slices[0].at(0, 19) == data{count{4520}});
 }
 
+TEST(json reader) {
+  using reader_type = format::json::reader<format::json::default_selector>;
+  auto layout = record_type{{"a", count_type{}},
+                            {"b", record_type{{"c", string_type{}}}}}
+                  .name("foo");
+  auto sch = schema{};
+  REQUIRE(sch.add(layout));
+  auto input = std::make_unique<std::istringstream>(
+    "{\"a\": 1, \"b\": {\"c\": \"x\"}}\n"
+    "\n"
+    "{\"a\": \n"
+    "{\"a\": 2, \"b.c\": \"y\"}\r\n"
+    "{\"a\": 3}");
+  reader_type reader{caf::settings{}, std::move(input)};
+  REQUIRE_EQUAL(reader.schema(sch), caf::none);
+  std::vector<table_slice> slices;
+  auto add_slice
+    = [&](table_slice slice) { slices.emplace_back(std::move(slice)); };
+  auto [err, num] = reader.read(10, 10, add_slice);
+  CHECK_EQUAL(err, ec::end_of_input);
+  REQUIRE_EQUAL(num, 3u);
+  REQUIRE_EQUAL(slices.size(), 1u);
+  CHECK_EQUAL(slices[0].at(0, 0), data{count{1}});
+  CHECK_EQUAL(slices[0].at(0, 1), data{std::string{"x"}});
+  CHECK_EQUAL(slices[0].at(1, 1), data{std::string{"y"}});
+  CHECK_EQUAL(slices[0].at(2, 0), data{count{3}});
+  CHECK_EQUAL(slices[0].at(2, 1), data{});
+}
+
 TEST(json hex number parser) {
   using namespace parsers;
   double x;
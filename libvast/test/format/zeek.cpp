@@ -21,6 +21,7 @@
 #include "vast/concept/parseable/vast/schema.hpp"
 #include "vast/concept/parseable/vast/type.hpp"
 #include "vast/detail/fdinbuf.hpp"
+#include "vast/format/parallel_reader.hpp"
 #include "vast/test/fixtures/actor_system.hpp"
 #include "vast/test/fixtures/events.hpp"
 #include "vast/test/fixtures/filesystem.hpp"
@@ -270,6 +271,61 @@ TEST(zeek reader - conn log) {
     CHECK_EQUAL(slice.rows(), 20u);
 }
 
+TEST(zeek reader - parallel parsing) {
+  auto input = std::string{conn_log_100_events} + '\n'
+               + std::string{capture_loss_10_events};
+  auto expected = read(input, 20, 110);
+  auto factory = [](std::unique_ptr<std::istream> in) {
+    return std::make_unique<format::zeek::reader>(caf::settings{},
+                                                  std::move(in));
+  };
+  auto reader = format::parallel_reader{
+    caf::settings{}, std::make_unique<std::istringstream>(input), factory,
+    format::parallel_reader::header_policy::zeek, 4};
+  std::vector<table_slice> slices;
+  auto add_slice = [&](table_slice slice) {
+    slices.push_back(std::move(slice));
+  };
+  auto [err, num] = reader.read(std::numeric_limits<size_t>::max(), 20,
+                                add_slice);
+  CHECK(err == ec::end_of_input);
+  CHECK_EQUAL(num, 110u);
+  REQUIRE_EQUAL(slices.size(), expected.size());
+  for (size_t i = 0; i < slices.size(); ++i)
+    CHECK(slices[i] == expected[i]);
+}
+
+TEST(zeek reader - parallel parsing with small limits) {
+  auto input = std::string{conn_log_100_events} + '\n'
+               + std::string{capture_loss_10_events};
+  auto expected = read(input, 20, 110);
+  auto factory = [](std::unique_ptr<std::istream> in) {
+    return std::make_unique<format::zeek::reader>(caf::settings{},
+                                                  std::move(in));
+  };
+  auto reader = format::parallel_reader{
+    caf::settings{}, std::make_unique<std::istringstream>(input), factory,
+    format::parallel_reader::header_policy::zeek, 4};
+  std::vector<table_slice> slices;
+  auto add_slice = [&](table_slice slice) {
+    slices.push_back(std::move(slice));
+  };
+  MESSAGE("limiting events to one slice per call yields full slices");
+  auto total = size_t{0};
+  while (true) {
+    auto [err, num] = reader.read(20, 20, add_slice);
+    total += num;
+    if (err == ec::end_of_input)
+      break;
+    REQUIRE_EQUAL(err, caf::none);
+    REQUIRE_EQUAL(num, 20u);
+  }
+  CHECK_EQUAL(total, 110u);
+  REQUIRE_EQUAL(slices.size(), expected.size());
+  for (size_t i = 0; i < slices.size(); ++i)
+    CHECK(slices[i] == expected[i]);
+}
+
 TEST(zeek reader - custom schema) {
   std::string custom_schema = R"__(
     type port = count
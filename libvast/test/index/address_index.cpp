@@ -197,4 +197,29 @@ TEST(regression - manual address bitmap index from 4 byte indexes) {
   }
 }
 
+TEST(set membership of many addresses) {
+  address_index idx{address_type{}};
+  list xs;
+  for (auto& slice : zeek_conn_log) {
+    for (size_t row = 0; row < slice.rows(); ++row) {
+      // Column 2 is orig_h, and column 4 is resp_h.
+      auto x = slice.at(row, 2, address_type{});
+      REQUIRE(idx.append(x));
+      if (row % 3 == 0)
+        xs.push_back(materialize(slice.at(row, 4, address_type{})));
+    }
+  }
+  xs.push_back(unbox(to<data>("10.0.0.1")));
+  xs.push_back(unbox(to<data>("::1")));
+  xs.push_back(unbox(to<data>("fe80::1")));
+  auto expected = ids{idx.offset(), false};
+  for (auto& x : xs)
+    expected
+      |= unbox(idx.lookup(relational_operator::equal, make_data_view(x)));
+  auto result = unbox(idx.lookup(relational_operator::in, make_data_view(xs)));
+  CHECK_EQUAL(result, expected);
+  result = unbox(idx.lookup(relational_operator::not_in, make_data_view(xs)));
+  CHECK_EQUAL(result, ~expected);
+}
+
 FIXTURE_SCOPE_END()
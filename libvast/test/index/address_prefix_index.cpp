@@ -0,0 +1,107 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE address_prefix_index
+
+#include "vast/index/address_prefix_index.hpp"
+
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
+#include "vast/concept/parseable/vast/subnet.hpp"
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/concept/printable/vast/subnet.hpp"
+#include "vast/detail/deserialize.hpp"
+#include "vast/detail/serialize.hpp"
+#include "vast/test/test.hpp"
+#include "vast/value_index_factory.hpp"
+
+using namespace vast;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    for (auto x : {"192.168.0.1", "10.0.0.1", "192.168.1.1", "::1",
+                   "192.168.0.1", "10.255.0.1", "fe80::1", "192.168.0.254"})
+      REQUIRE(idx.append(make_data_view(unbox(to<address>(x)))));
+  }
+
+  std::string lookup(relational_operator op, std::string_view x) {
+    auto result = [&] {
+      if (auto sn = to<subnet>(x))
+        return idx.lookup(op, make_data_view(*sn));
+      return idx.lookup(op, make_data_view(unbox(to<address>(x))));
+    }();
+    return to_string(unbox(result));
+  }
+
+  address_prefix_index idx{address_type{}};
+};
+
+} // namespace
+
+FIXTURE_SCOPE(address_prefix_index_tests, fixture)
+
+TEST(address equality) {
+  CHECK_EQUAL(lookup(relational_operator::equal, "192.168.0.1"), "10001000");
+  CHECK_EQUAL(lookup(relational_operator::not_equal, "192.168.0.1"),
+              "01110111");
+  CHECK_EQUAL(lookup(relational_operator::equal, "::1"), "00010000");
+  CHECK_EQUAL(lookup(relational_operator::equal, "1.2.3.4"), "00000000");
+  CHECK(!idx.lookup(relational_operator::less, make_data_view(address{})));
+}
+
+TEST(subnet containment) {
+  CHECK_EQUAL(lookup(relational_operator::in, "192.168.0.0/24"), "10001001");
+  CHECK_EQUAL(lookup(relational_operator::in, "192.168.0.0/16"), "10101001");
+  CHECK_EQUAL(lookup(relational_operator::in, "10.0.0.0/8"), "01000100");
+  CHECK_EQUAL(lookup(relational_operator::not_in, "10.0.0.0/8"), "10111011");
+  CHECK_EQUAL(lookup(relational_operator::in, "192.168.0.1/32"), "10001000");
+  CHECK_EQUAL(lookup(relational_operator::in, "fe80::/10"), "00000010");
+  CHECK_EQUAL(lookup(relational_operator::in, "::/0"), "11111111");
+}
+
+TEST(top-k prefixes) {
+  auto top = idx.top_prefixes(8, 2);
+  REQUIRE_EQUAL(top.size(), 2u);
+  CHECK_EQUAL(top[0].first, unbox(to<subnet>("192.0.0.0/8")));
+  CHECK_EQUAL(top[0].second, 4u);
+  CHECK_EQUAL(top[1].first, unbox(to<subnet>("10.0.0.0/8")));
+  CHECK_EQUAL(top[1].second, 2u);
+  MESSAGE("the prefix length is capped at 32 for IPv4 addresses");
+  top = idx.top_prefixes(64, 10);
+  REQUIRE_EQUAL(top.size(), 7u);
+  CHECK_EQUAL(top[0].first, unbox(to<subnet>("192.168.0.1/32")));
+  CHECK_EQUAL(top[0].second, 2u);
+  CHECK_EQUAL(top[1].first, unbox(to<subnet>("::/64")));
+  CHECK_EQUAL(top[6].first, unbox(to<subnet>("fe80::/64")));
+  CHECK(idx.top_prefixes(8, 0).empty());
+}
+
+TEST(serialization) {
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, idx), caf::none);
+  address_prefix_index idx2{address_type{}};
+  CHECK_EQUAL(detail::deserialize(buf, idx2), caf::none);
+  // Unlike other indexes, this one supports appending after deserialization.
+  auto x = unbox(to<address>("10.1.1.1"));
+  CHECK(idx2.append(make_data_view(x), 10));
+  auto result = idx2.lookup(relational_operator::in,
+                            make_data_view(unbox(to<subnet>("10.0.0.0/8"))));
+  CHECK_EQUAL(to_string(unbox(result)), "01000100001");
+}
+
+TEST(factory construction) {
+  factory<value_index>::initialize();
+  auto t = address_type{}.attributes({{"index", "prefix"}});
+  auto ptr = factory<value_index>::make(t, caf::settings{});
+  CHECK(dynamic_cast<address_prefix_index*>(ptr.get()) != nullptr);
+}
+
+FIXTURE_SCOPE_END()
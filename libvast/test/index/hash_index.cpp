@@ -59,6 +59,45 @@ TEST(serialization) {
   CHECK(!y.append(make_data_view("foo")));
 }
 
+TEST(deserialization of the initial format) {
+  hash_index<1> x{string_type{}};
+  REQUIRE(x.append(make_data_view("foo")));
+  REQUIRE(x.append(make_data_view("bar")));
+  REQUIRE(x.append(make_data_view("baz")));
+  std::vector<char> buf;
+  REQUIRE(detail::serialize(buf, x) == caf::none);
+  MESSAGE("strip the format version and the directory");
+  std::vector<char> tail;
+  auto directory = std::vector<std::pair<uint64_t, uint64_t>>(3);
+  REQUIRE(detail::serialize(tail, uint8_t{1}, directory) == caf::none);
+  REQUIRE_GREATER(buf.size(), tail.size());
+  buf.resize(buf.size() - tail.size());
+  hash_index<1> y{string_type{}};
+  REQUIRE(detail::deserialize(buf, y) == caf::none);
+  auto result = y.lookup(relational_operator::equal, make_data_view("baz"));
+  CHECK_EQUAL(to_string(unbox(result)), "001");
+}
+
+TEST(lookups interleaved with appends) {
+  hash_index<2> idx{count_type{}};
+  std::string expected;
+  for (count i = 0; i < 1000; ++i) {
+    REQUIRE(idx.append(make_data_view(i % 7)));
+    expected += i % 7 == 3 ? '1' : '0';
+    // Every lookup must see the digests appended since the previous one.
+    if (i % 100 == 0) {
+      auto result = idx.lookup(relational_operator::equal,
+                               make_data_view(count{3}));
+      CHECK_EQUAL(to_string(unbox(result)), expected);
+    }
+  }
+  auto xs = list{count{3}, count{5}};
+  auto result = idx.lookup(relational_operator::in, make_data_view(xs));
+  CHECK_EQUAL(rank(unbox(result)), 286u);
+  result = idx.lookup(relational_operator::not_in, make_data_view(xs));
+  CHECK_EQUAL(rank(unbox(result)), 714u);
+}
+
 // The attribute #index=hash selects the hash_index implementation.
 TEST(factory construction and parameterization) {
   factory<value_index>::initialize();
@@ -103,6 +103,92 @@ TEST(string) {
   CHECK_EQUAL(to_string(unbox(result)), "0100010000");
 }
 
+TEST(string - ngrams) {
+  auto t = string_type{}.attributes({{"ngrams"}});
+  string_index idx{t};
+  REQUIRE(idx.append(make_data_view("www.example.com/index.html")));
+  REQUIRE(idx.append(make_data_view("foo.example.org")));
+  REQUIRE(idx.append(make_data_view("examples")));
+  REQUIRE(idx.append(make_data_view("bar")));
+  REQUIRE(idx.append(make_data_view("")));
+  REQUIRE(idx.append(make_data_view("xample.com")));
+  REQUIRE(idx.append(make_data_view("abcxbcd")));
+  auto result = idx.lookup(relational_operator::ni, make_data_view("example"));
+  CHECK_EQUAL(to_string(unbox(result)), "1110000");
+  result = idx.lookup(relational_operator::ni, make_data_view("ple.c"));
+  CHECK_EQUAL(to_string(unbox(result)), "1000010");
+  result = idx.lookup(relational_operator::ni, make_data_view("nothing"));
+  CHECK_EQUAL(to_string(unbox(result)), "0000000");
+  result = idx.lookup(relational_operator::not_ni, make_data_view("example"));
+  CHECK_EQUAL(to_string(unbox(result)), "0001111");
+  MESSAGE("the character index removes n-gram false positives");
+  result = idx.lookup(relational_operator::ni, make_data_view("abcd"));
+  CHECK_EQUAL(to_string(unbox(result)), "0000000");
+  result = idx.lookup(relational_operator::not_ni, make_data_view("abcd"));
+  CHECK_EQUAL(to_string(unbox(result)), "1111111");
+  MESSAGE("short substrings fall back to the character index");
+  result = idx.lookup(relational_operator::ni, make_data_view("ar"));
+  CHECK_EQUAL(to_string(unbox(result)), "0001000");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, idx), caf::none);
+  auto idx2 = string_index{t};
+  CHECK_EQUAL(detail::deserialize(buf, idx2), caf::none);
+  result = idx2.lookup(relational_operator::ni, make_data_view("example"));
+  CHECK_EQUAL(to_string(unbox(result)), "1110000");
+}
+
+TEST(string - ngrams beyond the maximum size) {
+  caf::settings opts;
+  opts["max-size"] = 10;
+  auto t = string_type{}.attributes({{"ngrams"}});
+  string_index idx{t, opts};
+  REQUIRE(idx.append(make_data_view("abcxbcd")));
+  REQUIRE(idx.append(make_data_view("0123456789abcd")));
+  REQUIRE(idx.append(make_data_view("0123456789abcxbcd")));
+  REQUIRE(idx.append(make_data_view("abcd")));
+  MESSAGE("strings longer than the maximum size remain candidates");
+  auto result = idx.lookup(relational_operator::ni, make_data_view("abcd"));
+  CHECK_EQUAL(to_string(unbox(result)), "0111");
+  result = idx.lookup(relational_operator::not_ni, make_data_view("abcd"));
+  CHECK_EQUAL(to_string(unbox(result)), "1110");
+}
+
+TEST(string - pattern prefilter) {
+  auto t = string_type{}.attributes({{"ngrams"}});
+  string_index idx{t};
+  REQUIRE(idx.append(make_data_view("Mozilla/5.0 (X11; Linux x86_64)")));
+  REQUIRE(idx.append(make_data_view("Mozilla/5.0 (Windows NT 10.0)")));
+  REQUIRE(idx.append(make_data_view("curl/7.68.0")));
+  REQUIRE(idx.append(make_data_view("Linux Mozilla")));
+  MESSAGE("candidates contain all required literals of the pattern");
+  auto rx = pattern{"Mozilla/5\\.0 .*Linux"};
+  auto result = idx.lookup(relational_operator::match, make_data_view(rx));
+  CHECK_EQUAL(to_string(unbox(result)), "1000");
+  rx = pattern{".*(Linux|Windows).*"};
+  result = idx.lookup(relational_operator::match, make_data_view(rx));
+  CHECK_EQUAL(to_string(unbox(result)), "1111");
+  MESSAGE("negated patterns yield all candidates");
+  rx = pattern{"curl/.*"};
+  result = idx.lookup(relational_operator::match, make_data_view(rx));
+  CHECK_EQUAL(to_string(unbox(result)), "0010");
+  result = idx.lookup(relational_operator::not_match, make_data_view(rx));
+  CHECK_EQUAL(to_string(unbox(result)), "1111");
+}
+
+TEST(string - pattern prefilter without ngrams) {
+  caf::settings opts;
+  opts["max-size"] = 10;
+  string_index idx{string_type{}, opts};
+  REQUIRE(idx.append(make_data_view("short")));
+  REQUIRE(idx.append(make_data_view("abcdefghijklmnop Linux")));
+  REQUIRE(idx.append(make_data_view("Linux box")));
+  MESSAGE("truncated strings remain candidates");
+  auto rx = pattern{".*Linux.*"};
+  auto result = idx.lookup(relational_operator::match, make_data_view(rx));
+  CHECK_EQUAL(to_string(unbox(result)), "011");
+}
+
 TEST(none values - string) {
   auto idx = factory<value_index>::make(string_type{}, caf::settings{});
   REQUIRE_NOT_EQUAL(idx, nullptr);
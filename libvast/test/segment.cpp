@@ -10,6 +10,9 @@
 
 #include "vast/segment.hpp"
 
+#include "vast/config.hpp"
+
+#include "vast/compression.hpp"
 #include "vast/detail/deserialize.hpp"
 #include "vast/detail/serialize.hpp"
 #include "vast/ids.hpp"
@@ -54,4 +57,27 @@ TEST(serialization) {
   CHECK_EQUAL(x.num_slices(), y->num_slices());
 }
 
+#if VAST_ENABLE_ARROW
+
+TEST(compression) {
+  segment_builder builder{1024, compression::zstd, 0};
+  for (auto& slice : zeek_conn_log)
+    if (auto err = builder.add(slice))
+      FAIL(err);
+  auto x = builder.finish();
+  auto uncompressed = x.memory_usage() - x.chunk()->size();
+  CHECK_LESS(x.chunk()->size(), uncompressed);
+  MESSAGE("reload the segment from its compressed representation");
+  auto y = unbox(segment::make(x.chunk()));
+  CHECK_EQUAL(y.id(), x.id());
+  CHECK_EQUAL(y.ids(), x.ids());
+  CHECK_EQUAL(y.num_slices(), zeek_conn_log.size());
+  auto slices = unbox(y.lookup(make_ids({0, 6, 19, 21})));
+  REQUIRE_EQUAL(slices.size(), 2u);
+  CHECK_EQUAL(slices[0], zeek_conn_log[0]);
+  CHECK_EQUAL(slices[1], zeek_conn_log[2]);
+}
+
+#endif // VAST_ENABLE_ARROW
+
 FIXTURE_SCOPE_END()
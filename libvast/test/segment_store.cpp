@@ -10,6 +10,7 @@
 
 #include "vast/segment_store.hpp"
 
+#include "vast/compression.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/detail/narrow.hpp"
@@ -190,6 +191,32 @@ TEST(sessionized extraction on filled segment store) {
   CHECK_EQUAL(slices[1].offset(), 16u);
 }
 
+TEST(segment extraction leaves persisted segments undecoded) {
+  auto segment_id = store->active_id();
+  put_cold(zeek_conn_log);
+  auto xs = make_ids({0, 6, 19, 21});
+  auto session = store->extract(xs);
+  auto next = unbox(session->next_segment());
+  auto chunk = caf::get_if<chunk_ptr>(&next);
+  REQUIRE(chunk != nullptr);
+  CHECK(!store->cached(segment_id));
+  CHECK(!session->next_segment());
+  MESSAGE("the caller decodes the segment and adds it to the cache");
+  auto x = unbox(segment::make(std::move(*chunk)));
+  auto slices = unbox(x.lookup(xs));
+  REQUIRE_EQUAL(slices.size(), 2u);
+  CHECK_EQUAL(slices[0].offset(), 0u);
+  CHECK_EQUAL(slices[1].offset(), 16u);
+  store->cache(std::move(x));
+  CHECK(store->cached(segment_id));
+  MESSAGE("cached segments yield their slices right away");
+  session = store->extract(xs);
+  next = unbox(session->next_segment());
+  auto cached = caf::get_if<std::vector<table_slice>>(&next);
+  REQUIRE(cached != nullptr);
+  CHECK_EQUAL(cached->size(), 2u);
+}
+
 TEST(erase on empty segment store) {
   erase(make_ids({0, 6, 19, 21}));
   auto slices = get(everything);
@@ -233,6 +260,19 @@ TEST(erase persisted segment) {
   CHECK_EQUAL(segment_files().size(), 0u);
 }
 
+TEST(erase compressed persisted segment) {
+  store = segment_store::make(directory / "segments", 512_KiB, 2,
+                              compression::zstd, 0);
+  REQUIRE(store != nullptr);
+  put_cold(zeek_conn_log);
+  CHECK_EQUAL(segment_files().size(), 1u);
+  CHECK(deep_compare(zeek_conn_log, get(everything)));
+  erase(everything);
+  CHECK_EQUAL(get(everything).size(), 0u);
+  store = nullptr;
+  CHECK_EQUAL(segment_files().size(), 0u);
+}
+
 TEST(erase single slice from active segment) {
   put(zeek_conn_log);
   erase(make_ids({{8, 16}}));
@@ -28,7 +28,8 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
   system::archive_actor a;
 
   fixture() {
-    a = self->spawn(system::archive, directory, 10, 1024 * 1024);
+    a = self->spawn(system::archive, directory, 10, 1024 * 1024,
+                    compression::none, 0, 2);
   }
 
   void push_to_archive(std::vector<table_slice> xs) {
@@ -90,4 +91,24 @@ TEST(archiving and querying) {
   self->send_exit(a, exit_reason::user_shutdown);
 }
 
+TEST(concurrent requests) {
+  push_to_archive(zeek_conn_log);
+  push_to_archive(zeek_dns_log);
+  MESSAGE("file two requests with different queries at once");
+  auto drop = query::make_extract(self, query::extract::drop_ids, expression{});
+  auto preserve
+    = query::make_extract(self, query::extract::preserve_ids, expression{});
+  self->send(a, drop, make_ids({{5, 15}}));
+  self->send(a, preserve, make_ids({{18, 30}}));
+  run();
+  size_t done = 0;
+  size_t total = 0;
+  self
+    ->do_receive([&](vast::atom::done) { ++done; },
+                 [&](table_slice slice) { total += slice.rows(); })
+    .until([&] { return done == 2; });
+  CHECK_EQUAL(total, (15u - 5) + (30 - 18));
+  self->send_exit(a, exit_reason::user_shutdown);
+}
+
 FIXTURE_SCOPE_END()
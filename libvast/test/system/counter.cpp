@@ -64,10 +64,11 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
     auto indexdir = directory / "index";
     archive = self->spawn(system::archive, directory / "archive",
                           defaults::system::segments,
-                          defaults::system::max_segment_size);
+                          defaults::system::max_segment_size,
+                          compression::none, 0, 1);
     index = self->spawn(system::index, archive, fs, indexdir,
                         defaults::import::table_slice_size, 100, 3, 1, indexdir,
-                        0.01);
+                        0.01, false, false, 1);
     client = sys.spawn(mock_client);
     // Fill the INDEX with 400 rows from the Zeek conn log.
     detail::spawn_container_source(sys, take(zeek_conn_log_full, 4), index);
@@ -9,12 +9,69 @@
 #define SUITE explorer
 
 #include "vast/system/spawn_explorer.hpp"
+
+#include "vast/command.hpp"
+#include "vast/defaults.hpp"
+#include "vast/system/explorer.hpp"
+#include "vast/system/query_status.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/test/fixtures/actor_system_and_events.hpp"
 #include "vast/test/test.hpp"
 #include "vast/time.hpp"
 
 #include <caf/settings.hpp>
+#include <caf/stateful_actor.hpp>
+
+#include <optional>
 
 using namespace std::chrono_literals;
+using namespace vast;
+
+namespace {
+
+struct mock_node_state {
+  std::vector<invocation> invocs;
+  static inline constexpr const char* name = "mock-node";
+};
+
+/// Answers every spawn request with an exporter that sends all given slices to
+/// its sink, regardless of the query.
+caf::behavior mock_node(caf::stateful_actor<mock_node_state>* self,
+                        std::vector<table_slice> results) {
+  return {
+    [=](atom::spawn, invocation invocation) {
+      self->state.invocs.push_back(std::move(invocation));
+      return self->spawn([=](caf::event_based_actor* exporter) {
+        auto sink = std::make_shared<caf::actor>();
+        return caf::behavior{
+          [=](atom::sink, const caf::actor& x) { *sink = x; },
+          [=](atom::run) {
+            for (const auto& slice : results)
+              exporter->send(*sink, slice);
+            exporter->quit();
+          },
+        };
+      });
+    },
+  };
+}
+
+struct fixture : fixtures::deterministic_actor_system_and_events {
+  fixture() {
+    node = sys.spawn(mock_node, zeek_conn_log);
+    run();
+  }
+
+  ~fixture() {
+    self->send_exit(aut, caf::exit_reason::user_shutdown);
+    self->send_exit(node, caf::exit_reason::user_shutdown);
+  }
+
+  caf::actor node;
+  caf::actor aut;
+};
+
+} // namespace
 
 TEST(explorer config) {
   {
@@ -67,3 +124,61 @@ TEST(explorer config) {
     CHECK_EQUAL(vast::system::explorer_validate_args(settings), caf::none);
   }
 }
+
+FIXTURE_SCOPE(explorer_tests, fixture)
+
+TEST(combined context queries) {
+  auto limits = system::explorer_state::event_limits{
+    defaults::explore::max_events, 0};
+  aut = sys.spawn(system::explorer, caf::actor_cast<system::node_actor>(node),
+                  limits, vast::duration{10s}, vast::duration{10s},
+                  std::string{"id.orig_h"});
+  self->send(aut, atom::provision_v,
+             caf::actor_cast<system::exporter_actor>(self));
+  self->send(aut, atom::sink_v, caf::actor_cast<caf::actor>(self));
+  run();
+  MESSAGE("send the results of the initial query");
+  self->send(aut, zeek_conn_log[0]);
+  self->send(aut, std::string{"exporter"}, system::query_status{});
+  run();
+  MESSAGE("the eight results merge into six time boxes and a single query");
+  auto& node_state = deref<caf::stateful_actor<mock_node_state>>(node).state;
+  REQUIRE_EQUAL(node_state.invocs.size(), 1u);
+  const auto& query = node_state.invocs[0].arguments[0];
+  auto num_disjuncts = size_t{1};
+  for (auto i = query.find(" || "); i != std::string::npos;
+       i = query.find(" || ", i + 1))
+    ++num_disjuncts;
+  CHECK_EQUAL(num_disjuncts, 6u);
+  MESSAGE("only events in the context of an initial result reach the sink");
+  size_t num_results = 0;
+  while (!self->mailbox().empty())
+    self->receive([&](table_slice slice) { num_results += slice.rows(); });
+  CHECK_EQUAL(num_results, 8u);
+}
+
+TEST(per-result limit per context) {
+  auto limits = system::explorer_state::event_limits{
+    defaults::explore::max_events, 1};
+  aut = sys.spawn(system::explorer, caf::actor_cast<system::node_actor>(node),
+                  limits, vast::duration{24h}, vast::duration{24h},
+                  std::optional<std::string>{});
+  self->send(aut, atom::provision_v,
+             caf::actor_cast<system::exporter_actor>(self));
+  self->send(aut, atom::sink_v, caf::actor_cast<caf::actor>(self));
+  run();
+  self->send(aut, zeek_conn_log[0]);
+  self->send(aut, std::string{"exporter"}, system::query_status{});
+  run();
+  MESSAGE("the combined query has no shared limit");
+  auto& node_state = deref<caf::stateful_actor<mock_node_state>>(node).state;
+  REQUIRE_EQUAL(node_state.invocs.size(), 1u);
+  CHECK(!caf::get_if(&node_state.invocs[0].options, "vast.export.max-events"));
+  MESSAGE("every context receives up to one event");
+  size_t num_results = 0;
+  while (!self->mailbox().empty())
+    self->receive([&](table_slice slice) { num_results += slice.rows(); });
+  CHECK_EQUAL(num_results, 8u);
+}
+
+FIXTURE_SCOPE_END()
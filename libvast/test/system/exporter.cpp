@@ -53,14 +53,15 @@ struct fixture : fixture_base {
   }
 
   void spawn_archive() {
-    archive = self->spawn(system::archive, directory / "archive", 1, 1024);
+    archive = self->spawn(system::archive, directory / "archive", 1, 1024,
+                          compression::none, 0, 1);
   }
 
   void spawn_index() {
     auto fs = self->spawn(system::posix_filesystem, directory);
     auto indexdir = directory / "index";
     index = self->spawn(system::index, archive, fs, indexdir, 10000, 5, 5, 1,
-                        indexdir, 0.01);
+                        indexdir, 0.01, false, false, 1);
   }
 
   void spawn_importer() {
@@ -28,6 +28,7 @@
 #include "vast/test/test.hpp"
 
 #include <filesystem>
+#include <set>
 
 using caf::after;
 using std::chrono_literals::operator""s;
@@ -50,10 +51,11 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
     auto archive_dir = directory / "archive";
     auto index_dir = directory / "index";
     archive
-      = self->spawn(system::archive, archive_dir, segments, max_segment_size);
+      = self->spawn(system::archive, archive_dir, segments, max_segment_size,
+                    compression::none, 0, 1);
     index = self->spawn(system::index, archive, fs, index_dir, slice_size,
                         in_mem_partitions, taste_count, num_query_supervisors,
-                        index_dir, meta_index_fp_rate);
+                        index_dir, meta_index_fp_rate, false, false, 1);
   }
 
   ~fixture() {
@@ -172,6 +174,22 @@ TEST(iterable integer query result) {
   CHECK_EQUAL(result, expected_result);
 }
 
+TEST(iterable integer query result with partition - local evaluation) {
+  state().partition_local_evaluation = true;
+  auto partitions = taste_count * 3;
+  MESSAGE("fill first " << partitions << " partitions");
+  auto slices = first_n(alternating_integers, partitions);
+  auto src = detail::spawn_container_source(sys, slices, archive, index);
+  run();
+  MESSAGE("query half of the values from evicted partitions");
+  auto [query_id, hits, scheduled] = query(":int == +1");
+  CHECK_EQUAL(hits, partitions);
+  CHECK_EQUAL(scheduled, taste_count);
+  size_t expected_result = slice_size * partitions / 2;
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(result, expected_result);
+}
+
 TEST(iterable zeek conn log query result) {
   MESSAGE("ingest conn.log slices");
   detail::spawn_container_source(sys, zeek_conn_log, archive, index);
@@ -205,4 +223,46 @@ TEST(iterable zeek conn log query result) {
   }
 }
 
+TEST(layout groups) {
+  auto conn_group = system::layout_group(zeek_conn_log[0], 3);
+  CHECK_LESS(conn_group, 3u);
+  for (const auto& slice : zeek_conn_log) {
+    CHECK_EQUAL(system::layout_group(slice, 1), 0u);
+    CHECK_EQUAL(system::layout_group(slice, 3), conn_group);
+    CHECK(system::active_partition_selector{}(
+      system::layout_group_filter{conn_group, 3}, slice));
+    CHECK(!system::active_partition_selector{}(
+      system::layout_group_filter{(conn_group + 1) % 3, 3}, slice));
+  }
+}
+
+TEST(concurrently active partitions) {
+  MESSAGE("spawn an index with three active partitions");
+  anon_send_exit(index, caf::exit_reason::user_shutdown);
+  run();
+  auto fs = self->spawn(system::posix_filesystem, directory);
+  auto index_dir = directory / "concurrent-index";
+  index = self->spawn(system::index, archive, fs, index_dir, slice_size,
+                      in_mem_partitions, taste_count, num_query_supervisors,
+                      index_dir, meta_index_fp_rate, false, false, 3);
+  run();
+  MESSAGE("ingest conn.log and dns.log slices");
+  auto slices = zeek_conn_log;
+  slices.insert(slices.end(), zeek_dns_log.begin(), zeek_dns_log.end());
+  detail::spawn_container_source(sys, rebase(std::move(slices)), archive,
+                                 index);
+  run();
+  auto groups = std::set<size_t>{system::layout_group(zeek_conn_log[0], 3),
+                                  system::layout_group(zeek_dns_log[0], 3)};
+  const auto& active_partitions = state().active_partitions;
+  REQUIRE_EQUAL(active_partitions.size(), 3u);
+  for (size_t group = 0; group < active_partitions.size(); ++group)
+    CHECK_EQUAL(active_partitions[group].actor != nullptr,
+                groups.count(group) != 0);
+  MESSAGE("query the active partitions");
+  auto [query_id, hits, scheduled] = query("service == \"dns\"");
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(result, 11u);
+}
+
 FIXTURE_SCOPE_END()
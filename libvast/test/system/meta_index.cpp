@@ -244,6 +244,15 @@ TEST(attribute extractor - type) {
   CHECK_EQUAL(lookup("#type !~ /x/"), ids);
 }
 
+TEST(conjunction - type and time) {
+  auto q = "#type == \"foo\" && :timestamp >= 1970-01-01+00:00:30.0";
+  CHECK_EQUAL(lookup(q), std::vector<uuid>{ids[2]});
+  q = ":timestamp <= 1970-01-01+00:00:30.0 && #type == \"foobar\"";
+  CHECK_EQUAL(lookup(q), std::vector<uuid>{ids[1]});
+  q = "#type == \"foo\" && :timestamp > 1970-01-01+00:01:39.0";
+  CHECK_EQUAL(lookup(q), empty());
+}
+
 TEST(meta index with bool synopsis) {
   MESSAGE("generate slice data and add it to the meta index");
   // FIXME: do we have to replace the meta index from the fixture with a new
@@ -0,0 +1,69 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE partition
+
+#include "vast/system/partition.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/detail/spawn_container_source.hpp"
+#include "vast/msgpack_table_slice_builder.hpp"
+#include "vast/partition_synopsis.hpp"
+#include "vast/system/posix_filesystem.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/test/fixtures/actor_system.hpp"
+#include "vast/test/test.hpp"
+#include "vast/uuid.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+using namespace vast;
+using namespace vast::system;
+
+FIXTURE_SCOPE(partition_tests, fixtures::deterministic_actor_system)
+
+TEST(closing the input stream persists the partition) {
+  auto fs = self->spawn(posix_filesystem, directory);
+  auto partition = sys.spawn(active_partition, uuid::random(), fs,
+                             caf::settings{}, caf::settings{}, store_actor{});
+  run();
+  MESSAGE("request persisting before any table slice arrives");
+  std::filesystem::path persist_path = "test-partition";
+  std::filesystem::path synopsis_path = "test-partition-synopsis";
+  auto rp = self->request(partition, caf::infinite, atom::persist_v,
+                          persist_path, synopsis_path);
+  // Consume all messages without triggering any timeouts. The partition must
+  // not poll for the end of its input stream with delayed messages.
+  sched.run();
+  CHECK_EQUAL(sched.trigger_timeouts(), 0u);
+  CHECK(self->mailbox().empty());
+  MESSAGE("stream a table slice and close the input");
+  auto layout = record_type{{"x", count_type{}}}.name("y");
+  auto builder = msgpack_table_slice_builder::make(layout);
+  REQUIRE(builder->add(0u));
+  auto slice = builder->finish();
+  slice.offset(0);
+  auto src = detail::spawn_container_source(
+    sys, std::vector<table_slice>{slice}, partition);
+  REQUIRE(src);
+  run();
+  rp.receive(
+    [](std::shared_ptr<partition_synopsis>& synopsis) {
+      CHECK_NOT_EQUAL(synopsis, nullptr);
+    },
+    [](const caf::error& err) { FAIL(err); });
+  CHECK(std::filesystem::exists(directory / persist_path));
+  CHECK(std::filesystem::exists(directory / synopsis_path));
+  self->send_exit(partition, caf::exit_reason::user_shutdown);
+  run();
+}
+
+FIXTURE_SCOPE_END()
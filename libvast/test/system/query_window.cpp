@@ -0,0 +1,56 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE query_window
+
+#include "vast/system/query_window.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace vast;
+using namespace vast::system;
+using namespace std::chrono_literals;
+
+TEST(growth until saturation) {
+  auto window = query_window{2, 64};
+  // Batches of up to 16 partitions take 100ms; beyond that, the batch latency
+  // grows linearly with the batch size.
+  auto run_batch = [&] {
+    auto n = window.size();
+    auto latency = duration{100ms} * std::max(1, static_cast<int>(n) / 16);
+    window.complete(n, latency, false);
+  };
+  run_batch();
+  CHECK_EQUAL(window.size(), 4u);
+  run_batch();
+  run_batch();
+  CHECK_EQUAL(window.size(), 16u);
+  run_batch();
+  CHECK_EQUAL(window.size(), 32u);
+  // The per-partition latency stalls, so we only probe additively.
+  run_batch();
+  CHECK_EQUAL(window.size(), 33u);
+  CHECK_EQUAL(window.partition_latency(), duration{100ms} / 16);
+}
+
+TEST(backpressure and degradation) {
+  auto window = query_window{8, 64};
+  window.complete(8, 80ms, false);
+  CHECK_EQUAL(window.size(), 16u);
+  window.complete(16, 80ms, true);
+  CHECK_EQUAL(window.size(), 8u);
+  // The per-partition latency doubles.
+  window.complete(8, 160ms, false);
+  CHECK_EQUAL(window.size(), 6u);
+  for (auto i = 0; i < 10; ++i)
+    window.complete(window.size(), 1s, true);
+  CHECK_EQUAL(window.size(), 1u);
+}
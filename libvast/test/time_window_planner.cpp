@@ -0,0 +1,104 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE time_window_planner
+
+#include "vast/time_window_planner.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace vast;
+using namespace std::chrono_literals;
+
+namespace {
+
+time at(duration d) {
+  return time{} + d;
+}
+
+std::vector<size_t> lookup(const time_window_planner::query& query,
+                           const data& key, time t) {
+  std::vector<size_t> result;
+  query.lookup(key, t, [&](size_t id) { result.push_back(id); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
+TEST(merging windows) {
+  auto planner = time_window_planner{"key", 2};
+  CHECK_EQUAL(planner.add(at(0s), at(10s), "a"), 0u);
+  CHECK_EQUAL(planner.add(at(5s), at(15s), "b"), 1u);
+  CHECK_EQUAL(planner.add(at(100s), at(110s), "a"), 2u);
+  CHECK_EQUAL(planner.add(at(20s), at(30s), "a"), 3u);
+  CHECK_EQUAL(planner.add(at(40s), at(50s), "c"), 4u);
+  CHECK_EQUAL(planner.size(), 5u);
+  auto queries = planner.plan();
+  CHECK_EQUAL(planner.size(), 0u);
+  MESSAGE("four merged ranges split into two queries");
+  REQUIRE_EQUAL(queries.size(), 2u);
+  CHECK_EQUAL(queries[0].size(), 3u);
+  CHECK_EQUAL(queries[1].size(), 2u);
+  const auto* ranges = caf::get_if<disjunction>(&queries[0].expr());
+  REQUIRE(ranges);
+  REQUIRE_EQUAL(ranges->size(), 2u);
+  MESSAGE("the keys of merged windows form a membership predicate");
+  const auto* merged = caf::get_if<conjunction>(&ranges->at(0));
+  REQUIRE(merged);
+  REQUIRE_EQUAL(merged->size(), 3u);
+  const auto* keys = caf::get_if<predicate>(&merged->at(2));
+  REQUIRE(keys);
+  CHECK_EQUAL(keys->op, relational_operator::in);
+  CHECK_EQUAL(caf::get<data>(keys->rhs), data{list{"a", "b"}});
+  const auto* single = caf::get_if<conjunction>(&ranges->at(1));
+  REQUIRE(single);
+  REQUIRE_EQUAL(single->size(), 3u);
+  keys = caf::get_if<predicate>(&single->at(2));
+  REQUIRE(keys);
+  CHECK_EQUAL(keys->op, relational_operator::equal);
+  MESSAGE("results map back to the windows that contain them");
+  using window_ids = std::vector<size_t>;
+  CHECK_EQUAL(lookup(queries[0], "a", at(7s)), window_ids{0});
+  CHECK_EQUAL(lookup(queries[0], "b", at(7s)), window_ids{1});
+  CHECK_EQUAL(lookup(queries[0], "b", at(25s)), window_ids{});
+  CHECK_EQUAL(lookup(queries[0], "a", at(25s)), window_ids{3});
+  CHECK_EQUAL(lookup(queries[0], "c", at(45s)), window_ids{});
+  CHECK_EQUAL(lookup(queries[1], "c", at(45s)), window_ids{4});
+  CHECK_EQUAL(lookup(queries[1], "a", at(110s)), window_ids{2});
+  MESSAGE("window IDs restart after planning");
+  CHECK_EQUAL(planner.add(at(0s), at(1s), "a"), 0u);
+}
+
+TEST(unbounded windows) {
+  auto planner = time_window_planner{};
+  planner.add(time::min(), time::max());
+  planner.add(time::min(), time::max());
+  auto queries = planner.plan();
+  REQUIRE_EQUAL(queries.size(), 1u);
+  CHECK_EQUAL(queries[0].size(), 2u);
+  CHECK(caf::holds_alternative<predicate>(queries[0].expr()));
+  CHECK_EQUAL(lookup(queries[0], data{}, at(42s)), (std::vector<size_t>{0, 1}));
+}
+
+TEST(overlapping windows of different size) {
+  auto planner = time_window_planner{"key"};
+  planner.add(at(0s), at(100s), "a");
+  planner.add(at(10s), at(20s), "a");
+  planner.add(at(150s), at(160s), "a");
+  auto queries = planner.plan();
+  REQUIRE_EQUAL(queries.size(), 1u);
+  const auto* ranges = caf::get_if<disjunction>(&queries[0].expr());
+  REQUIRE(ranges);
+  CHECK_EQUAL(ranges->size(), 2u);
+  CHECK_EQUAL(lookup(queries[0], "a", at(15s)), (std::vector<size_t>{0, 1}));
+  CHECK_EQUAL(lookup(queries[0], "a", at(50s)), (std::vector<size_t>{0}));
+}
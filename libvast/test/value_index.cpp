@@ -16,10 +16,14 @@
 #include "vast/concept/parseable/vast/subnet.hpp"
 #include "vast/concept/parseable/vast/time.hpp"
 #include "vast/concept/printable/to_string.hpp"
+#include "vast/chunk.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
 #include "vast/detail/deserialize.hpp"
 #include "vast/detail/serialize.hpp"
+#include "vast/ewah_arena.hpp"
+#include "vast/span.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/table_slice_column.hpp"
 #include "vast/test/fixtures/events.hpp"
 #include "vast/test/test.hpp"
 #include "vast/value_index_factory.hpp"
@@ -104,9 +108,86 @@ TEST(integer) {
   less_than_leet
     = idx2->lookup(relational_operator::less, make_data_view(integer{31337}));
   CHECK(to_string(unbox(less_than_leet)) == "1111011");
+  MESSAGE("serialization with out-of-line bitmap blocks");
+  buf.clear();
+  ewah_arena writer;
+  {
+    auto guard = writer.activate();
+    CHECK_EQUAL(detail::serialize(buf, idx), caf::none);
+  }
+  auto blocks
+    = std::vector<uint64_t>(writer.blocks().begin(), writer.blocks().end());
+  REQUIRE(!blocks.empty());
+  auto blocks_chunk = chunk::make(as_bytes(span<const uint64_t>{blocks}),
+                                  []() noexcept {});
+  value_index_ptr idx3;
+  {
+    auto reader = ewah_arena{blocks_chunk, span<const uint64_t>{blocks}};
+    auto guard = reader.activate();
+    REQUIRE_EQUAL(detail::deserialize(buf, idx3), caf::none);
+  }
+  less_than_leet
+    = idx3->lookup(relational_operator::less, make_data_view(integer{31337}));
+  CHECK(to_string(unbox(less_than_leet)) == "1111011");
+  MESSAGE("modifying a deserialized index leaves the arena intact");
+  auto before = blocks;
+  REQUIRE(idx3->append(make_data_view(integer{1})));
+  less_than_leet
+    = idx3->lookup(relational_operator::less, make_data_view(integer{31337}));
+  CHECK(to_string(unbox(less_than_leet)) == "11110111");
+  CHECK(blocks == before);
 }
 
 // This was the first attempt in figuring out where the bug sat. It didn't fire.
+TEST(bulk append of table slice columns) {
+  auto fields = std::vector<std::string_view>{
+    "ts", "id.orig_h", "id.orig_p", "service", "duration", "orig_bytes"};
+  for (auto field : fields) {
+    MESSAGE("append column " << field);
+    auto column_type = type{};
+    value_index_ptr single;
+    value_index_ptr bulk;
+    auto values = std::vector<data>{};
+    id offset = 0;
+    for (auto slice : zeek_conn_log) {
+      slice.offset(offset);
+      offset += slice.rows();
+      auto column = unbox(table_slice_column::make(slice, field));
+      if (!single) {
+        column_type = column.field().type;
+        single = factory<value_index>::make(column_type, caf::settings{});
+        bulk = factory<value_index>::make(column_type, caf::settings{});
+        REQUIRE_NOT_EQUAL(single, nullptr);
+        REQUIRE_NOT_EQUAL(bulk, nullptr);
+      }
+      for (size_t i = 0; i < column.size(); ++i) {
+        REQUIRE(single->append(column[i], slice.offset() + i));
+        values.push_back(materialize(column[i]));
+      }
+      REQUIRE(bulk->append(column));
+    }
+    REQUIRE_EQUAL(single->offset(), bulk->offset());
+    for (const auto& x : values) {
+      auto op = relational_operator::equal;
+      auto expected = unbox(single->lookup(op, make_view(x)));
+      auto result = unbox(bulk->lookup(op, make_view(x)));
+      CHECK_EQUAL(to_string(result), to_string(expected));
+    }
+  }
+}
+
+TEST(bulk append without run support) {
+  auto idx = factory<value_index>::make(subnet_type{}, caf::settings{});
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  auto xs = std::vector<integer::value_type>{1, 2, 3};
+  auto run = value_index::value_run{
+    span<const integer::value_type>{xs.data(), xs.size()}};
+  auto result = idx->append_run(run, 0);
+  REQUIRE(!result);
+  CHECK_EQUAL(result.error(), ec::unimplemented);
+  CHECK_EQUAL(idx->offset(), 0u);
+}
+
 TEST(regression - checking the result single bitmap) {
   ewah_bitmap bm;
   bm.append<0>(680);
@@ -12,8 +12,10 @@
 #include "vast/binner.hpp"
 #include "vast/coder.hpp"
 #include "vast/detail/order.hpp"
+#include "vast/span.hpp"
 
 #include <type_traits>
+#include <vector>
 
 namespace vast {
 
@@ -63,6 +65,16 @@ public:
     coder_.encode(transform(binner_type::bin(x)), n);
   }
 
+  /// Appends a sequence of values to the bitmap index, encoding them in bulk.
+  /// @param xs The values to append.
+  void append(span<const value_type> xs) {
+    using coder_value_type = typename coder_type::value_type;
+    auto values = std::vector<coder_value_type>(xs.size());
+    for (size_t i = 0; i < xs.size(); ++i)
+      values[i] = transform(binner_type::bin(xs[i]));
+    coder_.encode(span<const coder_value_type>{values.data(), values.size()});
+  }
+
   /// Appends the contents of another bitmap index to this one.
   /// @param other The other bitmap index.
   void append(const bitmap_index& other) {
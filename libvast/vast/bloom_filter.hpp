@@ -10,14 +10,19 @@
 
 #include "vast/bitvector.hpp"
 #include "vast/bloom_filter_parameters.hpp"
+#include "vast/detail/assert.hpp"
 #include "vast/detail/operators.hpp"
 #include "vast/hasher.hpp"
 #include "vast/logger.hpp"
+#include "vast/span.hpp"
 #include "vast/type.hpp"
+#include "vast/word.hpp"
 
 #include <caf/meta/load_callback.hpp>
 #include <caf/meta/type_name.hpp>
 
+#include <algorithm>
+#include <array>
 #include <climits>
 #include <cstddef>
 #include <numeric>
@@ -30,11 +35,81 @@ namespace vast::policy {
 
 /// A policy that controls the cell layout of a Bloom filter.
 /// If `yes`, the Bloom filter bits are split into *k* equi-distant partitions.
+/// If `blocked`, the Bloom filter bits are split into blocks of 512 bits, and
+/// all bits of an element fall into the same block. This trades a slightly
+/// higher false-positive rate for touching only a single cache line per
+/// operation.
 /// @relates bloom_filter
-enum class partitioning { yes, no };
+enum class partitioning { yes, no, blocked };
 
 } // namespace vast::policy
 
+namespace vast::detail {
+
+/// The number of bits per block for the blocked partitioning policy.
+inline constexpr size_t bloom_filter_block_size = 512;
+
+/// Computes the position of a bit in a Bloom filter.
+/// @param i The index of the digest that determines the bit.
+/// @param xs The digests of an element.
+/// @param size The number of bits of the Bloom filter.
+/// @relates bloom_filter
+template <policy::partitioning Partitioning, class Digests>
+size_t bloom_filter_position([[maybe_unused]] size_t i, const Digests& xs,
+                             size_t size) {
+  if constexpr (Partitioning == policy::partitioning::no)
+    return xs[i] % size;
+  if constexpr (Partitioning == policy::partitioning::yes) {
+    auto num_partition_cells = size / xs.size();
+    return i * num_partition_cells + (xs[i] % num_partition_cells);
+  }
+  if constexpr (Partitioning == policy::partitioning::blocked) {
+    // The bits of the first digest that do not determine the position within
+    // the block select the block.
+    constexpr auto block_size = bloom_filter_block_size;
+    auto block = (xs[0] / block_size) % (size / block_size);
+    return block * block_size + xs[i] % block_size;
+  }
+}
+
+/// Tests whether all bits of an element are set in a Bloom filter.
+/// @param xs The digests of the element.
+/// @param words The bits of the Bloom filter in words of 64 bits.
+/// @param size The number of bits of the Bloom filter.
+/// @relates bloom_filter
+template <policy::partitioning Partitioning, class Digests>
+bool bloom_filter_lookup(const Digests& xs, const uint64_t* words,
+                         size_t size) {
+  using word_type = word<uint64_t>;
+  if constexpr (Partitioning == policy::partitioning::blocked) {
+    // Assemble the bits of the element into a mask for its block first, so
+    // that the final comparison is a branch-free loop over the words of a
+    // single cache line that compilers can vectorize.
+    constexpr auto block_words = bloom_filter_block_size / word_type::width;
+    std::array<uint64_t, block_words> mask = {};
+    for (size_t i = 0; i < xs.size(); ++i) {
+      auto bit = xs[i] % bloom_filter_block_size;
+      mask[bit / word_type::width] |= word_type::mask(bit % word_type::width);
+    }
+    auto first = bloom_filter_position<Partitioning>(0, xs, size)
+                 / bloom_filter_block_size * block_words;
+    auto missing = uint64_t{0};
+    for (size_t i = 0; i < block_words; ++i)
+      missing |= mask[i] & ~words[first + i];
+    return missing == 0;
+  } else {
+    for (size_t i = 0; i < xs.size(); ++i) {
+      auto bit = bloom_filter_position<Partitioning>(i, xs, size);
+      auto word = words[bit / word_type::width];
+      if ((word & word_type::mask(bit % word_type::width)) == 0)
+        return false;
+    }
+    return true;
+  }
+}
+
+} // namespace vast::detail
+
 namespace vast {
 
 /// A data structure for probabilistic set membership.
@@ -51,12 +126,26 @@ public:
 
   static constexpr policy::partitioning partitioning_policy = Partitioning;
 
+  /// The number of bits per block for the blocked partitioning policy.
+  static constexpr size_t block_size = detail::bloom_filter_block_size;
+
   /// Constructs a Bloom filter with a fixed size and a hasher.
   /// @param size The number of cells/bits in the Bloom filter.
   /// @param hasher The hasher type to generate digests.
+  /// @pre `size % block_size == 0` for the blocked partitioning policy.
   explicit bloom_filter(size_t size = 0, hasher_type hasher = hasher_type{})
     : hasher_{std::move(hasher)}, bits_(size) {
-    // nop
+    if constexpr (partitioning_policy == policy::partitioning::blocked)
+      VAST_ASSERT(size % block_size == 0);
+  }
+
+  /// Constructs a Bloom filter from existing bits.
+  /// @param hasher The hasher type to generate digests.
+  /// @param bits The bits of the Bloom filter.
+  bloom_filter(hasher_type hasher, bitvector<uint64_t> bits)
+    : hasher_{std::move(hasher)}, bits_{std::move(bits)} {
+    if constexpr (partitioning_policy == policy::partitioning::blocked)
+      VAST_ASSERT(bits_.size() % block_size == 0);
   }
 
   /// Adds an element to the Bloom filter.
@@ -67,7 +156,7 @@ public:
     auto& digests = hasher_(std::forward<T>(x));
     auto unique = false;
     for (size_t i = 0; i < digests.size(); ++i) {
-      auto bit = bits_[position(i, digests[i])];
+      auto bit = bits_[position(i, digests)];
       unique |= bit == false;
       bit = true;
     }
@@ -81,10 +170,8 @@ public:
   template <class T>
   bool lookup(T&& x) const {
     auto& digests = hasher_(std::forward<T>(x));
-    for (size_t i = 0; i < digests.size(); ++i)
-      if (!bits_[position(i, digests[i])])
-        return false;
-    return true;
+    return detail::bloom_filter_lookup<Partitioning>(
+      digests, bits_.blocks().data(), bits_.size());
   }
 
   /// @returns The number of cells in the underlying bit vector.
@@ -102,6 +189,16 @@ public:
     return hasher_.size();
   }
 
+  /// @returns The hasher.
+  [[nodiscard]] const hasher_type& hasher() const {
+    return hasher_;
+  }
+
+  /// @returns The underlying bit vector.
+  [[nodiscard]] const bitvector<uint64_t>& bits() const {
+    return bits_;
+  }
+
   // -- concepts --------------------------------------------------------------
 
   friend bool operator==(const bloom_filter& x, const bloom_filter& y) {
@@ -122,20 +219,87 @@ public:
   }
 
 private:
-  template <class Digest>
-  size_t position([[maybe_unused]] size_t i, Digest x) const {
-    if constexpr (partitioning_policy == policy::partitioning::no)
-      return x % bits_.size();
-    if constexpr (partitioning_policy == policy::partitioning::yes) {
-      auto num_partition_cells = bits_.size() / hasher_.size();
-      return i * num_partition_cells + (x % num_partition_cells);
-    }
+  template <class Digests>
+  size_t position(size_t i, const Digests& xs) const {
+    return detail::bloom_filter_position<Partitioning>(i, xs, bits_.size());
   }
 
   hasher_type hasher_;
   bitvector<uint64_t> bits_;
 };
 
+/// A read-only Bloom filter whose bits live in memory that it does not own,
+/// e.g., a memory-mapped file. It answers lookups exactly like the
+/// ::bloom_filter with the same hasher and bits.
+/// @tparam HashFunction The hash function to use in the hasher.
+/// @tparam Hasher The hasher type to generate digests.
+/// @tparam Partitioning The partitioning policy.
+template <class HashFunction, template <class> class Hasher = double_hasher,
+          policy::partitioning Partitioning = policy::partitioning::no>
+class bloom_filter_view {
+public:
+  using hash_function = HashFunction;
+  using hasher_type = Hasher<hash_function>;
+  using bloom_filter_type = bloom_filter<HashFunction, Hasher, Partitioning>;
+
+  /// Constructs a view on the bits of a Bloom filter.
+  /// @param hasher The hasher type to generate digests.
+  /// @param words The bits of the Bloom filter in words of 64 bits.
+  /// @param size The number of bits.
+  /// @pre `words.size() * 64 >= size`
+  bloom_filter_view(hasher_type hasher, span<const uint64_t> words,
+                    size_t size)
+    : hasher_{std::move(hasher)}, words_{words}, size_{size} {
+    VAST_ASSERT(words_.size() * word<uint64_t>::width >= size_);
+  }
+
+  /// Test whether an element exists in the Bloom filter.
+  /// @param x The element to test.
+  /// @returns `false` if the *x* is not in the set and `true` if *x* may exist
+  ///          according to the false-positive probability of the filter.
+  template <class T>
+  bool lookup(T&& x) const {
+    auto& digests = hasher_(std::forward<T>(x));
+    return detail::bloom_filter_lookup<Partitioning>(digests, words_.data(),
+                                                     size_);
+  }
+
+  /// @returns The number of cells.
+  [[nodiscard]] size_t size() const {
+    return size_;
+  }
+
+  /// @returns The hasher.
+  [[nodiscard]] const hasher_type& hasher() const {
+    return hasher_;
+  }
+
+  /// @returns The bits of the Bloom filter in words of 64 bits.
+  [[nodiscard]] span<const uint64_t> words() const {
+    return words_;
+  }
+
+  /// Copies the viewed bits into an owning Bloom filter.
+  [[nodiscard]] bloom_filter_type materialize() const {
+    bitvector<uint64_t> bits;
+    bits.append_blocks(words_.begin(), words_.end());
+    bits.resize(size_);
+    return bloom_filter_type{hasher_, std::move(bits)};
+  }
+
+  friend bool
+  operator==(const bloom_filter_view& x, const bloom_filter_view& y) {
+    return x.hasher_ == y.hasher_ && x.size_ == y.size_
+           && std::equal(x.words_.begin(), x.words_.end(), y.words_.begin(),
+                         y.words_.end());
+  }
+
+private:
+  hasher_type hasher_;
+  span<const uint64_t> words_;
+  size_t size_;
+};
+
 /// Constructs a Bloom filter for a given set of parameters.
 /// @tparam HashFunction The hash function to use in the hasher.
 /// @tparam Hasher The hasher type to generate digests.
@@ -156,6 +320,10 @@ make_bloom_filter(bloom_filter_parameters xs, std::vector<size_t> seeds = {}) {
                VAST_ARG(ys->p));
     if (*ys->m == 0 || *ys->k == 0)
       return {};
+    if constexpr (Partitioning == policy::partitioning::blocked) {
+      constexpr auto block_size = result_type::block_size;
+      ys->m = (*ys->m + block_size - 1) / block_size * block_size;
+    }
     if (seeds.empty()) {
       if constexpr (std::is_same_v<hasher_type, double_hasher<HashFunction>>) {
         seeds = {0, 1};
@@ -8,27 +8,98 @@
 
 #pragma once
 
+#include "vast/address.hpp"
 #include "vast/bloom_filter.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
+#include "vast/error.hpp"
+#include "vast/fbs/synopsis.hpp"
+#include "vast/span.hpp"
 #include "vast/synopsis.hpp"
 #include "vast/type.hpp"
 
 #include <caf/deserializer.hpp>
+#include <caf/expected.hpp>
 #include <caf/optional.hpp>
 #include <caf/serializer.hpp>
+#include <flatbuffers/flatbuffers.h>
 
 #include <optional>
+#include <type_traits>
 
 namespace vast {
 
+namespace detail {
+
+/// Checks whether a Bloom filter synopsis has a native flatbuffer layout,
+/// which exists for addresses and strings hashed with xxhash64.
+template <class T, class HashFunction, policy::partitioning Partitioning>
+inline constexpr bool has_native_bloom_filter_layout
+  = std::is_same_v<HashFunction, xxhash64>
+    && (std::is_same_v<T, address> || std::is_same_v<T, std::string>)
+    && Partitioning != policy::partitioning::yes;
+
+/// Packs the state of a Bloom filter synopsis into a flatbuffer table.
+/// @param builder The builder to pack into.
+/// @param t The type of the synopsis.
+/// @param layout The partitioning policy of the Bloom filter.
+/// @param hasher The hasher of the Bloom filter.
+/// @param words The bits of the Bloom filter in words of 64 bits.
+/// @param size The number of bits of the Bloom filter.
+/// @pre `layout != policy::partitioning::yes`
+caf::expected<flatbuffers::Offset<fbs::bloom_filter_synopsis::v0>>
+pack_bloom_filter_synopsis(flatbuffers::FlatBufferBuilder& builder,
+                           const type& t, policy::partitioning layout,
+                           const double_hasher<xxhash64>& hasher,
+                           span<const uint64_t> words, size_t size);
+
+/// Evaluates a predicate against a Bloom filter or a view on one.
+template <class T, class BloomFilter>
+std::optional<bool> bloom_filter_synopsis_lookup(const BloomFilter& filter,
+                                                 relational_operator op,
+                                                 data_view rhs) {
+  switch (op) {
+    default:
+      return {};
+    case relational_operator::equal:
+      return filter.lookup(caf::get<view<T>>(rhs));
+    case relational_operator::in: {
+      if (auto xs = caf::get_if<view<list>>(&rhs)) {
+        for (auto x : **xs)
+          if (filter.lookup(caf::get<view<T>>(x)))
+            return true;
+        return false;
+      }
+      return {};
+    }
+  }
+}
+
+} // namespace detail
+
+/// The common base class of all synopses backed by a Bloom filter.
+class bloom_filter_synopsis_base : public synopsis {
+public:
+  using synopsis::synopsis;
+
+  /// Packs the synopsis into a flatbuffer table whose bits can be copied out
+  /// without going through the CAF deserializer.
+  /// @returns An error if the synopsis has no native flatbuffer layout.
+  [[nodiscard]] virtual caf::expected<
+    flatbuffers::Offset<fbs::bloom_filter_synopsis::v0>>
+  pack_native(flatbuffers::FlatBufferBuilder& builder) const = 0;
+};
+
 /// A Bloom filter synopsis.
-template <class T, class HashFunction>
-class bloom_filter_synopsis : public synopsis {
+template <class T, class HashFunction,
+          policy::partitioning Partitioning = policy::partitioning::no>
+class bloom_filter_synopsis : public bloom_filter_synopsis_base {
 public:
-  using bloom_filter_type = bloom_filter<HashFunction>;
+  using bloom_filter_type
+    = bloom_filter<HashFunction, double_hasher, Partitioning>;
   using hasher_type = typename bloom_filter_type::hasher_type;
 
   bloom_filter_synopsis(vast::type x, bloom_filter_type bf)
-    : synopsis{std::move(x)}, bloom_filter_{std::move(bf)} {
+    : bloom_filter_synopsis_base{std::move(x)}, bloom_filter_{std::move(bf)} {
     // nop
   }
 
@@ -38,21 +109,7 @@ public:
 
   [[nodiscard]] std::optional<bool>
   lookup(relational_operator op, data_view rhs) const override {
-    switch (op) {
-      default:
-        return {};
-      case relational_operator::equal:
-        return bloom_filter_.lookup(caf::get<view<T>>(rhs));
-      case relational_operator::in: {
-        if (auto xs = caf::get_if<view<list>>(&rhs)) {
-          for (auto x : **xs)
-            if (bloom_filter_.lookup(caf::get<view<T>>(x)))
-              return true;
-          return false;
-        }
-        return {};
-      }
-    }
+    return detail::bloom_filter_synopsis_lookup<T>(bloom_filter_, op, rhs);
   }
 
   [[nodiscard]] bool equals(const synopsis& other) const noexcept override {
@@ -74,8 +131,25 @@ public:
     return source(bloom_filter_);
   }
 
+  [[nodiscard]] caf::expected<
+    flatbuffers::Offset<fbs::bloom_filter_synopsis::v0>>
+  pack_native(flatbuffers::FlatBufferBuilder& builder) const override {
+    if constexpr (detail::has_native_bloom_filter_layout<T, HashFunction,
+                                                         Partitioning>) {
+      const auto& blocks = bloom_filter_.bits().blocks();
+      return detail::pack_bloom_filter_synopsis(
+        builder, this->type(), Partitioning, bloom_filter_.hasher(),
+        span<const uint64_t>{blocks.data(), blocks.size()},
+        bloom_filter_.size());
+    } else {
+      (void)builder;
+      return caf::make_error(ec::unimplemented, "no native flatbuffer layout "
+                                                "for Bloom filter synopsis");
+    }
+  }
+
 protected:
-  bloom_filter<HashFunction> bloom_filter_;
+  bloom_filter_type bloom_filter_;
 };
 
 // Because VAST deserializes a synopsis with empty options and
@@ -84,9 +158,22 @@ protected:
 
 /// Creates a new type annotation from a set of bloom filter parameters.
 /// @returns The provided type with a new `#synopsis=bloom_filter(n,p)`
-///          attribute. Note that all previous attributes are discarded.
+///          attribute. Note that all previous attributes except for
+///          `#synopsis-layout` are discarded.
 type annotate_parameters(type type, const bloom_filter_parameters& params);
 
+/// Checks whether a type asks for Bloom filters with the blocked partitioning
+/// policy via the attribute `#synopsis-layout=blocked`.
+/// @param x The type to check.
+/// @relates bloom_filter_synopsis
+bool has_blocked_layout(const type& x);
+
+/// Marks a type to use Bloom filters with the blocked partitioning policy.
+/// @param x The type to annotate.
+/// @returns *x* with the attribute `#synopsis-layout=blocked`.
+/// @relates bloom_filter_synopsis
+type annotate_blocked_layout(type x);
+
 /// Parses Bloom filter parameters from type attributes of the form
 /// `#synopsis=bloom_filter(n,p)`.
 /// @param x The type whose attributes to parse.
@@ -94,4 +181,10 @@ type annotate_parameters(type type, const bloom_filter_parameters& params);
 /// @relates bloom_filter_synopsis
 std::optional<bloom_filter_parameters> parse_parameters(const type& x);
 
+/// Unpacks a Bloom filter synopsis from its native flatbuffer layout.
+/// @param x The flatbuffer table to unpack.
+/// @param ptr The synopsis to unpack into, which owns a copy of the bits.
+/// @relates bloom_filter_synopsis
+caf::error unpack(const fbs::bloom_filter_synopsis::v0& x, synopsis_ptr& ptr);
+
 } // namespace vast
@@ -12,6 +12,8 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/operators.hpp"
 #include "vast/operator.hpp"
+#include "vast/span.hpp"
+#include "vast/word.hpp"
 
 #include <caf/meta/load_callback.hpp>
 #include <caf/meta/save_callback.hpp>
@@ -55,6 +57,11 @@ struct coder {
   /// @pre `Bitmap::max_size - size() >= n`
   void encode(value_type x, size_type n = 1);
 
+  /// Encodes a sequence of values, one value per row.
+  /// @param xs The values to encode.
+  /// @pre `Bitmap::max_size - size() >= xs.size()`
+  void encode(span<const value_type> xs);
+
   /// Decodes a value under a relational operator.
   /// @param x The value to decode.
   /// @param op The relation operator under which to decode *x*.
@@ -111,6 +118,19 @@ public:
     bitmap_.append_bits(x, n);
   }
 
+  void encode(span<const value_type> xs) {
+    VAST_ASSERT(Bitmap::max_size - size() >= xs.size());
+    using block_type = typename Bitmap::block_type;
+    constexpr auto width = size_t{word<block_type>::width};
+    for (size_t i = 0; i < xs.size(); i += width) {
+      auto n = std::min(xs.size() - i, width);
+      auto block = block_type{0};
+      for (size_t j = 0; j < n; ++j)
+        block |= block_type{xs[i + j]} << j;
+      bitmap_.append_block(block, n);
+    }
+  }
+
   [[nodiscard]] Bitmap decode(relational_operator op, value_type x) const {
     VAST_ASSERT(op == relational_operator::equal
                 || op == relational_operator::not_equal);
@@ -208,6 +228,34 @@ protected:
     size_ += other.size_;
   }
 
+  /// Appends one bit per value to a bitmap, assembling the bits a block at a
+  /// time. The bitmaps of a coder lazily omit trailing *fill* bits, so blocks
+  /// that consist of *fill* bits only are not appended at all.
+  /// @param index The index of the bitmap.
+  /// @param xs The values to encode.
+  /// @param fill The bit value that the bitmap implicitly ends with.
+  /// @param pred Computes the bit for a single value.
+  /// @pre `size()` does not yet account for *xs*.
+  template <class T, class Predicate>
+  void encode_blocks(size_t index, span<const T> xs, bool fill,
+                     Predicate pred) {
+    using block_type = typename Bitmap::block_type;
+    using word_type = word<block_type>;
+    auto& bm = bitmaps_[index];
+    for (size_t i = 0; i < xs.size(); i += word_type::width) {
+      auto n = std::min(xs.size() - i, size_t{word_type::width});
+      auto block = block_type{0};
+      for (size_t j = 0; j < n; ++j)
+        block |= block_type{pred(xs[i + j])} << j;
+      auto explicit_bits = (fill ? ~block : block) & word_type::lsb_fill(n);
+      if (explicit_bits == 0)
+        continue;
+      bm.append_bits(fill, size_ + i - bm.size());
+      bm.append_block(block, word_type::width
+                               - word_type::count_leading_zeros(explicit_bits));
+    }
+  }
+
   size_type size_;
   mutable std::vector<Bitmap> bitmaps_;
 };
@@ -245,6 +293,11 @@ public:
     this->size_ += n;
   }
 
+  void encode(span<const value_type> xs) {
+    for (auto x : xs)
+      encode(x);
+  }
+
   Bitmap decode(relational_operator op, value_type x) const {
     VAST_ASSERT(op == relational_operator::less
                 || op == relational_operator::less_equal
@@ -341,6 +394,13 @@ public:
     this->size_ += n;
   }
 
+  void encode(span<const value_type> xs) {
+    VAST_ASSERT(Bitmap::max_size - this->size_ >= xs.size());
+    for (auto i = 0u; i < this->bitmaps_.size(); ++i)
+      this->encode_blocks(i, xs, true, [=](value_type x) { return i >= x; });
+    this->size_ += xs.size();
+  }
+
   Bitmap decode(relational_operator op, value_type x) const {
     VAST_ASSERT(op == relational_operator::less
                 || op == relational_operator::less_equal
@@ -427,6 +487,14 @@ public:
     this->size_ += n;
   }
 
+  void encode(span<const value_type> xs) {
+    VAST_ASSERT(Bitmap::max_size - this->size_ >= xs.size());
+    for (auto i = 0u; i < this->bitmaps_.size(); ++i)
+      this->encode_blocks(i, xs, false,
+                          [=](value_type x) { return ((x >> i) & 1) == 0; });
+    this->size_ += xs.size();
+  }
+
   // RangeEval-Opt for the special case with uniform base 2.
   Bitmap decode(relational_operator op, value_type x) const {
     switch (op) {
@@ -546,6 +614,24 @@ public:
       coders_[i].encode(xs_[i], n);
   }
 
+  void encode(span<const value_type> xs) {
+    if (xs_.empty())
+      init();
+    // Decompose all values up front so that every coder encodes the digits
+    // of its level in a single pass.
+    auto n = xs.size();
+    auto digits = std::vector<value_type>(base_.size() * n);
+    for (size_t j = 0; j < n; ++j) {
+      auto x = xs[j];
+      for (auto i = 0u; i < base_.size(); ++i) {
+        digits[i * n + j] = x % base_[i];
+        x /= base_[i];
+      }
+    }
+    for (auto i = 0u; i < base_.size(); ++i)
+      coders_[i].encode(span<const value_type>{digits.data() + i * n, n});
+  }
+
   auto decode(relational_operator op, value_type x) const {
     return coders_.empty() ? bitmap_type{} : decode(coders_, op, x);
   }
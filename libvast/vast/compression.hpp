@@ -0,0 +1,61 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/span.hpp"
+
+#include <caf/expected.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace vast {
+
+/// A block compression algorithm. The values match the `Compression` enum in
+/// `segment.fbs`.
+enum class compression : uint8_t {
+  none,
+  lz4,
+  zstd,
+};
+
+/// @relates compression
+const char* to_string(compression x) noexcept;
+
+/// Parses the name of a compression algorithm.
+/// @param name One of `none`, `lz4`, or `zstd`.
+/// @relates compression
+caf::expected<compression> parse_compression(std::string_view name);
+
+/// Compresses a block of bytes.
+/// @param method The compression algorithm.
+/// @param level The compression level, where 0 selects the default level of
+///        the algorithm.
+/// @param xs The bytes to compress.
+/// @returns The compressed bytes, or an error if the algorithm is unavailable.
+/// @pre `method != compression::none`
+caf::expected<std::vector<std::byte>>
+compress(compression method, int level, span<const std::byte> xs);
+
+/// Decompresses a block of bytes into a new chunk.
+/// @param method The compression algorithm.
+/// @param xs The compressed bytes.
+/// @param decompressed_size The exact size of the decompressed bytes.
+/// @returns The decompressed bytes, or an error if the algorithm is
+///          unavailable or *xs* is corrupt.
+/// @pre `method != compression::none`
+caf::expected<chunk_ptr> decompress(compression method,
+                                    span<const std::byte> xs,
+                                    size_t decompressed_size);
+
+} // namespace vast
@@ -28,6 +28,7 @@ struct access::parser<pattern> : vast::parser<access::parser<pattern>> {
 
   template <class Iterator>
   bool parse(Iterator& f, const Iterator& l, pattern& a) const {
+    a.regex_ = nullptr;
     return pattern_parser{}(f, l, a.str_);
   }
 };
@@ -61,6 +61,10 @@ constexpr std::chrono::milliseconds read_timeout
 /// Path for reading input events or `-` for reading from STDIN.
 constexpr std::string_view read = "-";
 
+/// Number of threads that parse a single line-based input stream. A value of
+/// 1 parses the input sequentially.
+constexpr size_t parser_threads = 1;
+
 /// Contains settings for the csv subcommand.
 struct csv {
   static constexpr char separator = ',';
@@ -97,8 +101,22 @@ constexpr size_t max_events_query = 100;
 /// Maximum number of results for every explored context.
 constexpr size_t max_events_context = 100;
 
+/// Maximum number of merged context windows that the explorer combines into a
+/// single query.
+constexpr size_t max_windows_per_query = 64;
+
 } // namespace explore
 
+// -- constants for the pivot command ------------------------------------------
+
+namespace pivot {
+
+/// Number of pivot values that the pivoter collects before it issues a query
+/// for the target type.
+constexpr size_t max_values_per_query = 1024;
+
+} // namespace pivot
+
 // -- constants for the export command and its subcommands ---------------------
 
 // Unfortunately, `export` is a reserved keyword. The trailing `_` exists only
@@ -214,6 +232,9 @@ constexpr std::chrono::seconds disk_scan_interval = std::chrono::minutes{1};
 /// Maximum number of events per INDEX partition.
 constexpr size_t max_partition_size = 1'048'576; // 1_Mi
 
+/// Number of concurrently active INDEX partitions.
+constexpr size_t active_partitions = 1;
+
 /// Maximum number of in-memory INDEX partitions.
 constexpr size_t max_in_mem_partitions = 10;
 
@@ -223,12 +244,26 @@ constexpr size_t taste_partitions = 5;
 /// Maximum number of concurrent INDEX queries.
 constexpr size_t num_query_supervisors = 10;
 
+/// Whether passive partitions evaluate queries synchronously instead of
+/// spawning EVALUATOR and INDEXER actors.
+constexpr bool partition_local_evaluation = false;
+
 /// Number of cached ARCHIVE segments.
 constexpr size_t segments = 10;
 
 /// Maximum size of ARCHIVE segments in MiB.
 constexpr size_t max_segment_size = 1'024;
 
+/// Compression algorithm of ARCHIVE segments.
+constexpr std::string_view segment_compression = "none";
+
+/// Compression level of ARCHIVE segments, where 0 selects the default level
+/// of the compression algorithm.
+constexpr int segment_compression_level = 0;
+
+/// Number of ARCHIVE workers that check segments concurrently.
+constexpr size_t archive_workers = 4;
+
 /// Number of initial IDs to request in the IMPORTER.
 constexpr size_t initially_requested_ids = 128;
 
@@ -260,6 +295,9 @@ constexpr double address_synopsis_fp_rate = 0.01;
 /// The allowed false positive rate for a string_synopsis.
 constexpr double string_synopsis_fp_rate = 0.01;
 
+/// Whether address and string synopses use cache-blocked Bloom filters.
+constexpr bool meta_index_blocked_bloom_filters = false;
+
 } // namespace system
 
 } // namespace vast::defaults
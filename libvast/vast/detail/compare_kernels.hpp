@@ -0,0 +1,88 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/operator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vast::detail {
+
+/// The instruction set extensions that the comparison kernels can use.
+enum class simd_level : uint8_t {
+  scalar, ///< Portable implementation without SIMD instructions.
+  sse4_2, ///< x86 SSE4.2 (128-bit registers).
+  avx2,   ///< x86 AVX2 (256-bit registers).
+};
+
+/// @relates simd_level
+const char* to_string(simd_level level) noexcept;
+
+/// Detects the best instruction set extension available on the current CPU.
+/// The result is computed once and cached afterwards.
+/// @returns The highest supported SIMD level.
+simd_level supported_simd_level() noexcept;
+
+/// Checks whether the comparison kernels support an operator.
+/// @param op The relational operator to check.
+/// @returns `true` iff *op* is one of `==`, `!=`, `<`, `<=`, `>`, and `>=`.
+bool has_compare_kernel(relational_operator op) noexcept;
+
+/// Compares a contiguous range of values against a literal and writes one bit
+/// per value into `out`, starting at the least significant bit of the first
+/// block. Bits beyond `n` in the last block are zero.
+/// @param level The instruction set extension to use.
+/// @param op The relational operator to apply as `xs[i] op x`.
+/// @param xs The values to compare.
+/// @param n The number of values in *xs*.
+/// @param x The literal to compare against.
+/// @param out The output blocks.
+/// @pre `has_compare_kernel(op)`
+/// @pre *out* has room for `(n + 63) / 64` blocks.
+void compare(simd_level level, relational_operator op, const int64_t* xs,
+             size_t n, int64_t x, uint64_t* out) noexcept;
+
+/// @copydoc compare
+void compare(simd_level level, relational_operator op, const uint64_t* xs,
+             size_t n, uint64_t x, uint64_t* out) noexcept;
+
+/// @copydoc compare
+void compare(simd_level level, relational_operator op, const double* xs,
+             size_t n, double x, uint64_t* out) noexcept;
+
+/// Checks for a contiguous range of 16-byte IPv6 addresses in network byte
+/// order whether they lie within a prefix, and writes one bit per address
+/// into `out` like `compare`. Exact address equality is the special case of a
+/// mask with all bits set.
+/// @param level The instruction set extension to use.
+/// @param xs The addresses to check, 16 bytes each.
+/// @param n The number of addresses in *xs*.
+/// @param network The network address of the prefix, 16 bytes.
+/// @param mask The netmask of the prefix, 16 bytes.
+/// @param out The output blocks.
+/// @pre *out* has room for `(n + 63) / 64` blocks.
+void mask_equal(simd_level level, const uint8_t* xs, size_t n,
+                const uint8_t* network, const uint8_t* mask,
+                uint64_t* out) noexcept;
+
+/// Dispatches to the best supported SIMD level.
+template <class T>
+void compare(relational_operator op, const T* xs, size_t n, T x,
+             uint64_t* out) noexcept {
+  compare(supported_simd_level(), op, xs, n, x, out);
+}
+
+/// Dispatches to the best supported SIMD level.
+inline void mask_equal(const uint8_t* xs, size_t n, const uint8_t* network,
+                       const uint8_t* mask, uint64_t* out) noexcept {
+  mask_equal(supported_simd_level(), xs, n, network, mask, out);
+}
+
+} // namespace vast::detail
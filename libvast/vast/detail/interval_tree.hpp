@@ -0,0 +1,146 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/detail/assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace vast::detail {
+
+/// A static interval tree that answers overlap queries over closed intervals.
+/// The intervals are sorted by their lower bound, and an implicit binary tree
+/// on top of them stores the largest upper bound per subtree. A query
+/// first bisects the candidates by lower bound and then descends only into
+/// subtrees that contain at least one interval reaching the query range,
+/// which yields *O(log n + k)* lookups for *k* results.
+/// Modifications invalidate the tree, which is lazily rebuilt on the next
+/// query. Only the intervals inserted since the last rebuild need sorting.
+/// @tparam Point The totally ordered type of the interval bounds.
+/// @tparam Value The type of the value associated with each interval.
+template <class Point, class Value>
+class interval_tree {
+public:
+  /// A closed interval `[lo, hi]` with an associated value.
+  struct entry {
+    Point lo;
+    Point hi;
+    Value value;
+  };
+
+  /// Adds an interval.
+  /// @param lo The lower bound of the interval.
+  /// @param hi The upper bound of the interval.
+  /// @param value The value to associate with the interval.
+  void insert(Point lo, Point hi, Value value) {
+    entries_.push_back(entry{std::move(lo), std::move(hi), std::move(value)});
+    dirty_ = true;
+  }
+
+  /// Removes all intervals associated with a value.
+  /// @param value The value to remove.
+  /// @returns The number of removed intervals.
+  size_t erase(const Value& value) {
+    auto pred = [&](const entry& x) { return x.value == value; };
+    // Removal preserves the relative order, so the sorted prefix shrinks by
+    // the number of removed intervals in it.
+    sorted_ -= static_cast<size_t>(
+      std::count_if(entries_.begin(), entries_.begin() + sorted_, pred));
+    auto i = std::remove_if(entries_.begin(), entries_.end(), pred);
+    auto result = static_cast<size_t>(std::distance(i, entries_.end()));
+    entries_.erase(i, entries_.end());
+    dirty_ = dirty_ || result > 0;
+    return result;
+  }
+
+  /// Invokes a function for every interval that overlaps with `[lo, hi]`,
+  /// i.e., for every interval `[x, y]` with `x <= hi && y >= lo`. The order
+  /// in which the function is invoked is unspecified.
+  /// @param lo The lower bound of the query range.
+  /// @param hi The upper bound of the query range.
+  /// @param f The function to invoke with the value of each interval.
+  template <class F>
+  void overlapping(const Point& lo, const Point& hi, F f) const {
+    if (entries_.empty())
+      return;
+    if (dirty_)
+      build();
+    // Only the intervals in [0, end) start at or before the query range ends.
+    auto end = static_cast<size_t>(
+      std::upper_bound(entries_.begin(), entries_.end(), hi,
+                       [](const Point& x, const entry& y) { return x < y.lo; })
+      - entries_.begin());
+    if (end > 0)
+      descend(1, 0, leaves_, end, lo, f);
+  }
+
+  /// @returns The number of intervals.
+  [[nodiscard]] size_t size() const noexcept {
+    return entries_.size();
+  }
+
+  /// @returns Whether the tree contains no intervals.
+  [[nodiscard]] bool empty() const noexcept {
+    return entries_.empty();
+  }
+
+private:
+  void build() const {
+    auto by_lo = [](const entry& x, const entry& y) { return x.lo < y.lo; };
+    auto mid = entries_.begin() + sorted_;
+    std::sort(mid, entries_.end(), by_lo);
+    std::inplace_merge(entries_.begin(), mid, entries_.end(), by_lo);
+    sorted_ = entries_.size();
+    leaves_ = 1;
+    while (leaves_ < entries_.size())
+      leaves_ *= 2;
+    // Padding leaves lie beyond the last interval and are never reported, but
+    // they must not raise the maximum of a subtree that has real intervals.
+    auto smallest = std::min_element(entries_.begin(), entries_.end(),
+                                     [](const entry& x, const entry& y) {
+                                       return x.hi < y.hi;
+                                     });
+    max_.assign(2 * leaves_, smallest->hi);
+    for (size_t i = 0; i < entries_.size(); ++i)
+      max_[leaves_ + i] = entries_[i].hi;
+    for (auto i = leaves_ - 1; i > 0; --i)
+      max_[i] = std::max(max_[2 * i], max_[2 * i + 1]);
+    dirty_ = false;
+  }
+
+  // Reports all intervals with an index in [first, last) ∩ [0, end) whose
+  // upper bound is at least `lo`.
+  template <class F>
+  void descend(size_t node, size_t first, size_t last, size_t end,
+               const Point& lo, F& f) const {
+    if (first >= end || max_[node] < lo)
+      return;
+    if (last - first == 1) {
+      VAST_ASSERT(first < entries_.size());
+      f(entries_[first].value);
+      return;
+    }
+    auto mid = first + (last - first) / 2;
+    descend(2 * node, first, mid, end, lo, f);
+    descend(2 * node + 1, mid, last, end, lo, f);
+  }
+
+  /// The intervals, of which the first `sorted_` ones are sorted by their
+  /// lower bound. Queries sort the remainder before using them.
+  mutable std::vector<entry> entries_;
+  mutable size_t sorted_ = 0;
+  mutable std::vector<Point> max_;
+  mutable size_t leaves_ = 0;
+  mutable bool dirty_ = false;
+};
+
+} // namespace vast::detail
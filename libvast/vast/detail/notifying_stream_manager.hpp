@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "vast/detail/type_traits.hpp"
 #include "vast/query_options.hpp"
 
 #include <caf/default_downstream_manager.hpp>
@@ -30,6 +31,20 @@ void notify_listeners_if_clean(State& st, const caf::stream_manager& mgr) {
   }
 }
 
+/// Detects whether a state provides a `handle_input_closed()` member function.
+template <class State>
+using input_closed_handler_t
+  = decltype(std::declval<State&>().handle_input_closed());
+
+/// Lets a state react to the closing of all inbound paths of its stage if it
+/// provides a `handle_input_closed()` member function.
+template <class State>
+void notify_input_closed([[maybe_unused]] State& st) {
+  if constexpr (std::experimental::is_detected_v<input_closed_handler_t,
+                                                 State>)
+    st.handle_input_closed();
+}
+
 // A custom stream manager that is able to notify when all data has been
 // processed. It relies on `Self->state` being a struct containing a function
 // `notify_flush_listeners()` and a vector `flush_listeners`, which means that
@@ -58,6 +73,7 @@ public:
 
   void input_closed(caf::error reason) override {
     super::input_closed(std::move(reason));
+    notify_input_closed(state());
     notify_listeners_if_clean(state(), *this);
   }
 
@@ -0,0 +1,74 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <string_view>
+#include <vector>
+
+namespace vast::detail {
+
+/// A range of non-empty lines that reads its input in large blocks. Unlike
+/// `line_range`, it does not copy every line into a separate string, but hands
+/// out views into its internal buffer. Every line is followed by at least
+/// `padding` readable bytes, which allows for passing lines to parsers that
+/// read past the end of their input, e.g., simdjson.
+class padded_line_range {
+public:
+  /// Constructs a line range.
+  /// @param input The stream to read from.
+  /// @param padding The number of readable bytes following every line.
+  /// @param capacity The initial size of the read buffer. The buffer grows
+  ///        when a single line does not fit.
+  padded_line_range(std::istream& input, size_t padding,
+                    size_t capacity = 1'048'576);
+
+  /// @returns The current line. The view remains valid until the next call
+  ///          to `next_timeout`.
+  [[nodiscard]] std::string_view get() const;
+
+  // This is only supported if input_ uses a detail::fdinbuf as its streambuf,
+  // otherwise the timeout is ignored. The returned bool only indicates if a
+  // timeout occurred, other errors still need to be checked by `done()`.
+  [[nodiscard]] bool next_timeout(std::chrono::milliseconds timeout);
+
+  template <class Rep, class Period = std::ratio<1>>
+  [[nodiscard]] bool next_timeout(std::chrono::duration<Rep, Period> timeout) {
+    return next_timeout(std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::move(timeout)));
+  }
+
+  [[nodiscard]] bool done() const;
+
+  [[nodiscard]] size_t line_number() const;
+
+private:
+  /// Extracts the next line from the buffer if it contains a line break.
+  bool extract();
+
+  /// Reads at least one byte unless the input is exhausted or the read times
+  /// out, and then everything that is available without blocking.
+  /// @returns Whether the read timed out.
+  bool fill(std::chrono::milliseconds timeout);
+
+  [[nodiscard]] size_t capacity() const;
+
+  std::istream& input_;
+  size_t padding_;
+  std::vector<char> buffer_;
+  size_t begin_ = 0;
+  size_t end_ = 0;
+  std::string_view line_;
+  size_t line_number_ = 0;
+  bool exhausted_ = false;
+};
+
+} // namespace vast::detail
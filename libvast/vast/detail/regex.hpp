@@ -0,0 +1,67 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <caf/expected.hpp>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vast::detail {
+
+/// A regular expression in ECMAScript syntax that is compiled once and
+/// matched many times. Expressions that describe a regular language compile
+/// into a finite automaton that matches in time linear in the length of the
+/// input. Expressions with backreferences, lookaheads, word boundaries, or
+/// other constructs beyond that fall back to `std::regex`.
+class regex {
+public:
+  /// Compiles a regular expression.
+  /// @param str The regular expression in ECMAScript syntax.
+  /// @returns The compiled expression, or `ec::syntax_error` if *str* is not a
+  ///          valid regular expression.
+  static caf::expected<regex> make(std::string_view str);
+
+  regex(regex&&) noexcept;
+
+  regex& operator=(regex&&) noexcept;
+
+  ~regex() noexcept;
+
+  /// Matches a string against the expression.
+  /// @param str The string to match.
+  /// @returns `true` if the expression matches exactly *str*.
+  [[nodiscard]] bool match(std::string_view str) const;
+
+  /// Searches the expression in a string.
+  /// @param str The string to search.
+  /// @returns `true` if the expression matches inside *str*.
+  [[nodiscard]] bool search(std::string_view str) const;
+
+  /// @returns Literals that every string matching the expression contains,
+  ///          ordered from the longest to the shortest literal. A substring
+  ///          index can use them to narrow down candidates before matching.
+  [[nodiscard]] const std::vector<std::string>&
+  required_literals() const noexcept;
+
+  /// @returns `true` if the expression compiled into a finite automaton
+  ///          rather than falling back to `std::regex`.
+  [[nodiscard]] bool is_automaton() const noexcept;
+
+private:
+  struct impl;
+
+  regex();
+
+  std::unique_ptr<impl> impl_;
+};
+
+} // namespace vast::detail
@@ -0,0 +1,79 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/span.hpp"
+
+#include <caf/error.hpp>
+#include <caf/fwd.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace vast {
+
+class ewah_bitmap;
+
+/// Stores the blocks of EWAH bitmaps out of line during (de)serialization.
+///
+/// While an arena is active on the current thread, serializing an
+/// `ewah_bitmap` appends its blocks to the arena and writes only their
+/// position. Conversely, deserializing an `ewah_bitmap` yields a bitmap that
+/// references its blocks in the arena instead of copying them. This allows for
+/// storing all bitmaps of a value index in a single aligned vector of a
+/// flatbuffer, and for using them in place from a memory-mapped file.
+class ewah_arena {
+public:
+  /// Restores the previously active arena on destruction.
+  class scope {
+  public:
+    explicit scope(ewah_arena* arena) noexcept;
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+    ~scope() noexcept;
+
+  private:
+    ewah_arena* previous_;
+  };
+
+  /// Constructs an empty arena that collects blocks during serialization.
+  ewah_arena() noexcept;
+
+  /// Constructs an arena that provides blocks for deserialization. Falls back
+  /// to copying the blocks if they are not suitably aligned.
+  /// @param chunk The chunk that owns the memory of *blocks*.
+  /// @param blocks The blocks that deserialized bitmaps reference, in little
+  ///        endian byte order.
+  ewah_arena(chunk_ptr chunk, span<const uint64_t> blocks);
+
+  /// @returns The blocks of the arena.
+  [[nodiscard]] span<const uint64_t> blocks() const noexcept;
+
+  /// Activates the arena for the current thread.
+  /// @returns A guard that deactivates the arena when it goes out of scope.
+  [[nodiscard]] scope activate() noexcept;
+
+  /// @returns The arena that is active for the current thread, if any.
+  static ewah_arena* current() noexcept;
+
+  /// Serializes a bitmap into the arena.
+  caf::error apply(caf::serializer& sink, ewah_bitmap& bm);
+
+  /// Deserializes a bitmap that references blocks in the arena.
+  caf::error apply(caf::deserializer& source, ewah_bitmap& bm);
+
+private:
+  std::vector<uint64_t> collected_;
+  chunk_ptr chunk_;
+  span<const uint64_t> view_;
+};
+
+} // namespace vast
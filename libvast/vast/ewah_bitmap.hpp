@@ -8,11 +8,20 @@
 
 #pragma once
 
+#include "vast/fwd.hpp"
+
 #include "vast/bitmap_base.hpp"
 #include "vast/bitvector.hpp"
+#include "vast/chunk.hpp"
 #include "vast/detail/operators.hpp"
+#include "vast/ewah_arena.hpp"
+#include "vast/span.hpp"
 #include "vast/word.hpp"
 
+#include <caf/fwd.hpp>
+
+#include <type_traits>
+
 namespace vast {
 
 template <class Block>
@@ -80,6 +89,9 @@ struct ewah_word : word<Block> {
 /// 1. The first block is a marker.
 /// 2. The last block is always dirty.
 ///
+/// A bitmap can also reference its blocks in memory that it does not own, e.g.,
+/// a memory-mapped file, when deserialized from an `ewah_arena`. Such a bitmap
+/// copies its blocks on the first modification.
 class ewah_bitmap : public bitmap_base<ewah_bitmap>,
                     detail::equality_comparable<ewah_bitmap> {
 public:
@@ -98,7 +110,7 @@ public:
 
   [[nodiscard]] size_t memusage() const;
 
-  [[nodiscard]] const block_vector& blocks() const;
+  [[nodiscard]] span<const block_type> blocks() const;
 
   // -- modifiers ------------------------------------------------------------
 
@@ -116,10 +128,28 @@ public:
 
   template <class Inspector>
   friend auto inspect(Inspector&f, ewah_bitmap& bm) {
+    if constexpr (std::is_same_v<Inspector, caf::serializer>
+                  || std::is_same_v<Inspector, caf::deserializer>)
+      if (auto* arena = ewah_arena::current())
+        return arena->apply(f, bm);
+    bm.detach();
     return f(bm.blocks_, bm.last_marker_, bm.num_bits_);
   }
 
 private:
+  friend class ewah_arena;
+
+  /// Constructs a bitmap that references blocks owned by a chunk.
+  /// @param chunk The owner of *blocks*.
+  /// @param blocks The EWAH-encoded blocks.
+  /// @param last_marker The position of the last marker in *blocks*.
+  /// @param num_bits The number of bits in the bitmap.
+  ewah_bitmap(chunk_ptr chunk, span<const block_type> blocks,
+              size_type last_marker, size_type num_bits);
+
+  /// Copies referenced blocks into owned memory before a modification.
+  void detach();
+
   /// Incorporates the most recent (complete) dirty block.
   /// @pre `num_bits_ % word_type::width == 0`
   void integrate_last_block();
@@ -132,6 +162,13 @@ private:
   block_vector blocks_;
   size_type last_marker_ = 0;
   size_type num_bits_ = 0;
+
+  /// The owner of the referenced blocks; `nullptr` if the bitmap owns its
+  /// blocks in `blocks_`.
+  chunk_ptr chunk_;
+
+  /// The referenced blocks; only valid if `chunk_` is set.
+  span<const block_type> view_;
 };
 
 class ewah_bitmap_range
@@ -11,20 +11,48 @@
 #include "vast/fwd.hpp"
 
 #include "vast/defaults.hpp"
+#include "vast/format/reader.hpp"
 #include "vast/format/writer.hpp"
+#include "vast/schema.hpp"
 #include "vast/type.hpp"
 
 #include <arrow/io/api.h>
+#include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 #include <caf/error.hpp>
 #include <caf/expected.hpp>
 
+#include <filesystem>
+#include <istream>
 #include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace vast::format::arrow {
 
-/// An Arrow writer.
+/// The key of the schema metadata that holds the serialized VAST layout.
+inline constexpr const char* layout_metadata_key = "VAST:layout";
+
+/// Creates the Arrow schema for a layout and stores the serialized layout in
+/// the schema metadata.
+/// @param layout The layout of the record batches.
+std::shared_ptr<::arrow::Schema> make_schema(const record_type& layout);
+
+/// Restores the layout from the metadata of an Arrow schema, or infers it from
+/// the Arrow types if the metadata lacks a layout.
+/// @param schema The Arrow schema.
+/// @param default_name The name of an inferred layout if the metadata has no
+///        "name" key.
+caf::expected<record_type>
+make_layout(const ::arrow::Schema& schema,
+            const std::string& default_name = "arrow");
+
+/// An Arrow writer. By default, the writer emits an Arrow IPC stream per
+/// layout. In file mode, it writes one Arrow IPC file with a random-access
+/// footer per layout into the directory given by `vast.export.write`. Arrow
+/// IPC files are also known as Feather V2 files.
 class writer : public format::writer {
 public:
   using output_stream_ptr = std::shared_ptr<::arrow::io::OutputStream>;
@@ -49,10 +77,80 @@ public:
   bool layout(const record_type& layout);
 
 private:
+  /// An open Arrow IPC file for a single layout.
+  struct file_state {
+    output_stream_ptr out;
+    batch_writer_ptr writer;
+  };
+
+  caf::error write_file(const table_slice& x);
+
   output_stream_ptr out_;
   record_type current_layout_;
   table_slice_builder_ptr current_builder_;
   batch_writer_ptr current_batch_writer_;
+
+  /// The target directory in file mode.
+  std::optional<std::filesystem::path> directory_;
+
+  /// The open files in file mode, keyed by layout name.
+  std::unordered_map<std::string, file_state> files_;
+};
+
+/// An Arrow reader for the Arrow IPC file and stream formats. The reader
+/// memory-maps input files and adopts their record batches as Arrow table
+/// slices without converting them value by value.
+/// Adapts a standard input stream to an Arrow input stream.
+class istream_input_stream;
+
+class reader : public format::reader {
+public:
+  using batch_ptr = std::shared_ptr<::arrow::RecordBatch>;
+
+  /// Constructs an Arrow reader.
+  /// @param options Additional options.
+  /// @param in The input stream to read from unless `vast.import.read` names
+  ///           a file, which the reader then maps into memory.
+  explicit reader(const caf::settings& options,
+                  std::unique_ptr<std::istream> in = nullptr);
+
+  ~reader() override;
+
+  void reset(std::unique_ptr<std::istream> in) override;
+
+  caf::error schema(vast::schema x) override;
+
+  vast::schema schema() const override;
+
+  const char* name() const override;
+
+protected:
+  caf::error
+  read_impl(size_t max_events, size_t max_slice_size, consumer& f) override;
+
+private:
+  /// Opens the input and detects whether it is an Arrow IPC file or stream.
+  caf::error open();
+
+  /// Advances to the next record batch of the input.
+  /// @returns `ec::end_of_input` after the last record batch.
+  caf::error next_batch();
+
+  /// Determines the layout of the current record batch from its schema.
+  caf::error update_layout(const std::shared_ptr<::arrow::Schema>& schema);
+
+  std::string input_;
+  std::unique_ptr<std::istream> in_;
+  std::shared_ptr<::arrow::io::RandomAccessFile> file_;
+  std::shared_ptr<istream_input_stream> in_stream_;
+  std::shared_ptr<::arrow::ipc::RecordBatchFileReader> file_reader_;
+  int next_file_batch_ = 0;
+  std::shared_ptr<::arrow::RecordBatchReader> stream_reader_;
+  batch_ptr batch_;
+  int64_t batch_offset_ = 0;
+  std::shared_ptr<::arrow::Schema> current_schema_;
+  record_type layout_;
+  vast::schema schema_;
 };
 
 } // namespace vast::format::arrow
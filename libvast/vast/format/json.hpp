@@ -13,7 +13,7 @@
 #include "vast/concept/hashable/hash_append.hpp"
 #include "vast/concept/hashable/xxhash.hpp"
 #include "vast/detail/flat_map.hpp"
-#include "vast/detail/line_range.hpp"
+#include "vast/detail/padded_line_range.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/error.hpp"
 #include "vast/format/multi_layout_reader.hpp"
@@ -29,6 +29,9 @@
 #include <chrono>
 #include <optional>
 #include <simdjson.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace vast::format::json {
 
@@ -47,6 +50,24 @@ private:
   bool numeric_durations_ = false;
 };
 
+/// The location of a field of a layout in a potentially nested JSON object.
+struct field_path {
+  /// The fully qualified name of the field, e.g., `id.orig_h`.
+  std::string key;
+
+  /// The positions of the dots that separate the nested names in `key`.
+  std::vector<size_t> separators;
+
+  /// The type of the field.
+  vast::type type;
+};
+
+/// Computes the locations of all fields of a layout once, so that they can be
+/// looked up in many JSON objects without splitting their names every time.
+/// @param layout The record type to compute the field paths for.
+/// @returns The paths to all leaf fields of *layout* in depth-first order.
+std::vector<field_path> make_field_paths(const record_type& layout);
+
 /// Adds a JSON object to a table slice builder according to a given layout.
 /// @param builder The builder to add the JSON object to.
 /// @param xs The JSON object to add to *builder.
@@ -55,6 +76,16 @@ private:
 caf::error add(table_slice_builder& bptr, const ::simdjson::dom::object& xs,
                const record_type& layout);
 
+/// Adds a JSON object to a table slice builder according to precomputed field
+/// paths of a layout.
+/// @param builder The builder to add the JSON object to.
+/// @param xs The JSON object to add to *builder.
+/// @param fields The paths to the fields of the layout of *builder*.
+/// @returns An error iff the operation failed.
+/// @relates make_field_paths
+caf::error add(table_slice_builder& bptr, const ::simdjson::dom::object& xs,
+               const std::vector<field_path>& fields);
+
 /// A reader for JSON data. It operates with a *selector* to determine the
 /// mapping of JSON object to the appropriate record type in the schema.
 template <class Selector>
@@ -93,7 +124,11 @@ private:
   // Parser is designed to be reused.
   ::simdjson::dom::parser json_parser_;
 
-  std::unique_ptr<detail::line_range> lines_;
+  // The lines are padded such that the parser can operate on them in place.
+  std::unique_ptr<detail::padded_line_range> lines_;
+
+  // Caches the field paths per layout name.
+  std::unordered_map<std::string, std::vector<field_path>> field_paths_;
   std::optional<size_t> proto_field_;
   std::vector<size_t> port_fields_;
   mutable size_t num_invalid_lines_ = 0;
@@ -115,11 +150,13 @@ template <class Selector>
 void reader<Selector>::reset(std::unique_ptr<std::istream> in) {
   VAST_ASSERT(in != nullptr);
   input_ = std::move(in);
-  lines_ = std::make_unique<detail::line_range>(*input_);
+  lines_ = std::make_unique<detail::padded_line_range>(
+    *input_, ::simdjson::SIMDJSON_PADDING);
 }
 
 template <class Selector>
 caf::error reader<Selector>::schema(vast::schema s) {
+  field_paths_.clear();
   return selector_.schema(std::move(s));
 }
 
@@ -175,7 +212,7 @@ caf::error reader<Selector>::read_impl(size_t max_events, size_t max_slice_size,
                  lines_->line_number());
       return ec::stalled;
     }
-    auto& line = lines_->get();
+    auto line = lines_->get();
     ++num_lines_;
     if (line.empty()) {
       // Ignore empty lines.
@@ -183,7 +220,10 @@ caf::error reader<Selector>::read_impl(size_t max_events, size_t max_slice_size,
                  lines_->line_number());
       continue;
     }
-    auto parse_result = json_parser_.parse(line);
+    // The line range guarantees the padding that simdjson needs, so we can
+    // parse the line in place without copying it first.
+    auto parse_result = json_parser_.parse(
+      reinterpret_cast<const uint8_t*>(line.data()), line.size(), false);
     if (parse_result.error() != ::simdjson::error_code::SUCCESS) {
       if (num_invalid_lines_ == 0)
         VAST_WARN("{} failed to parse line {}: {}",
@@ -205,7 +245,11 @@ caf::error reader<Selector>::read_impl(size_t max_events, size_t max_slice_size,
     bptr = builder(*layout);
     if (bptr == nullptr)
       return caf::make_error(ec::parse_error, "unable to get a builder");
-    if (auto err = add(*bptr, get_object_result.value(), *layout)) {
+    auto fields = field_paths_.find(layout->name());
+    if (fields == field_paths_.end())
+      fields
+        = field_paths_.emplace(layout->name(), make_field_paths(*layout)).first;
+    if (auto err = add(*bptr, get_object_result.value(), fields->second)) {
       if (err == ec::convert_error) {
         if (num_invalid_lines_ == 0)
           VAST_WARN("{} failed to convert value(s) in line {}: {}",
@@ -0,0 +1,109 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/detail/line_range.hpp"
+#include "vast/format/reader.hpp"
+#include "vast/schema.hpp"
+#include "vast/system/report.hpp"
+#include "vast/table_slice.hpp"
+
+#include <caf/error.hpp>
+
+#include <deque>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vast::format {
+
+/// A reader for line-based formats that splits its input into blocks of lines
+/// and parses the blocks concurrently, each with its own instance of the
+/// underlying reader. The resulting table slices retain the order of the
+/// input.
+class parallel_reader final : public reader {
+public:
+  /// Describes which lines every block must start with so that the
+  /// underlying reader can parse it independently.
+  enum class header_policy {
+    /// Every line stands for itself, e.g., for JSON or syslog.
+    none,
+    /// The first line of the input is a header, e.g., for CSV.
+    first_line,
+    /// Every `#separator` line starts a header that spans all consecutive
+    /// comment lines, e.g., for Zeek TSV.
+    zeek,
+  };
+
+  /// Creates a reader for a single block of input.
+  using reader_factory
+    = std::function<std::unique_ptr<reader>(std::unique_ptr<std::istream>)>;
+
+  /// Constructs a parallel reader.
+  /// @param options Additional options.
+  /// @param in The input stream.
+  /// @param factory Creates the reader that parses a single block.
+  /// @param headers The header policy of the underlying format.
+  /// @param num_workers The number of blocks to parse concurrently.
+  /// @pre `factory != nullptr && num_workers > 0`
+  parallel_reader(const caf::settings& options,
+                  std::unique_ptr<std::istream> in, reader_factory factory,
+                  header_policy headers, size_t num_workers);
+
+  ~parallel_reader() override;
+
+  void reset(std::unique_ptr<std::istream> in) override;
+
+  caf::error schema(vast::schema x) override;
+
+  [[nodiscard]] vast::schema schema() const override;
+
+  [[nodiscard]] const char* name() const override;
+
+  [[nodiscard]] vast::system::report status() const override;
+
+protected:
+  caf::error
+  read_impl(size_t max_events, size_t max_slice_size, consumer& f) override;
+
+private:
+  /// The result of parsing a single block.
+  struct block_result {
+    std::vector<table_slice> slices;
+    caf::error error;
+    vast::system::report report;
+  };
+
+  /// Splits the next part of the input into up to `num_workers_` blocks that
+  /// each start with the current header.
+  /// @param max_block_lines The maximum number of non-header lines per block.
+  /// @returns the blocks and whether reading timed out.
+  std::pair<std::vector<std::string>, bool>
+  split_input(size_t max_block_lines);
+
+  /// Parses a single block. This function runs on a worker thread.
+  block_result parse(std::string block, size_t max_slice_size) const;
+
+  reader_factory factory_;
+  header_policy headers_;
+  size_t num_workers_;
+  std::unique_ptr<reader> prototype_;
+  vast::schema schema_;
+  std::unique_ptr<std::istream> input_;
+  std::unique_ptr<detail::line_range> lines_;
+  std::string header_;
+  bool in_header_ = false;
+  std::deque<table_slice> pending_;
+  caf::error deferred_error_;
+  mutable vast::system::report report_;
+};
+
+} // namespace vast::format
@@ -170,6 +170,11 @@ public:
       xs[i] = d1 + i * d2;
   }
 
+  /// @returns The seeds of the two hash functions.
+  [[nodiscard]] std::vector<size_t> seeds() const {
+    return {seed1_, seed2_};
+  }
+
   // -- concepts -------------------------------------------------------------
 
   friend bool operator==(const double_hasher& x, const double_hasher& y) {
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "vast/address.hpp"
 #include "vast/bitmap_index.hpp"
 #include "vast/coder.hpp"
 #include "vast/error.hpp"
@@ -22,6 +23,7 @@
 
 #include <array>
 #include <cstdint>
+#include <vector>
 
 namespace vast {
 
@@ -40,9 +42,20 @@ public:
 private:
   bool append_impl(data_view x, id pos) override;
 
+  bool append_run_impl(const value_run& xs, id pos) override;
+
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  /// Looks up many addresses at once for `in` and `not_in`. Sorting the
+  /// addresses allows for walking them like a trie, such that every shared
+  /// prefix costs only a single intersection, and a prefix that matches no
+  /// rows prunes all addresses that start with it.
+  /// @param op Either `in` or `not_in`.
+  /// @param xs The addresses to look up.
+  caf::expected<ids>
+  lookup_addresses(relational_operator op, std::vector<address> xs) const;
+
   size_t memusage_impl() const override;
 
   std::array<byte_index, 16> bytes_;
@@ -0,0 +1,85 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/address.hpp"
+#include "vast/ewah_bitmap.hpp"
+#include "vast/ids.hpp"
+#include "vast/subnet.hpp"
+#include "vast/value_index.hpp"
+#include "vast/view.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+#include <tsl/robin_map.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vast {
+
+/// An index for IP addresses that keeps one bitmap of row postings per
+/// distinct address, together with a directory of the addresses in sorted
+/// order. All addresses in a subnet are adjacent in the directory, so
+/// answering a CIDR containment query takes a single binary search followed
+/// by a scan over the matching addresses. Unlike the ::address_index, its
+/// lookup cost does not grow with the prefix length, which makes it a good
+/// fit for columns that users mostly query by subnet. The attribute
+/// `#index=prefix` selects this index.
+class address_prefix_index : public value_index {
+public:
+  explicit address_prefix_index(vast::type t, caf::settings opts = {});
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  /// Finds the prefixes of a given length that cover the most rows.
+  /// @param length The prefix length, which is capped at 32 for IPv4
+  ///        addresses.
+  /// @param k The maximum number of prefixes to return.
+  /// @returns Up to *k* prefixes with their number of rows, ordered by
+  ///          descending number of rows and then by prefix.
+  [[nodiscard]] std::vector<std::pair<subnet, uint64_t>>
+  top_prefixes(uint8_t length, size_t k) const;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  caf::expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  size_t memusage_impl() const override;
+
+  /// Sorts the addresses added since the last lookup into the directory.
+  void update_directory() const;
+
+  /// Computes the union of the postings of all addresses in a subnet.
+  ids lookup_subnet(const subnet& x) const;
+
+  /// Retrieves the postings of an address.
+  ids lookup_address(const address& x) const;
+
+  /// The distinct addresses in the order of their first occurrence.
+  std::vector<address> addresses_;
+
+  /// The row postings for every entry in `addresses_`.
+  std::vector<ewah_bitmap> postings_;
+
+  /// Maps an address to its position in `addresses_`.
+  tsl::robin_map<address, size_t> positions_;
+
+  /// The positions of all addresses sorted by address.
+  mutable std::vector<size_t> directory_;
+};
+
+} // namespace vast
@@ -133,6 +133,19 @@ private:
     return caf::visit(f, d);
   }
 
+  bool append_run_impl(const value_run& xs, id pos) override {
+    if constexpr (std::is_same_v<T, bool>) {
+      return false;
+    } else {
+      auto run = caf::get_if<span<const value_type>>(&xs);
+      if (!run)
+        return false;
+      bmi_.skip(pos - bmi_.size());
+      bmi_.append(*run);
+      return true;
+    }
+  }
+
   [[nodiscard]] caf::expected<ids>
   lookup_impl(relational_operator op, data_view d) const override {
     auto f = detail::overload{
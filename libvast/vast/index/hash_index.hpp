@@ -15,9 +15,11 @@
 #include "vast/detail/overload.hpp"
 #include "vast/detail/stable_map.hpp"
 #include "vast/detail/type_traits.hpp"
+#include "vast/error.hpp"
 #include "vast/value_index.hpp"
 #include "vast/view.hpp"
 
+#include <caf/binary_deserializer.hpp>
 #include <caf/deserializer.hpp>
 #include <caf/expected.hpp>
 #include <caf/serializer.hpp>
@@ -30,6 +32,7 @@
 #include <cstring>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_set>
 #include <vector>
@@ -61,6 +64,10 @@ class hash_index : public value_index {
   /// The maximum number of hash rounds to try to find a new digest.
   static constexpr size_t max_hash_rounds = 32;
 
+  /// The version of the serialized format. Version 1 adds the sorted digest
+  /// directory, so that lookups after loading need no sort.
+  static constexpr uint8_t format_version = 1;
+
 public:
   using hasher_type = xxhash64;
   using digest_type = std::array<std::byte, Bytes>;
@@ -92,13 +99,38 @@ public:
     for (auto& [k, v] : seeds_)
       if (v > 0)
         non_null_seeds.emplace(k, v);
-    return caf::error::eval([&] { return value_index::serialize(sink); },
-                            [&] { return sink(digests_, non_null_seeds); });
+    update_directory();
+    return caf::error::eval(
+      [&] { return value_index::serialize(sink); },
+      [&] { return sink(digests_, non_null_seeds); },
+      [&] { return sink(format_version, directory_); });
   }
 
   caf::error deserialize(caf::deserializer& source) override {
-    return caf::error::eval([&] { return value_index::deserialize(source); },
-                            [&] { return source(digests_, seeds_); });
+    directory_.clear();
+    auto err = caf::error::eval(
+      [&] { return value_index::deserialize(source); },
+      [&] { return source(digests_, seeds_); });
+    if (err)
+      return err;
+    // Indexes in the initial format end after the seeds and rebuild their
+    // directory on the first lookup.
+    auto binary_source = dynamic_cast<caf::binary_deserializer*>(&source);
+    if (binary_source != nullptr && binary_source->remaining() == 0)
+      return caf::none;
+    auto version = uint8_t{0};
+    if (auto err = source(version))
+      return err;
+    if (version != format_version)
+      return caf::make_error(ec::version_error,
+                             "unsupported hash index format version",
+                             version);
+    if (auto err = source(directory_))
+      return err;
+    if (directory_.size() != digests_.size())
+      return caf::make_error(ec::format_error,
+                             "hash index directory does not match digests");
+    return caf::none;
   }
 
 private:
@@ -138,6 +170,8 @@ private:
     }
   };
 
+  using key_set = std::unordered_set<key, key_hasher>;
+
   // Retrieves the unique digest for a given input or generates a new one.
   std::optional<key> make_digest(data_view x) {
     for (size_t i = 0; i < max_hash_rounds; ++i) {
@@ -179,46 +213,112 @@ private:
     return true;
   }
 
+  bool append_run_impl(const value_run& xs, id) override {
+    if (immutable())
+      return false;
+    auto append = [&](auto run) {
+      auto size = digests_.size();
+      digests_.reserve(size + run.size());
+      // Remembers the values that introduced a new digest, so that we can
+      // undo their entries in `seeds_` and `unique_digests_`.
+      std::vector<std::pair<key, size_t>> added;
+      for (size_t i = 0; i < run.size(); ++i) {
+        auto num_unique = unique_digests_.size();
+        auto digest = make_digest(data_view{run[i]});
+        if (!digest) {
+          // Leave the index unchanged so that the caller can fall back to
+          // appending values one at a time.
+          for (auto& [k, j] : added) {
+            unique_digests_.erase(k);
+            if (auto it = seeds_.find(data_view{run[j]}); it != seeds_.end())
+              seeds_.erase(it);
+          }
+          digests_.resize(size);
+          return false;
+        }
+        if (unique_digests_.size() != num_unique)
+          added.emplace_back(*digest, i);
+        digests_.push_back(digest->bytes);
+      }
+      return true;
+    };
+    // Digests depend on the type of the hashed data, which is ambiguous for
+    // the numeric runs, so only strings and addresses take the bulk path.
+    auto f = detail::overload{
+      [&](auto) { return false; },
+      [&](span<const std::string_view> run) { return append(run); },
+      [&](span<const address> run) { return append(run); },
+    };
+    return caf::visit(f, xs);
+  }
+
+  /// Brings the digest directory up to date with all appended digests. Only
+  /// the digests appended since the last update need sorting; the directory
+  /// then merges them with the existing entries in linear time.
+  void update_directory() const {
+    auto first = directory_.size();
+    if (first == digests_.size())
+      return;
+    auto rng = select(this->mask());
+    if (first > 0)
+      rng.next(first);
+    directory_.reserve(digests_.size());
+    for (auto i = first; i < digests_.size(); ++i, rng.next()) {
+      VAST_ASSERT(!rng.done());
+      directory_.push_back({key_hasher{}(key{digests_[i]}), rng.get()});
+    }
+    auto mid = directory_.begin() + first;
+    std::sort(mid, directory_.end());
+    std::inplace_merge(directory_.begin(), mid, directory_.end());
+  }
+
+  /// Appends the rows of all digests equal to a given key.
+  /// @pre The directory is up to date.
+  void find_rows(key k, std::vector<id>& rows) const {
+    auto digest = key_hasher{}(k);
+    auto it = std::lower_bound(directory_.begin(), directory_.end(), digest,
+                               [](const directory_entry& x, uint64_t y) {
+                                 return x.digest < y;
+                               });
+    for (; it != directory_.end() && it->digest == digest; ++it)
+      rows.push_back(it->row);
+  }
+
   [[nodiscard]] caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override {
     VAST_ASSERT(rank(this->mask()) == digests_.size());
-    // Implementation of the one-pass search algorithm that computes the
-    // resulting ID set. The predicate depends on the operator and RHS.
-    auto scan = [&](auto predicate) -> ids {
+    // Every operator boils down to finding the rows of a set of digests in
+    // the directory. Negations simply flip the result.
+    auto make_result = [&](std::vector<id>& rows, bool negate) -> ids {
+      std::sort(rows.begin(), rows.end());
       ewah_bitmap result;
-      auto rng = select(this->mask());
-      if (rng.done())
-        return result;
-      for (size_t i = 0, last_match = 0; i < digests_.size(); ++i) {
-        if (predicate(digests_[i])) {
-          auto digests_since_last_match = i - last_match;
-          if (digests_since_last_match > 0)
-            rng.next(digests_since_last_match);
-          result.append_bits(false, rng.get() - result.size());
-          result.append_bit(true);
-          last_match = i;
-        }
+      for (auto row : rows) {
+        result.append_bits(false, row - result.size());
+        result.append_bit(true);
       }
+      result.append_bits(false, this->offset() - result.size());
+      if (negate)
+        result.flip();
       return result;
     };
+    std::vector<id> rows;
     if (op == relational_operator::equal
         || op == relational_operator::not_equal) {
-      auto k = find_digest(x);
-      auto eq = [=](const digest_type& digest) { return k == digest; };
-      auto ne = [=](const digest_type& digest) { return k != digest; };
-      return op == relational_operator::equal ? scan(eq) : scan(ne);
+      update_directory();
+      find_rows(find_digest(x), rows);
+      return make_result(rows, op == relational_operator::not_equal);
     }
     if (op == relational_operator::in || op == relational_operator::not_in) {
       // Ensure that the RHS is a list of strings.
       auto keys = caf::visit(
         detail::overload{
-          [&](auto xs) -> caf::expected<std::vector<key>> {
+          [&](auto xs) -> caf::expected<key_set> {
             using view_type = decltype(xs);
             if constexpr (std::is_same_v<view_type, view<list>>) {
-              std::vector<key> result;
+              key_set result;
               result.reserve(xs.size());
               for (auto x : xs)
-                result.emplace_back(find_digest(x));
+                result.insert(find_digest(x));
               return result;
             } else {
               return caf::make_error(ec::type_clash, "expected list on RHS",
@@ -229,16 +329,11 @@ private:
         x);
       if (!keys)
         return keys.error();
-      // We're good to go with: create the set predicates an run the scan.
-      auto in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::any_of(keys->begin(), keys->end(), cmp);
-      };
-      auto not_in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::none_of(keys->begin(), keys->end(), cmp);
-      };
-      return op == relational_operator::in ? scan(in_pred) : scan(not_in_pred);
+      // The keys are unique, so their rows are disjoint.
+      update_directory();
+      for (auto k : *keys)
+        find_rows(k, rows);
+      return make_result(rows, op == relational_operator::not_in);
     }
     return caf::make_error(ec::unsupported_operator, op);
   }
@@ -246,15 +341,36 @@ private:
   [[nodiscard]] size_t memusage_impl() const override {
     return digests_.capacity() * sizeof(digest_type)
            + unique_digests_.size() * sizeof(key)
-           + seeds_.size() * sizeof(typename decltype(seeds_)::value_type);
+           + seeds_.size() * sizeof(typename decltype(seeds_)::value_type)
+           + directory_.capacity() * sizeof(directory_entry);
   }
 
   [[nodiscard]] bool immutable() const {
     return unique_digests_.empty() && !digests_.empty();
   }
 
+  /// Maps a digest to a row that contains it. The entries are sorted by
+  /// digest and row, which turns an equality lookup into a binary search.
+  struct directory_entry {
+    uint64_t digest;
+    id row;
+
+    friend bool operator<(const directory_entry& x, const directory_entry& y) {
+      return std::tie(x.digest, x.row) < std::tie(y.digest, y.row);
+    }
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, directory_entry& x) {
+      return f(x.digest, x.row);
+    }
+  };
+
   std::vector<digest_type> digests_;
-  std::unordered_set<key, key_hasher> unique_digests_;
+  key_set unique_digests_;
+
+  /// A sorted view of `digests_`, which is persisted along with the digests.
+  /// Appending brings it up to date lazily on the next lookup.
+  mutable std::vector<directory_entry> directory_;
 
   struct data_hash {
     size_t operator()(const data& x) const {
@@ -21,13 +21,23 @@
 #include <caf/fwd.hpp>
 
 #include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace vast {
 
-/// An index for strings.
+/// An index for strings. If the string type has the `#ngrams` attribute, the
+/// index additionally maintains a posting list for every trigram. Substring
+/// queries intersect the trigram postings and verify the remaining candidates
+/// with the character index. Pattern queries narrow down candidates by the
+/// literals that every match contains.
 class string_index : public value_index {
 public:
+  /// The size of the n-grams in the substring index.
+  static constexpr size_t ngram_size = 3;
+
   /// Constructs a string index.
   /// @param t An instance of `string_type`.
   /// @param opts Runtime context for index parameterization.
@@ -45,16 +55,33 @@ private:
   using length_bitmap_index
     = bitmap_index<uint32_t, multi_level_coder<range_coder<ids>>>;
 
+  /// The index which holds the positions of all strings that contain an
+  /// n-gram, keyed by the n-gram.
+  using ngram_index = std::unordered_map<uint32_t, ewah_bitmap>;
+
   bool append_impl(data_view x, id pos) override;
 
+  bool append_run_impl(const value_run& xs, id pos) override;
+
+  /// Adds a string to the postings of all its n-grams.
+  /// @pre `ngrams_enabled_`
+  void append_ngrams(std::string_view str, id pos);
+
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
   size_t memusage_impl() const override;
 
+  /// Looks up the strings that contain all n-grams of a string, which is a
+  /// superset of the strings that contain the string itself.
+  /// @pre `ngrams_enabled_ && str.size() >= ngram_size`
+  [[nodiscard]] ids ngram_candidates(std::string_view str) const;
+
   size_t max_length_;
   length_bitmap_index length_;
   std::vector<char_bitmap_index> chars_;
+  bool ngrams_enabled_;
+  ngram_index ngrams_;
 };
 
 } // namespace vast
@@ -78,6 +78,17 @@ public:
   void append_column_to_index(id offset, table_slice::size_type column,
                               value_index& index) const;
 
+  /// Evaluates a predicate against all values in column `column`.
+  /// @param column The index of the column to evaluate.
+  /// @param t The type of the column.
+  /// @param op The relational operator of the predicate.
+  /// @param rhs The literal on the right-hand side of the predicate.
+  /// @returns A bitmap with one bit per row that is set iff the value in that
+  /// row satisfies the predicate.
+  [[nodiscard]] ids
+  evaluate_column(table_slice::size_type column, const type& t,
+                  relational_operator op, const data& rhs) const;
+
   /// Retrieves data by specifying 2D-coordinates via row and column.
   /// @param row The row offset.
   /// @param column The column offset.
@@ -10,6 +10,11 @@
 
 #include "vast/detail/operators.hpp"
 
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/meta/load_callback.hpp>
+
+#include <memory>
 #include <string>
 
 namespace vast {
@@ -17,6 +22,12 @@ namespace vast {
 struct access;
 class data;
 
+namespace detail {
+
+class regex;
+
+} // namespace detail
+
 /// A regular expression.
 class pattern : detail::totally_ordered<pattern>,
                 detail::addable<pattern>,
@@ -43,6 +54,12 @@ public:
   /// @param str The string containing the pattern.
   explicit pattern(std::string str);
 
+  pattern(const pattern& other);
+  pattern& operator=(const pattern& other);
+  pattern(pattern&&) noexcept = default;
+  pattern& operator=(pattern&&) noexcept = default;
+  ~pattern() noexcept = default;
+
   /// Matches a string against the pattern.
   /// @param str The string to match.
   /// @returns `true` if the pattern matches exactly *str*.
@@ -55,6 +72,13 @@ public:
 
   [[nodiscard]] const std::string& string() const;
 
+  /// Retrieves the compiled regular expression, compiling it on first use.
+  /// Copies of a pattern share the compiled expression, so a query compiles
+  /// each of its patterns once.
+  /// @returns The compiled expression or an error if the pattern is invalid.
+  [[nodiscard]] caf::expected<std::shared_ptr<const detail::regex>>
+  compiled() const;
+
   // -- concepts // ------------------------------------------------------------
 
   pattern& operator+=(const pattern& other);
@@ -83,13 +107,21 @@ public:
 
   template <class Inspector>
   friend auto inspect(Inspector& f, pattern& p) {
-    return f(p.str_);
+    auto load_callback = caf::meta::load_callback([&]() -> caf::error {
+      p.regex_ = nullptr;
+      return caf::none;
+    });
+    return f(p.str_, std::move(load_callback));
   }
 
   friend bool convert(const pattern& p, data& d);
 
 private:
   std::string str_;
+
+  /// The lazily compiled form of `str_`, which we access atomically because
+  /// const patterns may be shared between actors.
+  mutable std::shared_ptr<const detail::regex> regex_;
 };
 
 } // namespace vast
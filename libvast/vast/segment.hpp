@@ -30,8 +30,7 @@ class segment {
   friend segment_builder;
 
 public:
-  /// Constructs a segment.
-  /// @param header The header of the segment.
+  /// Constructs a segment, decompressing its table slices if necessary.
   /// @param chunk The chunk holding the segment data.
   static caf::expected<segment> make(chunk_ptr chunk);
 
@@ -44,9 +43,13 @@ public:
   // @returns The number of table slices in this segment.
   [[nodiscard]] size_t num_slices() const;
 
-  /// @returns The underlying chunk.
+  /// @returns The underlying chunk in its persistent, possibly compressed
+  ///          form.
   [[nodiscard]] chunk_ptr chunk() const;
 
+  /// @returns The number of bytes that the segment occupies in memory.
+  [[nodiscard]] size_t memory_usage() const;
+
   /// Locates the table slices for a given set of IDs.
   /// @param xs The IDs to lookup.
   /// @returns The table slices according to *xs*.
@@ -54,9 +57,14 @@ public:
   lookup(const vast::ids& xs) const;
 
 private:
-  explicit segment(chunk_ptr chk);
+  segment(chunk_ptr chk, chunk_ptr data);
 
+  /// The segment as persisted.
   chunk_ptr chunk_;
+
+  /// An uncompressed `fbs::segment::v0`, which is the same as `chunk_` unless
+  /// the segment is compressed.
+  chunk_ptr data_;
 };
 
 } // namespace vast
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "vast/aliases.hpp"
+#include "vast/compression.hpp"
 #include "vast/fbs/segment.hpp"
 #include "vast/fbs/table_slice.hpp"
 #include "vast/segment.hpp"
@@ -27,7 +28,13 @@ namespace vast {
 class segment_builder {
 public:
   /// Constructs a segment builder.
-  explicit segment_builder(size_t initial_buffer_size);
+  /// @param initial_buffer_size The initial size of the table slice buffer.
+  /// @param method The compression algorithm for finished segments.
+  /// @param level The compression level, where 0 selects the default level of
+  ///        the algorithm.
+  explicit segment_builder(size_t initial_buffer_size,
+                           compression method = compression::none,
+                           int level = 0);
 
   /// Adds a table slice to the segment.
   /// @returns An error if adding the table slice failed.
@@ -36,7 +43,9 @@ public:
   ///      efficient lookup of table slices from a sequence of IDs.
   caf::error add(table_slice x);
 
-  /// Constructs a segment from previously added table slices.
+  /// Constructs a segment from previously added table slices. If the builder
+  /// compresses its segments but compression fails, the segment remains
+  /// uncompressed.
   /// @post The builder can now be reused to contruct a new segment.
   segment finish();
 
@@ -62,6 +71,11 @@ public:
   void reset();
 
 private:
+  /// Wraps a finished segment into a compressed segment.
+  caf::expected<chunk_ptr> compress(const chunk_ptr& chunk) const;
+
+  compression compression_;
+  int compression_level_;
   uuid id_;
   vast::id min_table_slice_offset_;
   uint64_t num_events_;
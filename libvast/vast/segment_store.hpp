@@ -21,6 +21,8 @@
 #  include "vast/table_slice.hpp"
 #endif
 
+#include <caf/variant.hpp>
+
 #include <filesystem>
 
 namespace vast {
@@ -38,10 +40,24 @@ public:
   public:
     using uuid_iterator = std::vector<uuid>::iterator;
 
+    /// The matching table slices of a segment in memory, or the
+    /// memory-mapped chunk of a persisted segment that the caller decodes
+    /// with `segment::make` and queries with `segment::lookup`.
+    using segment_slices = caf::variant<std::vector<table_slice>, chunk_ptr>;
+
     lookup(const segment_store& store, ids xs, std::vector<uuid>&& candidates);
 
     caf::expected<table_slice> next();
 
+    /// Retrieves the next candidate segment at once, including the remainder
+    /// of a segment that was partially consumed by `next()`. Unlike `next()`,
+    /// this neither decodes persisted segments nor adds them to the cache,
+    /// so that the caller can do so elsewhere.
+    /// @returns The matching table slices of the next segment, which may be
+    /// empty, the chunk of a persisted segment, or an error, which is
+    /// `caf::no_error` after the last candidate.
+    caf::expected<segment_slices> next_segment();
+
   private:
     caf::expected<std::vector<table_slice>> handle_segment();
 
@@ -59,10 +75,14 @@ public:
   /// @param dir The directory where to store state.
   /// @param max_segment_size The maximum segment size in bytes.
   /// @param in_memory_segments The number of semgents to cache in memory.
+  /// @param method The compression algorithm for new segments.
+  /// @param level The compression level, where 0 selects the default level of
+  ///        the algorithm.
   /// @pre `max_segment_size > 0`
   static segment_store_ptr
   make(std::filesystem::path dir, size_t max_segment_size,
-       size_t in_memory_segments);
+       size_t in_memory_segments, compression method = compression::none,
+       int level = 0);
 
   // -- properties -------------------------------------------------------------
 
@@ -93,6 +113,13 @@ public:
     cache_.clear();
   }
 
+  /// Adds a segment that was decoded outside of the store to the cache.
+  /// @param x The segment to add.
+  void cache(segment x) {
+    auto id = x.id();
+    cache_.emplace(id, std::move(x));
+  }
+
   // -- implementation of store ------------------------------------------------
 
   caf::error put(table_slice xs);
@@ -109,7 +136,7 @@ public:
 
 private:
   segment_store(std::filesystem::path dir, uint64_t max_segment_size,
-                size_t in_memory_segments);
+                size_t in_memory_segments, compression method, int level);
 
   // -- utility functions ------------------------------------------------------
 
@@ -117,6 +144,8 @@ private:
 
   caf::error register_segment(const std::filesystem::path& filename);
 
+  caf::expected<chunk_ptr> map_segment(uuid id) const;
+
   caf::expected<segment> load_segment(uuid id) const;
 
   /// Fills `candidates` with all segments that qualify for `selection`.
@@ -142,6 +171,12 @@ private:
   /// Configures the limit each segment until we seal and flush it.
   uint64_t max_segment_size_;
 
+  /// The compression algorithm for new segments.
+  compression compression_;
+
+  /// The compression level for new segments.
+  int compression_level_;
+
   uint64_t num_events_ = 0;
 
   /// Maps event IDs to candidate segments.
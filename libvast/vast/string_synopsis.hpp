@@ -20,6 +20,8 @@
 #include <caf/config_value.hpp>
 #include <caf/settings.hpp>
 
+#include <type_traits>
+
 namespace vast {
 
 template <class HashFunction>
@@ -28,11 +30,12 @@ make_string_synopsis(vast::type type, bloom_filter_parameters params,
                      std::vector<size_t> seeds = {});
 
 /// A synopsis for strings.
-template <class HashFunction>
+template <class HashFunction,
+          policy::partitioning Partitioning = policy::partitioning::no>
 class string_synopsis final
-  : public bloom_filter_synopsis<std::string, HashFunction> {
+  : public bloom_filter_synopsis<std::string, HashFunction, Partitioning> {
 public:
-  using super = bloom_filter_synopsis<std::string, HashFunction>;
+  using super = bloom_filter_synopsis<std::string, HashFunction, Partitioning>;
 
   /// Constructs a string synopsis from an `string_type` and a Bloom
   /// filter.
@@ -85,13 +88,21 @@ synopsis_ptr
 make_string_synopsis(vast::type type, bloom_filter_parameters params,
                      std::vector<size_t> seeds) {
   VAST_ASSERT(caf::holds_alternative<string_type>(type));
-  auto x = make_bloom_filter<HashFunction>(std::move(params), std::move(seeds));
-  if (!x) {
-    VAST_WARN("{} failed to construct Bloom filter", __func__);
-    return nullptr;
-  }
-  using synopsis_type = string_synopsis<HashFunction>;
-  return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
+  auto make = [&](auto layout) -> synopsis_ptr {
+    constexpr auto cell_layout = decltype(layout)::value;
+    auto x = make_bloom_filter<HashFunction, double_hasher, cell_layout>(
+      std::move(params), std::move(seeds));
+    if (!x) {
+      VAST_WARN("make_string_synopsis failed to construct Bloom filter");
+      return nullptr;
+    }
+    using synopsis_type = string_synopsis<HashFunction, cell_layout>;
+    return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
+  };
+  using policy::partitioning;
+  if (has_blocked_layout(type))
+    return make(std::integral_constant<partitioning, partitioning::blocked>{});
+  return make(std::integral_constant<partitioning, partitioning::no>{});
 }
 
 /// Factory to construct a buffered string synopsis.
@@ -133,6 +144,8 @@ synopsis_ptr make_string_synopsis(vast::type type, const caf::settings& opts) {
     VAST_ERROR("{} could not determine Bloom filter parameters", __func__);
     return nullptr;
   }
+  if (caf::get_or(opts, "blocked-bloom-filters", false))
+    type = annotate_blocked_layout(std::move(type));
   bloom_filter_parameters params;
   params.n = *max_part_size;
   params.p = caf::get_or(opts, "string-synopsis-fp-rate",
@@ -149,7 +149,8 @@ using active_indexer_actor = typed_actor_fwd<
   // Hooks into the table slice column stream.
   caf::replies_to<caf::stream<table_slice_column>>::with<
     caf::inbound_stream_slot<table_slice_column>>,
-  // Finalizes the ACTIVE INDEXER into a chunk, which containes an INDEXER.
+  // Finalizes the ACTIVE INDEXER into a chunk, which contains the value index
+  // as a `fbs::value_index::v0` flatbuffer.
   caf::replies_to<atom::snapshot>::with<chunk_ptr>>
   // Conform the the INDEXER ACTOR interface.
   ::extend_with<indexer_actor>
@@ -234,6 +235,16 @@ using archive_actor = typed_actor_fwd<
   // Conform to the protocol of the STORE BUILDER actor.
   ::extend_with<store_builder_actor>::unwrap;
 
+/// The ARCHIVE WORKER actor interface.
+using archive_worker_actor = typed_actor_fwd<
+  // Runs the candidate checks of a query over the table slices of a segment,
+  // restricted to the given ids, and sends the results to the query's sink.
+  caf::replies_to<query, std::vector<table_slice>, ids>::with< //
+    atom::done>,
+  // Decodes a persisted segment and runs the candidate checks of a query over
+  // its table slices like above. Returns the decoded segment for caching.
+  caf::replies_to<query, chunk_ptr, ids>::with<segment>>::unwrap;
+
 /// The TYPE REGISTRY actor interface.
 using type_registry_actor = typed_actor_fwd<
   // The internal telemetry loop of the TYPE REGISTRY.
@@ -295,7 +306,8 @@ using active_partition_actor = typed_actor_fwd<
   caf::replies_to<atom::persist, std::filesystem::path,
                   std::filesystem::path>::with< //
     std::shared_ptr<partition_synopsis>>,
-  // INTERNAL: A repeatedly called continuation of the persist request.
+  // INTERNAL: Continues the persist request once the partition received all
+  // table slices.
   caf::reacts_to<atom::internal, atom::persist, atom::resume>>
   // Conform to the protocol of the STREAM SINK actor for table slices.
   ::extend_with<stream_sink_actor<table_slice>>
@@ -436,6 +448,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_actors, caf::id_block::vast_atoms::end)
   VAST_ADD_TYPE_ID((vast::system::active_partition_actor))
   VAST_ADD_TYPE_ID((vast::system::analyzer_plugin_actor))
   VAST_ADD_TYPE_ID((vast::system::archive_actor))
+  VAST_ADD_TYPE_ID((vast::system::archive_worker_actor))
   VAST_ADD_TYPE_ID((vast::system::disk_monitor_actor))
   VAST_ADD_TYPE_ID((vast::system::evaluator_actor))
   VAST_ADD_TYPE_ID((vast::system::exporter_actor))
@@ -467,4 +480,8 @@ CAF_ALLOW_UNSAFE_MESSAGE_TYPE(std::shared_ptr<vast_uuid_synopsis_map>)
 CAF_ALLOW_UNSAFE_MESSAGE_TYPE(std::shared_ptr<vast::partition_synopsis>)
 #undef vast_uuid_synopsis_map
 
+// Used in the interface of the archive worker actor. A segment may refer to a
+// memory-mapped file, so it must never leave the process.
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(vast::segment)
+
 #undef VAST_ADD_TYPE_ID
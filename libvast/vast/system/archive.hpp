@@ -20,10 +20,12 @@
 #include <caf/typed_event_based_actor.hpp>
 
 #include <filesystem>
+#include <list>
 #include <memory>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace vast::system {
 
@@ -39,12 +41,29 @@ struct archive_state {
     std::queue<std::pair<ids, caf::typed_response_promise<atom::done>>>
       ids_queue;
     bool cancelled = false;
+
+    /// The lookup session for the ids that were last popped from `ids_queue`.
+    std::unique_ptr<vast::segment_store::lookup> session;
+    ids session_ids = {};
+    caf::typed_response_promise<atom::done> active_promise;
+
+    /// The number of segments of the current session that workers are still
+    /// checking.
+    size_t pending = 0;
+
+    /// The first error that occurred in the current session.
+    caf::error error = {};
   };
 
-  std::deque<request_state> requests;
-  std::unique_ptr<vast::segment_store::lookup> session;
-  ids session_ids = {};
-  caf::typed_response_promise<atom::done> active_promise;
+  /// The filed requests in round-robin order. We use a list because the
+  /// callbacks of in-flight worker requests refer to its elements.
+  std::list<request_state> requests;
+
+  /// Workers that wait for the next segment to check.
+  std::vector<archive_worker_actor> idle_workers;
+
+  /// Whether an `atom::internal, atom::resume` message is underway.
+  bool resume_pending = false;
 
   archive_actor::pointer self;
 
@@ -53,10 +72,17 @@ struct archive_state {
   /// Send metrics to the accountant.
   void send_report();
 
-  /// Opens the next lookup session with the segment_store, either
-  /// by popping the next ids item from the queue of the current request
-  /// or by moving to the next request.
-  std::unique_ptr<segment_store::lookup> next_session();
+  /// Schedules a step of query processing unless one is already underway.
+  void schedule();
+
+  /// Loads the next segment of the next request with outstanding work in
+  /// round-robin order, and hands it to an idle worker.
+  /// @returns Whether there may be more work for idle workers.
+  bool step();
+
+  /// Completes the current session of a request once all workers have
+  /// finished, and removes requests without further work.
+  void finish_session(std::list<request_state>::iterator request);
 
   /// Updates an existing request with additional ids or inserts a new request
   /// if the query client hasn't been seen before.
@@ -70,15 +96,30 @@ struct archive_state {
   static inline const char* name = "archive";
 };
 
-/// Stores event batches and answers queries for ID sets.
+/// Stores event batches and answers queries for ID sets. The ARCHIVE loads
+/// the candidate segments of all active requests in turn and hands them to a
+/// pool of workers that run the candidate checks, so that loading the next
+/// segment overlaps with checking the current one.
 /// @param self The actor handle.
 /// @param dir The root directory of the archive.
 /// @param capacity The number of segments to cache in memory.
 /// @param max_segment_size The maximum segment size in bytes.
+/// @param method The compression algorithm for new segments.
+/// @param level The compression level, where 0 selects the default level of
+///        the algorithm.
+/// @param num_workers The number of workers that check segments concurrently.
 /// @pre `max_segment_size > 0`
+/// @pre `num_workers > 0`
 archive_actor::behavior_type
 archive(archive_actor::stateful_pointer<archive_state> self,
         const std::filesystem::path& dir, size_t capacity,
-        size_t max_segment_size);
+        size_t max_segment_size, compression method, int level,
+        size_t num_workers);
+
+/// Runs the candidate checks of a query over the table slices of a segment
+/// and sends the results to the sink of the query.
+/// @param self The actor handle.
+archive_worker_actor::behavior_type
+archive_worker(archive_worker_actor::pointer self);
 
 } // namespace vast::system
@@ -71,6 +71,15 @@ struct evaluator_state {
   static inline const char* name = "evaluator";
 };
 
+/// Combines the hits of all predicates in an expression according to its
+/// conjunctions, disjunctions, and negations.
+/// @param expr The expression to evaluate.
+/// @param hits The hits per predicate, keyed by their position in *expr*.
+/// @returns The hits for *expr*.
+/// @relates evaluator_state
+ids evaluate_hits(const expression& expr,
+                  const evaluator_state::predicate_hits_map& hits);
+
 /// Wraps a query expression in an actor. Upon receiving hits from INDEXER
 /// actors, re-evaluates the expression and relays new hits to the INDEX CLIENT.
 /// @pre `!eval.empty()`
@@ -12,11 +12,14 @@
 
 #include "vast/expression.hpp"
 #include "vast/system/node.hpp"
+#include "vast/time.hpp"
+#include "vast/time_window_planner.hpp"
 #include "vast/type.hpp"
 
 #include <caf/actor.hpp>
 #include <caf/fwd.hpp>
 
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -29,6 +32,16 @@ struct explorer_state {
     uint64_t per_result;
   };
 
+  /// The contexts that a combined query covers, along with the number of
+  /// events that were attributed to each context.
+  struct context_query {
+    /// The planned query, which maps its results back to the contexts.
+    time_window_planner::query query;
+
+    /// The number of events that were attributed to each context.
+    std::unordered_map<size_t, uint64_t> attributed;
+  };
+
   static inline constexpr const char* name = "explorer";
 
   explorer_state(caf::event_based_actor* self);
@@ -36,6 +49,14 @@ struct explorer_state {
   /// Send the results to the sink, after removing duplicates.
   void forward_results(vast::table_slice slice);
 
+  /// Send the results of a combined query to the sink, keeping only the events
+  /// that fall into the context of at least one originating result.
+  void route_results(context_query& contexts, vast::table_slice slice);
+
+  /// Spawns an exporter for a combined query.
+  /// @param query The query that covers the contexts of many results.
+  void query_contexts(time_window_planner::query query);
+
   /// Maximum number of events to output.
   event_limits limits;
 
@@ -55,6 +76,9 @@ struct explorer_state {
   /// for the purpose of deduplication.
   std::unordered_set<size_t> returned_ids;
 
+  /// The combined queries, keyed by their exporters.
+  std::unordered_map<caf::actor_addr, context_query> contexts;
+
   /// A tracking counter of spawned exporters. Used for lifetime management.
   size_t running_exporters = 0;
 
@@ -76,7 +100,8 @@ struct explorer_state {
 };
 
 /// The EXPLORER receives table slices and constructs new queries for a time box
-/// around each result.
+/// around each result. A `time_window_planner` combines the time boxes of all
+/// results in a slice into a few queries.
 /// @param self The actor handle.
 /// @param node The node actor to spawn exporters in.
 /// @param before Size of the time box prior to each result.
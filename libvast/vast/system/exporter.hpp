@@ -16,6 +16,7 @@
 #include "vast/query_options.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/system/query_status.hpp"
+#include "vast/system/query_window.hpp"
 #include "vast/system/transformer.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/uuid.hpp"
@@ -61,6 +62,12 @@ struct exporter_state {
   /// Stores various meta information about the progress we made on the query.
   query_status query;
 
+  /// Sizes the batches of partitions that we request from the INDEX.
+  query_window window = query_window{1, 1};
+
+  /// Stores the time point for when the current batch got scheduled.
+  std::chrono::steady_clock::time_point batch_start;
+
   /// Stores flags for the query for distinguishing historic and continuous
   /// queries.
   query_options options;
@@ -54,6 +54,31 @@ struct active_partition_info {
   }
 };
 
+/// Identifies the layouts that one of several concurrently active partitions
+/// holds.
+struct layout_group_filter {
+  /// The position of the layout group.
+  size_t group = 0;
+
+  /// The total number of layout groups.
+  size_t num_groups = 1;
+};
+
+/// Maps a table slice to one of several layout groups by the name of its
+/// layout, so that all slices of a layout go to the same active partition.
+/// @param slice The table slice to map.
+/// @param num_groups The total number of layout groups.
+/// @returns The layout group of *slice*.
+/// @pre `num_groups > 0`
+size_t layout_group(const table_slice& slice, size_t num_groups);
+
+/// Helper class used to route table slices to the active partition of their
+/// layout group in the CAF stream stage.
+struct active_partition_selector {
+  bool operator()(const layout_group_filter& filter,
+                  const table_slice& slice) const;
+};
+
 /// Accumulates statistics for a given layout.
 struct layout_statistics {
   uint64_t count; ///< Number of events indexed.
@@ -113,9 +138,10 @@ struct query_state {
 struct index_state {
   // -- type aliases -----------------------------------------------------------
 
-  using index_stream_stage_ptr
-    = caf::stream_stage_ptr<table_slice,
-                            caf::broadcast_downstream_manager<table_slice>>;
+  using index_stream_stage_ptr = caf::stream_stage_ptr<
+    table_slice,
+    caf::broadcast_downstream_manager<table_slice, layout_group_filter,
+                                      active_partition_selector>>;
 
   // -- constructor ------------------------------------------------------------
 
@@ -163,10 +189,16 @@ struct index_state {
   // -- partition handling -----------------------------------------------------
 
   /// Creates a new active partition.
-  void create_active_partition();
+  /// @param group The layout group of the partition.
+  void create_active_partition(size_t group);
 
-  /// Decommissions the active partition.
-  void decomission_active_partition();
+  /// Decommissions an active partition.
+  /// @param group The layout group of the partition.
+  void decomission_active_partition(size_t group);
+
+  /// @returns The active partition with the given ID, if any.
+  [[nodiscard]] active_partition_actor
+  find_active_partition(const uuid& id) const;
 
   // -- data members -----------------------------------------------------------
 
@@ -176,8 +208,9 @@ struct index_state {
   /// The streaming stage.
   index_stream_stage_ptr stage;
 
-  /// The single active (read/write) partition.
-  active_partition_info active_partition = {};
+  /// The active (read/write) partitions, one per layout group. Partitions
+  /// that were not yet created or were just decommissioned have no actor.
+  std::vector<active_partition_info> active_partitions = {};
 
   /// Partitions that are currently in the process of persisting.
   // TODO: An alternative to keeping an explicit set of unpersisted partitions
@@ -245,6 +278,12 @@ struct index_state {
   // The false positive rate for the meta index.
   double meta_index_fp_rate = {};
 
+  /// Whether the meta index uses cache-blocked Bloom filters.
+  bool meta_index_blocked_bloom_filters = false;
+
+  /// Whether passive partitions evaluate queries synchronously.
+  bool partition_local_evaluation = false;
+
   constexpr static inline auto name = "index";
 };
 
@@ -265,12 +304,21 @@ pack(flatbuffers::FlatBufferBuilder& builder, const index_state& state);
 /// @param taste_partitions How many lookup partitions to schedule immediately.
 /// @param num_workers The maximum amount of concurrent lookups.
 /// @param meta_index_fp_rate The false positive rate for the meta index.
+/// @param meta_index_blocked_bloom_filters Whether the meta index uses Bloom
+/// filters that keep all bits of an element in the same cache line.
+/// @param partition_local_evaluation Whether passive partitions evaluate
+/// queries synchronously instead of spawning INDEXER actors.
+/// @param num_active_partitions The number of partitions that are filled
+/// concurrently, each with the table slices of a different group of layouts.
 /// @pre `partition_capacity > 0
+/// @pre `num_active_partitions > 0`
 index_actor::behavior_type
 index(index_actor::stateful_pointer<index_state> self, store_actor store,
       filesystem_actor filesystem, const std::filesystem::path& dir,
       size_t partition_capacity, size_t max_inmem_partitions,
       size_t taste_partitions, size_t num_workers,
-      const std::filesystem::path& meta_index_dir, double meta_index_fp_rate);
+      const std::filesystem::path& meta_index_dir, double meta_index_fp_rate,
+      bool meta_index_blocked_bloom_filters, bool partition_local_evaluation,
+      size_t num_active_partitions);
 
 } // namespace vast::system
@@ -11,6 +11,7 @@
 #include "vast/fwd.hpp"
 
 #include "vast/detail/flat_map.hpp"
+#include "vast/detail/interval_tree.hpp"
 #include "vast/fbs/index.hpp"
 #include "vast/fbs/partition.hpp"
 #include "vast/ids.hpp"
@@ -18,6 +19,7 @@
 #include "vast/qualified_record_field.hpp"
 #include "vast/synopsis.hpp"
 #include "vast/system/actors.hpp"
+#include "vast/time.hpp"
 #include "vast/time_synopsis.hpp"
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
@@ -27,6 +29,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace vast::system {
@@ -60,7 +63,16 @@ public:
   /// @returns A vector of UUIDs representing candidate partitions.
   [[nodiscard]] std::vector<uuid> lookup(const expression& expr) const;
 
-  [[nodiscard]] std::vector<uuid> lookup_impl(const expression& expr) const;
+  /// Retrieves the list of candidate partition IDs for a given expression,
+  /// optionally restricted to a set of candidates.
+  /// @param expr The expression to lookup.
+  /// @param candidates If not `nullptr`, a sorted list of partitions that the
+  ///        lookup may restrict itself to. The result may still contain
+  ///        partitions outside of this list, so callers must intersect.
+  /// @returns A sorted vector of UUIDs representing candidate partitions.
+  [[nodiscard]] std::vector<uuid>
+  lookup_impl(const expression& expr,
+              const std::vector<uuid>* candidates = nullptr) const;
 
   /// @returns A best-effort estimate of the amount of memory used for this meta
   /// index (in bytes).
@@ -76,6 +88,26 @@ public:
   // the `flat_map` proves to be much faster than `std::{unordered_,}set`.
   // See also ae9dbed.
   detail::flat_map<uuid, partition_synopsis> synopses;
+
+  /// Maps a layout name to the sorted IDs of all partitions that contain
+  /// events of that layout.
+  std::unordered_map<std::string, std::vector<uuid>> layout_partitions;
+
+  /// Maps a field to the sorted IDs of all partitions that contain it, which
+  /// allows for probing only the synopses of relevant partitions.
+  std::unordered_map<qualified_record_field, std::vector<uuid>>
+    field_partitions;
+
+  /// Maps a field to the time ranges of its time synopses in all partitions.
+  std::unordered_map<qualified_record_field, detail::interval_tree<time, uuid>>
+    time_ranges;
+
+private:
+  /// Adds a partition to the secondary lookup structures.
+  void index(const uuid& partition, const partition_synopsis& ps);
+
+  /// Removes a partition from the secondary lookup structures.
+  void unindex(const uuid& partition, const partition_synopsis& ps);
 };
 
 /// The META INDEX is the first index actor that queries hit. The result
@@ -59,6 +59,10 @@ struct active_partition_state {
 
   void notify_flush_listeners();
 
+  /// Marks the stream of table slices as complete and resumes a pending
+  /// persist request.
+  void handle_input_closed();
+
   // -- data members -----------------------------------------------------------
 
   /// Pointer to the parent actor.
@@ -73,6 +77,10 @@ struct active_partition_state {
   /// Tracks whether we already received at least one table slice.
   bool streaming_initiated;
 
+  /// Tracks whether all inbound paths of the stream stage are closed, i.e.,
+  /// whether we received all table slices for this partition.
+  bool inbound_closed = false;
+
   /// The combined type of all columns of this partition
   record_type combined_layout;
 
@@ -151,6 +159,11 @@ struct passive_partition_state {
 
   indexer_actor indexer_at(size_t position) const;
 
+  /// Gets the value index at a certain position, deserializing it lazily on
+  /// first access.
+  /// @returns A pointer to the value index, or `nullptr` on failure.
+  const value_index* value_index_at(size_t position) const;
+
   // -- data members -----------------------------------------------------------
 
   /// Pointer to the parent actor.
@@ -191,6 +204,14 @@ struct passive_partition_state {
   /// Maps qualified fields to indexer actors. This is mutable since
   /// indexers are spawned lazily on first access.
   mutable std::vector<indexer_actor> indexers;
+
+  /// Whether to evaluate queries within the partition actor instead of
+  /// spawning an EVALUATOR and an INDEXER per field.
+  bool local_evaluation = false;
+
+  /// Maps qualified fields to value indexes for local evaluation. This is
+  /// mutable since value indexes are deserialized lazily on first access.
+  mutable std::vector<value_index_ptr> value_indexes;
 };
 
 // -- flatbuffers --------------------------------------------------------------
@@ -222,9 +243,11 @@ active_partition_actor::behavior_type active_partition(
 /// @param filesystem The actor handle of the filesystem actor.
 /// @param path The path where the partition flatbuffer can be found.
 /// @param store The store to retrieve the events from.
+/// @param local_evaluation Whether to evaluate queries synchronously within
+///        the partition instead of using an EVALUATOR and INDEXER actors.
 partition_actor::behavior_type passive_partition(
   partition_actor::stateful_pointer<passive_partition_state> self, uuid id,
   filesystem_actor filesystem, const std::filesystem::path& path,
-  store_actor store);
+  store_actor store, bool local_evaluation);
 
 } // namespace vast::system
@@ -10,6 +10,7 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/data.hpp"
 #include "vast/expression.hpp"
 #include "vast/system/node.hpp"
 #include "vast/type.hpp"
@@ -35,6 +36,17 @@ struct pivoter_state {
 
   pivoter_state(caf::event_based_actor* self);
 
+  // -- utility functions ------------------------------------------------------
+
+  /// Spawns an exporter that queries the target type for the collected values
+  /// of a pivot field.
+  /// @param field The name of the pivot field.
+  /// @param values The values of *field* to query for.
+  void query_values(const std::string& field, list values);
+
+  /// Queries for all pivot values that were collected so far.
+  void flush();
+
   // -- member variables -------------------------------------------------------
 
   /// The name of the type that we are pivoting to.
@@ -53,6 +65,15 @@ struct pivoter_state {
   ///       string.
   std::unordered_set<std::string> requested_ids;
 
+  /// The pivot values that were not yet queried, grouped by the name of the
+  /// field that they were extracted from. Collecting the values of several
+  /// slices keeps the number of queries small.
+  std::unordered_map<std::string, list> pending;
+
+  /// Whether the pivoter sent itself a message to query for the pending
+  /// values.
+  bool flush_scheduled = false;
+
   /// A cache for the connections between a source type and the target type,
   /// to avoid multiple computations of those.
   mutable std::unordered_map<record_type, std::optional<record_field>> cache;
@@ -75,7 +96,9 @@ struct pivoter_state {
 };
 
 /// The PIVOTER receives table slices and constructs new queries for the target
-/// type.
+/// type. It collects the pivot values of the slices that arrive together into
+/// a single query, which it issues once it processed all of them or enough
+/// values are pending.
 /// @param self The actor handle.
 /// @param node The node actor to spawn exporters in.
 /// @param target The type filter for the subsequent queries.
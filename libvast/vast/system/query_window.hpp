@@ -0,0 +1,50 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/time.hpp"
+
+#include <cstddef>
+
+namespace vast::system {
+
+/// Determines how many partitions an EXPORTER asks the INDEX to evaluate at
+/// once. The window grows multiplicatively as long as larger batches reduce
+/// the latency per partition, i.e., as long as there are idle workers. It
+/// grows additively once the per-partition latency stalls, shrinks gradually
+/// when the per-partition latency degrades, and halves when the sink does not
+/// keep up with the results.
+class query_window {
+public:
+  /// Constructs a window.
+  /// @param initial The initial number of partitions.
+  /// @param max The upper bound for the number of partitions.
+  /// @pre `initial > 0 && max > 0`
+  query_window(size_t initial, size_t max) noexcept;
+
+  /// @returns The number of partitions to schedule with the next request.
+  [[nodiscard]] size_t size() const noexcept;
+
+  /// @returns The latency per partition of the last completed batch.
+  [[nodiscard]] duration partition_latency() const noexcept;
+
+  /// Adjusts the window after a batch of partitions completed.
+  /// @param partitions The number of partitions in the batch.
+  /// @param latency The time it took to evaluate the batch.
+  /// @param backpressure Whether results are piling up because the sink does
+  ///        not keep up.
+  void complete(size_t partitions, duration latency, bool backpressure) noexcept;
+
+private:
+  size_t size_;
+  size_t max_;
+  duration partition_latency_ = {};
+};
+
+} // namespace vast::system
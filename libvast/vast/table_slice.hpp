@@ -149,6 +149,18 @@ public:
   /// @pre `offset() != invalid_id`
   void append_column_to_index(size_type column, value_index& index) const;
 
+  /// Evaluates a predicate against all values in column `column`.
+  /// @param column The index of the column to evaluate.
+  /// @param t The type of the column.
+  /// @param op The relational operator of the predicate.
+  /// @param rhs The literal on the right-hand side of the predicate.
+  /// @returns A bitmap with one bit per row that is set iff the value in that
+  /// row satisfies the predicate.
+  /// @pre `column < columns()`
+  [[nodiscard]] ids evaluate_column(size_type column, const type& t,
+                                    relational_operator op,
+                                    const data& rhs) const;
+
   /// Retrieves data by specifying 2D-coordinates via row and column.
   /// @param row The row offset.
   /// @param column The column offset.
@@ -312,7 +324,9 @@ split(table_slice slice, size_t partition_point);
 /// @returns The sum of rows across *slices*.
 uint64_t rows(const std::vector<table_slice>& slices);
 
-/// Evaluates an expression over a table slice by applying it row-wise.
+/// Evaluates an expression over a table slice column-wise. Every predicate
+/// is checked in a single pass over its column, and the resulting bitmaps are
+/// combined with bitwise operations according to the connectives of *expr*.
 /// @param expr The expression to evaluate.
 /// @param slice The table slice to apply *expr* on.
 /// @returns The set of row IDs in *slice* for which *expr* yields true.
@@ -0,0 +1,103 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/data.hpp"
+#include "vast/detail/interval_tree.hpp"
+#include "vast/expression.hpp"
+#include "vast/time.hpp"
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace vast {
+
+/// Plans the queries for many time windows, e.g., the contexts around the
+/// results of another query. Overlapping windows merge into a single range
+/// predicate on the event timestamp, and the keys of the merged windows form a
+/// single membership predicate on the key field. A few combined queries then
+/// cover all windows, such that every candidate partition is evaluated once
+/// for all of them instead of once per window. The results of a combined query
+/// map back to the windows they belong to via `query::lookup`.
+class time_window_planner {
+public:
+  /// A combined query for a group of windows.
+  class query {
+  public:
+    /// @returns the expression that selects the events of all windows.
+    [[nodiscard]] const expression& expr() const noexcept;
+
+    /// @returns the number of windows that the query covers.
+    [[nodiscard]] size_t size() const noexcept;
+
+    /// Invokes a function with the ID of every window that contains an event.
+    /// @param key The value of the key field of the event, or `caf::none` if
+    ///        the planner has no key field.
+    /// @param t The timestamp of the event.
+    /// @param f The function to invoke with each window ID.
+    template <class F>
+    void lookup(const data& key, time t, F f) const {
+      if (auto it = windows_.find(key); it != windows_.end())
+        it->second.overlapping(t, t, f);
+    }
+
+  private:
+    friend class time_window_planner;
+
+    expression expr_;
+    size_t size_ = 0;
+    std::map<data, detail::interval_tree<time, size_t>> windows_;
+  };
+
+  /// Constructs a planner.
+  /// @param key_field The field that the keys of the windows refer to, if any.
+  /// @param max_ranges_per_query The maximum number of merged time ranges in a
+  ///        single query.
+  /// @pre `max_ranges_per_query > 0`
+  explicit time_window_planner(std::optional<std::string> key_field = {},
+                               size_t max_ranges_per_query = 64);
+
+  /// Adds a window. A window that is unbounded on a side omits the range
+  /// predicate for that side.
+  /// @param first The lower bound of the window, or `time::min()`.
+  /// @param last The upper bound of the window, or `time::max()`.
+  /// @param key The value of the key field, or `caf::none` if the planner has
+  ///        no key field.
+  /// @returns The ID of the window, which counts the added windows from 0.
+  /// @pre `first <= last`
+  size_t add(time first, time last, data key = {});
+
+  /// @returns the number of added windows.
+  [[nodiscard]] size_t size() const noexcept;
+
+  /// Plans the combined queries for all added windows and removes them from
+  /// the planner.
+  /// @returns The queries, each covering a disjoint set of windows.
+  std::vector<query> plan();
+
+private:
+  struct window {
+    time first;
+    time last;
+    data key;
+    size_t id;
+  };
+
+  std::optional<std::string> key_field_;
+  size_t max_ranges_per_query_;
+  size_t num_windows_ = 0;
+  std::vector<window> windows_;
+};
+
+} // namespace vast
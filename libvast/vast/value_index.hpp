@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include "vast/address.hpp"
 #include "vast/error.hpp"
 #include "vast/ewah_bitmap.hpp"
 #include "vast/ids.hpp"
+#include "vast/span.hpp"
 #include "vast/type.hpp"
 #include "vast/view.hpp"
 
@@ -18,8 +20,10 @@
 #include <caf/expected.hpp>
 #include <caf/fwd.hpp>
 #include <caf/settings.hpp>
+#include <caf/variant.hpp>
 
 #include <memory>
+#include <string_view>
 
 namespace vast {
 
@@ -37,6 +41,14 @@ public:
 
   using size_type = typename ids::size_type;
 
+  /// A run of consecutive non-nil values in the native representation of the
+  /// underlying table slice. Integers, durations, and times share the signed
+  /// 64-bit representation, with times counting nanoseconds since the epoch.
+  using value_run
+    = caf::variant<span<const integer::value_type>, span<const count>,
+                   span<const real>, span<const std::string_view>,
+                   span<const address>>;
+
   /// Appends a data value.
   /// @param x The data to append to the index.
   /// @returns `true` if appending succeeded.
@@ -48,6 +60,19 @@ public:
   /// @returns `true` if appending succeeded.
   caf::expected<void> append(data_view x, id pos);
 
+  /// Appends all values of a table slice column, using the bulk path of the
+  /// concrete index where possible.
+  /// @param column The column to append to the index.
+  /// @returns An error if the column starts before the end of the index.
+  caf::expected<void> append(const table_slice_column& column);
+
+  /// Appends a run of values in bulk.
+  /// @param xs The values to append.
+  /// @param pos The positional identifier of the first value in *xs*.
+  /// @returns `ec::unimplemented` if the concrete index does not support bulk
+  /// appends for the type of *xs*, in which case the index remains unchanged.
+  caf::expected<void> append_run(const value_run& xs, id pos);
+
   /// Looks up data under a relational operator. If the value to look up is
   /// `nil`, only `==` and `!=` are valid operations. The concrete index
   /// type determines validity of other values.
@@ -87,6 +112,11 @@ protected:
 private:
   virtual bool append_impl(data_view x, id pos) = 0;
 
+  /// Appends a run of values in bulk. The default implementation supports no
+  /// run types, so that callers fall back to appending values one at a time.
+  /// @returns `true` if appending succeeded.
+  virtual bool append_run_impl(const value_run& xs, id pos);
+
   [[nodiscard]] virtual caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const = 0;
 
@@ -18,6 +18,7 @@
 #include "vast/detail/type_traits.hpp"
 #include "vast/time.hpp"
 
+#include <caf/expected.hpp>
 #include <caf/intrusive_ptr.hpp>
 #include <caf/make_counted.hpp>
 #include <caf/optional.hpp>
@@ -26,6 +27,7 @@
 
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <typeindex>
@@ -86,6 +88,12 @@ public:
   [[nodiscard]] bool search(std::string_view x) const;
   [[nodiscard]] std::string_view string() const;
 
+  /// Retrieves the compiled regular expression, which views of a `pattern`
+  /// share with the pattern.
+  /// @returns The compiled expression or an error if the pattern is invalid.
+  [[nodiscard]] caf::expected<std::shared_ptr<const detail::regex>>
+  compiled() const;
+
   template <class Hasher>
   friend void hash_append(Hasher& h, pattern_view x) {
     hash_append(h, x.pattern_);
@@ -93,6 +101,9 @@ public:
 
 private:
   std::string_view pattern_;
+
+  /// The pattern this view was created from, if any.
+  const pattern* source_ = nullptr;
 };
 
 /// @relates pattern_view
@@ -0,0 +1,692 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <vast/arrow_table_slice_builder.hpp>
+#include <vast/data.hpp>
+#include <vast/defaults.hpp>
+#include <vast/detail/assert.hpp>
+#include <vast/detail/make_io_stream.hpp>
+#include <vast/detail/narrow.hpp>
+#include <vast/error.hpp>
+#include <vast/format/arrow.hpp>
+#include <vast/format/reader.hpp>
+#include <vast/format/writer.hpp>
+#include <vast/logger.hpp>
+#include <vast/plugin.hpp>
+#include <vast/schema.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/type.hpp>
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/util/compression.h>
+#include <caf/settings.hpp>
+#include <parquet/arrow/reader.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+
+namespace vast::defaults::export_ {
+
+/// Contains settings for the parquet subcommand.
+struct parquet {
+  /// The compression codec for data pages.
+  static constexpr const char* compression = "snappy";
+
+  /// The maximum number of rows per row group.
+  static constexpr size_t row_group_size = 1'048'576; // 1_Mi
+};
+
+} // namespace vast::defaults::export_
+
+namespace vast::plugins::parquet {
+
+namespace {
+
+/// The Arrow type of enumeration columns in Parquet files. Storing the labels
+/// rather than the values makes the columns meaningful to other tools, and the
+/// dictionary encoding stores every label only once per column chunk.
+std::shared_ptr<::arrow::DataType> enumeration_arrow_type() {
+  return ::arrow::dictionary(::arrow::int32(), ::arrow::utf8());
+}
+
+/// Creates the Arrow schema of the Parquet files for a layout.
+caf::expected<std::shared_ptr<::arrow::Schema>>
+make_parquet_schema(const record_type& layout) {
+  auto schema = format::arrow::make_schema(layout);
+  auto flat_layout = flatten(layout);
+  for (size_t i = 0; i < flat_layout.fields.size(); ++i) {
+    if (!caf::holds_alternative<enumeration_type>(flat_layout.fields[i].type))
+      continue;
+    auto index = detail::narrow_cast<int>(i);
+    auto field = schema->field(index)->WithType(enumeration_arrow_type());
+    auto result = schema->SetField(index, std::move(field));
+    if (!result.ok())
+      return caf::make_error(ec::format_error, "failed to create schema",
+                             result.status().ToString());
+    schema = std::move(*result);
+  }
+  return schema;
+}
+
+/// Replaces the values of an enumeration column with their labels.
+caf::expected<std::shared_ptr<::arrow::Array>>
+encode_enumeration(const ::arrow::Array& column, const enumeration_type& t) {
+  const auto& values = static_cast<const ::arrow::UInt64Array&>(column);
+  ::arrow::StringBuilder labels;
+  ::arrow::Int32Builder indices;
+  auto status = labels.AppendValues(t.fields);
+  if (status.ok())
+    status = indices.Reserve(values.length());
+  for (int64_t row = 0; status.ok() && row < values.length(); ++row) {
+    if (values.IsNull(row) || values.Value(row) >= t.fields.size())
+      status = indices.AppendNull();
+    else
+      status = indices.Append(detail::narrow_cast<int32_t>(values.Value(row)));
+  }
+  std::shared_ptr<::arrow::Array> dictionary;
+  std::shared_ptr<::arrow::Array> index_column;
+  if (status.ok())
+    status = labels.Finish(&dictionary);
+  if (status.ok())
+    status = indices.Finish(&index_column);
+  if (!status.ok())
+    return caf::make_error(ec::format_error, "failed to encode enumeration",
+                           status.ToString());
+  auto result = ::arrow::DictionaryArray::FromArrays(
+    enumeration_arrow_type(), index_column, dictionary);
+  if (!result.ok())
+    return caf::make_error(ec::format_error, "failed to encode enumeration",
+                           result.status().ToString());
+  return std::move(*result);
+}
+
+/// Replaces the labels of an enumeration column with their values. The labels
+/// are either dictionary-encoded or plain strings, depending on the writer.
+caf::expected<std::shared_ptr<::arrow::Array>>
+decode_enumeration(const std::shared_ptr<::arrow::Array>& column,
+                   const enumeration_type& t) {
+  if (column->type_id() == ::arrow::Type::UINT64)
+    return column;
+  auto values = std::unordered_map<std::string_view, uint64_t>{};
+  for (size_t i = 0; i < t.fields.size(); ++i)
+    values.emplace(t.fields[i], i);
+  ::arrow::UInt64Builder builder;
+  auto status = builder.Reserve(column->length());
+  auto append = [&](const auto& label) {
+    auto it = values.find(std::string_view{label.data(), label.size()});
+    return it != values.end() ? builder.Append(it->second)
+                              : builder.AppendNull();
+  };
+  if (column->type_id() == ::arrow::Type::DICTIONARY) {
+    const auto& codes = static_cast<const ::arrow::DictionaryArray&>(*column);
+    if (codes.dictionary()->type_id() != ::arrow::Type::STRING)
+      return caf::make_error(ec::type_clash,
+                             "enumeration dictionary must contain strings");
+    const auto& labels
+      = static_cast<const ::arrow::StringArray&>(*codes.dictionary());
+    for (int64_t row = 0; status.ok() && row < codes.length(); ++row)
+      status = codes.IsNull(row)
+                 ? builder.AppendNull()
+                 : append(labels.GetView(codes.GetValueIndex(row)));
+  } else if (column->type_id() == ::arrow::Type::STRING) {
+    const auto& labels = static_cast<const ::arrow::StringArray&>(*column);
+    for (int64_t row = 0; status.ok() && row < labels.length(); ++row)
+      status = labels.IsNull(row) ? builder.AppendNull()
+                                  : append(labels.GetView(row));
+  } else {
+    return caf::make_error(ec::type_clash,
+                           fmt::format("cannot read enumeration from {}",
+                                       column->type()->ToString()));
+  }
+  std::shared_ptr<::arrow::Array> result;
+  if (status.ok())
+    status = builder.Finish(&result);
+  if (!status.ok())
+    return caf::make_error(ec::format_error, "failed to decode enumeration",
+                           status.ToString());
+  return result;
+}
+
+/// Converts a timestamp column to nanoseconds without time zone, which is the
+/// Arrow representation of VAST time values.
+caf::expected<std::shared_ptr<::arrow::Array>>
+decode_time(const std::shared_ptr<::arrow::Array>& column) {
+  if (column->type_id() != ::arrow::Type::TIMESTAMP)
+    return column;
+  const auto& timestamp_type
+    = static_cast<const ::arrow::TimestampType&>(*column->type());
+  auto factor = int64_t{1};
+  switch (timestamp_type.unit()) {
+    case ::arrow::TimeUnit::SECOND:
+      factor = 1'000'000'000;
+      break;
+    case ::arrow::TimeUnit::MILLI:
+      factor = 1'000'000;
+      break;
+    case ::arrow::TimeUnit::MICRO:
+      factor = 1'000;
+      break;
+    case ::arrow::TimeUnit::NANO:
+      break;
+  }
+  if (factor == 1 && timestamp_type.timezone().empty())
+    return column;
+  const auto& values = static_cast<const ::arrow::TimestampArray&>(*column);
+  ::arrow::TimestampBuilder builder{::arrow::timestamp(::arrow::TimeUnit::NANO),
+                                    ::arrow::default_memory_pool()};
+  auto status = builder.Reserve(values.length());
+  for (int64_t row = 0; status.ok() && row < values.length(); ++row)
+    status = values.IsNull(row) ? builder.AppendNull()
+                                : builder.Append(values.Value(row) * factor);
+  std::shared_ptr<::arrow::Array> result;
+  if (status.ok())
+    status = builder.Finish(&result);
+  if (!status.ok())
+    return caf::make_error(ec::format_error, "failed to convert timestamps",
+                           status.ToString());
+  return result;
+}
+
+} // namespace
+
+/// A Parquet writer. The writer writes one Parquet file per layout, and
+/// buffers the table slices of a layout until they fill a row group.
+class writer final : public format::writer {
+public:
+  explicit writer(const caf::settings& options) {
+    using defaults_t = vast::defaults::export_::parquet;
+    std::string category = "vast.export.parquet";
+    output_ = get_or(options, "vast.export.write",
+                     std::string{vast::defaults::export_::write});
+    row_group_size_ = std::max(
+      size_t{1}, get_or(options, category + ".row-group-size",
+                        defaults_t::row_group_size));
+    auto compression = get_or(options, category + ".compression",
+                              std::string{defaults_t::compression});
+    auto codec = ::arrow::Compression::UNCOMPRESSED;
+    if (auto type = ::arrow::util::Codec::GetCompressionType(compression);
+        type.ok() && ::arrow::util::Codec::IsAvailable(*type))
+      codec = *type;
+    else
+      VAST_WARN("{} does not support compression {} and writes uncompressed "
+                "data pages",
+                name(), compression);
+    // Parquet format version 2 stores timestamps with nanosecond resolution,
+    // whereas version 1 silently truncates them to microseconds.
+    properties_ = ::parquet::WriterProperties::Builder()
+                    .compression(codec)
+                    ->enable_dictionary()
+                    ->version(::parquet::ParquetVersion::PARQUET_2_0)
+                    ->build();
+    auto arrow_properties = ::parquet::ArrowWriterProperties::Builder();
+    arrow_properties.store_schema();
+    // Coercing timestamps fails on nanosecond values unless we explicitly
+    // allow the loss of precision.
+    if (get_or(options, category + ".coerce-timestamps", false))
+      arrow_properties.coerce_timestamps(::arrow::TimeUnit::MICRO)
+        ->allow_truncated_timestamps();
+    arrow_properties_ = arrow_properties.build();
+  }
+
+  writer(const writer&) = delete;
+  writer& operator=(const writer&) = delete;
+  writer(writer&&) noexcept = default;
+  writer& operator=(writer&&) noexcept = default;
+
+  ~writer() override {
+    // Writing the buffered row groups and the file footers completes the
+    // files.
+    for (auto& [layout_name, file] : files_) {
+      if (auto err = write_row_group(file))
+        VAST_WARN("{} failed to write row group for {}: {}", name(),
+                  layout_name, render(err));
+      auto status = file.writer->Close();
+      if (status.ok())
+        status = file.out->Close();
+      if (!status.ok())
+        VAST_WARN("{} failed to close Parquet file for {}: {}", name(),
+                  layout_name, status.ToString());
+    }
+  }
+
+  caf::error write(const table_slice& slice) override {
+    const auto& layout = slice.layout();
+    auto file = files_.find(layout.name());
+    if (file == files_.end()) {
+      auto opened = open(layout);
+      if (!opened)
+        return std::move(opened.error());
+      file = files_.emplace(layout.name(), std::move(*opened)).first;
+    } else if (file->second.layout != layout) {
+      return caf::make_error(ec::type_clash,
+                             fmt::format("{} cannot write different layouts "
+                                         "with the same name {}",
+                                         name(), layout.name()));
+    }
+    auto& state = file->second;
+    auto batch = as_record_batch(slice);
+    VAST_ASSERT(batch != nullptr);
+    auto columns = batch->columns();
+    auto flat_layout = flatten(layout);
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const auto* t = caf::get_if<enumeration_type>(&flat_layout.fields[i].type);
+      if (t == nullptr)
+        continue;
+      auto column = encode_enumeration(*columns[i], *t);
+      if (!column)
+        return std::move(column.error());
+      columns[i] = std::move(*column);
+    }
+    state.batches.push_back(::arrow::RecordBatch::Make(
+      state.schema, batch->num_rows(), std::move(columns)));
+    state.rows += slice.rows();
+    if (state.rows >= row_group_size_)
+      return write_row_group(state);
+    return caf::none;
+  }
+
+  [[nodiscard]] const char* name() const override {
+    return "parquet-writer";
+  }
+
+private:
+  /// An open Parquet file for a single layout.
+  struct file_state {
+    record_type layout;
+    std::shared_ptr<::arrow::Schema> schema;
+    std::shared_ptr<::arrow::io::OutputStream> out;
+    std::unique_ptr<::parquet::arrow::FileWriter> writer;
+    std::vector<std::shared_ptr<::arrow::RecordBatch>> batches;
+    size_t rows = 0;
+  };
+
+  caf::expected<file_state> open(const record_type& layout) {
+    auto result = file_state{};
+    result.layout = layout;
+    if (output_ == "-") {
+      // A Parquet file has a single schema, so we can only write a single
+      // layout to STDOUT.
+      if (!files_.empty())
+        return caf::make_error(ec::format_error,
+                               fmt::format("{} cannot write multiple layouts "
+                                           "to STDOUT; use --write to specify "
+                                           "a target directory",
+                                           name()));
+      result.out = std::make_shared<::arrow::io::StdoutStream>();
+    } else {
+      auto err = std::error_code{};
+      std::filesystem::create_directories(output_, err);
+      if (err)
+        return caf::make_error(ec::filesystem_error,
+                               fmt::format("failed to create directory {}: {}",
+                                           output_, err.message()));
+      auto path = std::filesystem::path{output_}
+                  / fmt::format("{}.parquet", layout.name());
+      auto out = ::arrow::io::FileOutputStream::Open(path.string());
+      if (!out.ok())
+        return caf::make_error(ec::filesystem_error,
+                               fmt::format("failed to open {}: {}",
+                                           path.string(),
+                                           out.status().ToString()));
+      result.out = std::move(*out);
+    }
+    auto schema = make_parquet_schema(layout);
+    if (!schema)
+      return std::move(schema.error());
+    result.schema = std::move(*schema);
+    auto status = ::parquet::arrow::FileWriter::Open(
+      *result.schema, ::arrow::default_memory_pool(), result.out, properties_,
+      arrow_properties_, &result.writer);
+    if (!status.ok())
+      return caf::make_error(ec::format_error,
+                             "failed to create Parquet file writer",
+                             status.ToString());
+    return result;
+  }
+
+  caf::error write_row_group(file_state& file) {
+    if (file.batches.empty())
+      return caf::none;
+    auto table = ::arrow::Table::FromRecordBatches(file.schema, file.batches);
+    if (!table.ok())
+      return caf::make_error(ec::format_error, "failed to create table",
+                             table.status().ToString());
+    file.batches.clear();
+    file.rows = 0;
+    auto chunk_size = detail::narrow_cast<int64_t>(row_group_size_);
+    if (auto status = file.writer->WriteTable(**table, chunk_size);
+        !status.ok())
+      return caf::make_error(ec::format_error, "failed to write row group",
+                             status.ToString());
+    return caf::none;
+  }
+
+  std::string output_;
+  size_t row_group_size_ = vast::defaults::export_::parquet::row_group_size;
+  std::shared_ptr<::parquet::WriterProperties> properties_;
+  std::shared_ptr<::parquet::ArrowWriterProperties> arrow_properties_;
+  std::unordered_map<std::string, file_state> files_;
+};
+
+/// A Parquet reader. The reader decodes the Parquet file one row group after
+/// another and produces Arrow table slices.
+class reader final : public format::reader {
+public:
+  explicit reader(const caf::settings& options) : format::reader(options) {
+    input_
+      = get_or(options, "vast.import.read", vast::defaults::import::read);
+  }
+
+  reader(const reader&) = delete;
+  reader& operator=(const reader&) = delete;
+  reader(reader&&) noexcept = default;
+  reader& operator=(reader&&) noexcept = default;
+  ~reader() override = default;
+
+  void reset(std::unique_ptr<std::istream> in) override {
+    input_ = "-";
+    in_ = std::move(in);
+    file_reader_ = nullptr;
+    batch_reader_ = nullptr;
+    batch_ = nullptr;
+    batch_offset_ = 0;
+  }
+
+  caf::error schema(vast::schema x) override {
+    schema_ = std::move(x);
+    return caf::none;
+  }
+
+  [[nodiscard]] vast::schema schema() const override {
+    return schema_;
+  }
+
+  [[nodiscard]] const char* name() const override {
+    return "parquet-reader";
+  }
+
+protected:
+  caf::error
+  read_impl(size_t max_events, size_t max_slice_size, consumer& f) override {
+    if (batch_reader_ == nullptr)
+      if (auto err = open())
+        return err;
+    size_t produced = 0;
+    while (produced < max_events) {
+      if (batch_ == nullptr || batch_offset_ == batch_->num_rows())
+        if (auto err = next_batch())
+          return err;
+      auto num_rows = detail::narrow_cast<size_t>(batch_->num_rows());
+      auto offset = detail::narrow_cast<size_t>(batch_offset_);
+      auto rows
+        = std::min({num_rows - offset, max_slice_size, max_events - produced});
+      auto batch
+        = rows == num_rows ? batch_ : batch_->Slice(batch_offset_, rows);
+      f(arrow_table_slice_builder::create(batch, layout_));
+      batch_offset_ += detail::narrow_cast<int64_t>(rows);
+      produced += rows;
+    }
+    return caf::none;
+  }
+
+private:
+  caf::error open() {
+    std::shared_ptr<::arrow::io::RandomAccessFile> file;
+    if (input_ != "-") {
+      auto result = ::arrow::io::ReadableFile::Open(input_);
+      if (!result.ok())
+        return caf::make_error(ec::filesystem_error,
+                               fmt::format("failed to open {}: {}", input_,
+                                           result.status().ToString()));
+      file = std::move(*result);
+    } else {
+      if (in_ == nullptr) {
+        auto in = detail::make_input_stream(input_);
+        if (!in)
+          return std::move(in.error());
+        in_ = std::move(*in);
+      }
+      // The Parquet footer precedes the data, so we buffer the input stream.
+      auto buffer = std::string{std::istreambuf_iterator<char>{*in_},
+                                std::istreambuf_iterator<char>{}};
+      file = std::make_shared<::arrow::io::BufferReader>(
+        ::arrow::Buffer::FromString(std::move(buffer)));
+    }
+    auto status = ::parquet::arrow::OpenFile(
+      file, ::arrow::default_memory_pool(), &file_reader_);
+    if (!status.ok())
+      return caf::make_error(ec::format_error, "failed to open Parquet file",
+                             status.ToString());
+    std::shared_ptr<::arrow::Schema> schema;
+    if (status = file_reader_->GetSchema(&schema); !status.ok())
+      return caf::make_error(ec::format_error, "failed to read Parquet schema",
+                             status.ToString());
+    auto layout = format::arrow::make_layout(*schema, "parquet");
+    if (!layout)
+      return std::move(layout.error());
+    layout_ = std::move(*layout);
+    flat_layout_ = flatten(layout_);
+    if (flat_layout_.fields.size()
+        != detail::narrow_cast<size_t>(schema->num_fields()))
+      return caf::make_error(ec::type_clash,
+                             fmt::format("Parquet schema does not match "
+                                         "layout {}",
+                                         layout_.name()));
+    arrow_schema_ = make_arrow_schema(flat_layout_);
+    auto row_groups = std::vector<int>(file_reader_->num_row_groups());
+    std::iota(row_groups.begin(), row_groups.end(), 0);
+    status = file_reader_->GetRecordBatchReader(row_groups, &batch_reader_);
+    if (!status.ok())
+      return caf::make_error(ec::format_error, "failed to read row groups",
+                             status.ToString());
+    VAST_DEBUG("{} reads {} row groups of layout {}", name(),
+               row_groups.size(), layout_.name());
+    return caf::none;
+  }
+
+  caf::error next_batch() {
+    batch_offset_ = 0;
+    std::shared_ptr<::arrow::RecordBatch> batch;
+    do {
+      if (auto status = batch_reader_->ReadNext(&batch); !status.ok())
+        return caf::make_error(ec::format_error, "failed to read row group",
+                               status.ToString());
+      if (batch == nullptr)
+        return caf::make_error(ec::end_of_input, "input exhausted");
+    } while (batch->num_rows() == 0);
+    // Restore the Arrow representation of VAST for columns that the writer
+    // converted.
+    auto columns = batch->columns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const auto& t = flat_layout_.fields[i].type;
+      auto column = caf::expected<std::shared_ptr<::arrow::Array>>{columns[i]};
+      if (const auto* e = caf::get_if<enumeration_type>(&t))
+        column = decode_enumeration(columns[i], *e);
+      else if (caf::holds_alternative<time_type>(t))
+        column = decode_time(columns[i]);
+      if (!column)
+        return std::move(column.error());
+      if (!(*column)->type()->Equals(make_arrow_type(t)))
+        return caf::make_error(
+          ec::type_clash,
+          fmt::format("{} cannot read {} as {}", name(),
+                      (*column)->type()->ToString(),
+                      flat_layout_.fields[i].name));
+      columns[i] = std::move(*column);
+    }
+    batch_ = ::arrow::RecordBatch::Make(arrow_schema_, batch->num_rows(),
+                                        std::move(columns));
+    return caf::none;
+  }
+
+  std::string input_;
+  std::unique_ptr<std::istream> in_;
+  std::unique_ptr<::parquet::arrow::FileReader> file_reader_;
+  std::unique_ptr<::arrow::RecordBatchReader> batch_reader_;
+  std::shared_ptr<::arrow::RecordBatch> batch_;
+  int64_t batch_offset_ = 0;
+  record_type layout_;
+  record_type flat_layout_;
+  std::shared_ptr<::arrow::Schema> arrow_schema_;
+  vast::schema schema_;
+};
+
+/// The Parquet reader/writer plugin.
+class plugin final : public virtual reader_plugin,
+                     public virtual writer_plugin {
+public:
+  /// Loading logic.
+  plugin() = default;
+
+  /// Teardown logic.
+  ~plugin() override = default;
+
+  /// Initializes a plugin with its respective entries from the YAML config
+  /// file, i.e., `plugin.<NAME>`.
+  /// @param config The relevant subsection of the configuration.
+  caf::error initialize(data config) override {
+    if (auto* r = caf::get_if<record>(&config))
+      config_ = *r;
+    return caf::none;
+  }
+
+  /// Returns the unique name of the plugin.
+  [[nodiscard]] const char* name() const override {
+    return "parquet";
+  }
+
+  /// Returns the import format's name.
+  [[nodiscard]] const char* reader_format() const override {
+    return "parquet";
+  }
+
+  /// Returns the `vast import <format>` helptext.
+  [[nodiscard]] const char* reader_help() const override {
+    return "imports Parquet files from STDIN or file";
+  }
+
+  /// Returns the `vast import <format>` documentation.
+  [[nodiscard]] const char* reader_documentation() const override {
+    return R"__(The `import parquet` command imports [Apache
+Parquet](https://parquet.apache.org) files.
+
+Parquet files written by `vast export parquet` carry their VAST layout in the
+schema metadata. For other Parquet files, VAST infers the layout from the
+column types, and the layout name defaults to `parquet`.
+
+Because the metadata of a Parquet file is located at its end, VAST buffers the
+entire input when reading from STDIN. Prefer `--read` for large files.
+
+```bash
+vast import --read=export/zeek.conn.parquet parquet
+```
+)__";
+  }
+
+  /// Returns the options for the `vast import <format>` and `vast spawn source
+  /// <format>` commands.
+  [[nodiscard]] caf::config_option_set
+  reader_options(command::opts_builder&& opts) const override {
+    return std::move(opts).finish();
+  };
+
+  /// Creates a reader, which will be available via `vast import <format>` and
+  /// `vast spawn source <format>`.
+  [[nodiscard]] std::unique_ptr<format::reader>
+  make_reader(const caf::settings& options) const override {
+    return std::make_unique<reader>(options);
+  }
+
+  /// Returns the export format's name.
+  [[nodiscard]] const char* writer_format() const override {
+    return "parquet";
+  }
+
+  /// Returns the `vast export <format>` helptext.
+  [[nodiscard]] const char* writer_help() const override {
+    return "exports query results in Parquet format";
+  }
+
+  /// Returns the `vast export <format>` documentation.
+  [[nodiscard]] const char* writer_documentation() const override {
+    return R"__(The `export parquet` command writes query results as [Apache
+Parquet](https://parquet.apache.org) files, which tools such as Spark and pandas
+read natively.
+
+Because a Parquet file has a single schema, VAST treats `--write` as a
+directory and writes one file per layout into it, e.g., `zeek.conn.parquet`.
+Writing to STDOUT only works for query results of a single layout.
+
+VAST buffers the events of a layout until they fill a row group of
+`--row-group-size` rows. All columns use dictionary encoding where it pays off,
+and `--compression` selects the codec for the data pages, e.g., `snappy`,
+`zstd`, `gzip`, or `uncompressed`.
+
+VAST types map to Parquet types as follows:
+
+  |   VAST         |  Parquet                                |
+  |---------------:|----------------------------------------:|
+  |   bool         |  BOOLEAN                                |
+  |   integer      |  INT64                                  |
+  |   count        |  INT64 (UINT_64)                        |
+  |   real         |  DOUBLE                                 |
+  |   time         |  INT64 (TIMESTAMP, nanoseconds)         |
+  |   duration     |  INT64                                  |
+  |   string       |  BYTE_ARRAY (STRING)                    |
+  |   pattern      |  BYTE_ARRAY (STRING)                    |
+  |   enumeration  |  BYTE_ARRAY (STRING), dictionary-encoded|
+  |   address      |  FIXED_LEN_BYTE_ARRAY(16)               |
+  |   subnet       |  FIXED_LEN_BYTE_ARRAY(17)               |
+
+Enumerations store their labels rather than their numeric values. Addresses
+store IPv4 addresses as IPv4-mapped IPv6 addresses in network byte order, and
+subnets append the prefix length to the network address.
+
+Some tools, e.g., older versions of Spark, cannot read timestamps with
+nanosecond resolution. The option `--coerce-timestamps` stores them with
+microsecond resolution instead.
+
+```bash
+vast export --write=export parquet '#type == "zeek.conn"'
+```
+)__";
+  }
+
+  /// Returns the options for the `vast export <format>` and `vast spawn sink
+  /// <format>` commands.
+  [[nodiscard]] caf::config_option_set
+  writer_options(command::opts_builder&& opts) const override {
+    return std::move(opts)
+      .add<std::string>("compression", "compression codec for data pages")
+      .add<size_t>("row-group-size", "maximum number of rows per row group")
+      .add<bool>("coerce-timestamps", "store timestamps with microsecond "
+                                      "resolution")
+      .finish();
+  }
+
+  /// Creates a writer, which will be available via `vast export <format>` and
+  /// `vast spawn sink <format>`.
+  [[nodiscard]] std::unique_ptr<format::writer>
+  make_writer(const caf::settings& options) const override {
+    return std::make_unique<writer>(options);
+  }
+
+private:
+  record config_ = {};
+};
+
+} // namespace vast::plugins::parquet
+
+VAST_REGISTER_PLUGIN(vast::plugins::parquet::plugin)
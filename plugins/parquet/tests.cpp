@@ -0,0 +1,162 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+#define SUITE parquet
+
+#include <vast/concept/parseable/to.hpp>
+#include <vast/concept/parseable/vast/address.hpp>
+#include <vast/concept/parseable/vast/subnet.hpp>
+#include <vast/concept/parseable/vast/time.hpp>
+#include <vast/error.hpp>
+#include <vast/format/reader_factory.hpp>
+#include <vast/format/writer_factory.hpp>
+#include <vast/table_slice.hpp>
+#include <vast/table_slice_builder_factory.hpp>
+#include <vast/test/fixtures/events.hpp>
+#include <vast/test/fixtures/filesystem.hpp>
+#include <vast/test/test.hpp>
+
+#include <arrow/io/api.h>
+#include <caf/settings.hpp>
+#include <parquet/arrow/reader.h>
+
+#include <filesystem>
+#include <limits>
+
+namespace vast::plugins::parquet {
+
+namespace {
+
+struct fixture : fixtures::events, fixtures::filesystem {
+  fixture() {
+    factory<format::reader>::initialize();
+    factory<format::writer>::initialize();
+  }
+
+  void write(const std::vector<table_slice>& slices,
+             caf::settings options = {}) {
+    caf::put(options, "vast.export.write", directory.string());
+    caf::put(options, "vast.export.parquet.row-group-size", size_t{10});
+    auto writer = format::writer::make("parquet", options);
+    REQUIRE(writer);
+    for (const auto& slice : slices)
+      REQUIRE_EQUAL(writer->get()->write(slice), caf::none);
+  }
+
+  std::vector<table_slice>
+  read(const std::filesystem::path& path, size_t max_slice_size) {
+    caf::settings options;
+    caf::put(options, "vast.import.read", path.string());
+    auto reader = format::reader::make("parquet", options);
+    REQUIRE(reader);
+    std::vector<table_slice> slices;
+    auto add_slice
+      = [&](table_slice slice) { slices.emplace_back(std::move(slice)); };
+    auto [err, produced] = reader->get()->read(
+      std::numeric_limits<size_t>::max(), max_slice_size, add_slice);
+    CHECK_EQUAL(err, ec::end_of_input);
+    CHECK_EQUAL(produced, rows(slices));
+    return slices;
+  }
+};
+
+} // namespace
+
+FIXTURE_SCOPE(parquet_tests, fixture)
+
+TEST(Parquet round trip) {
+  write(zeek_conn_log);
+  auto path = directory / "zeek.conn.parquet";
+  REQUIRE(std::filesystem::exists(path));
+  MESSAGE("compare pairs of rows, which are independent of row groups");
+  auto slices = read(path, 2);
+  auto expected = std::vector<table_slice>{};
+  for (auto slice : zeek_conn_log) {
+    while (slice.rows() > 2) {
+      auto [head, tail] = split(slice, 2);
+      expected.push_back(std::move(head));
+      slice = std::move(tail);
+    }
+    expected.push_back(std::move(slice));
+  }
+  REQUIRE_EQUAL(slices.size(), expected.size());
+  for (size_t i = 0; i < slices.size(); ++i) {
+    CHECK_EQUAL(slices[i].encoding(), table_slice_encoding::arrow);
+    CHECK_EQUAL(slices[i], expected[i]);
+  }
+}
+
+TEST(Parquet logical types) {
+  auto layout = record_type{{"e", enumeration_type{{"foo", "bar", "baz"}}},
+                            {"a", address_type{}},
+                            {"sn", subnet_type{}},
+                            {"p", pattern_type{}},
+                            {"t", time_type{}}}
+                  .name("parquet.test");
+  auto builder = factory<table_slice_builder>::make(
+    table_slice_encoding::arrow, layout);
+  REQUIRE(builder);
+  auto add_row = [&](data e, std::string_view a, std::string_view sn,
+                     std::string p, std::string_view t) {
+    REQUIRE(builder->add(e, data{unbox(to<address>(a))},
+                         data{unbox(to<subnet>(sn))}, data{pattern{p}},
+                         data{unbox(to<time>(t))}));
+  };
+  add_row(data{enumeration{2}}, "10.0.0.1", "10.0.0.0/8", "foo.*",
+          "2011-08-12T13:00:36.349948123Z");
+  add_row(data{}, "2001:db8::1", "2001:db8::/32", "bar",
+          "2011-08-12T13:08:01.360925Z");
+  add_row(data{enumeration{0}}, "192.168.1.1", "192.168.0.0/16", "",
+          "2011-08-12T13:09:35.498887Z");
+  auto slice = builder->finish();
+  write({slice});
+  auto path = directory / "parquet.test.parquet";
+  MESSAGE("enumerations are dictionary-encoded labels");
+  {
+    auto file = ::arrow::io::ReadableFile::Open(path.string());
+    REQUIRE(file.ok());
+    std::unique_ptr<::parquet::arrow::FileReader> file_reader;
+    REQUIRE(::parquet::arrow::OpenFile(*file, ::arrow::default_memory_pool(),
+                                       &file_reader)
+              .ok());
+    std::shared_ptr<::arrow::Schema> schema;
+    REQUIRE(file_reader->GetSchema(&schema).ok());
+    CHECK(schema->field(0)->type()->id() == ::arrow::Type::DICTIONARY);
+  }
+  MESSAGE("reading restores the original values");
+  auto slices = read(path, 100);
+  REQUIRE_EQUAL(slices.size(), 1u);
+  CHECK_EQUAL(slices[0], slice);
+}
+
+TEST(Parquet coerced timestamps) {
+  auto layout = record_type{{"t", time_type{}}}.name("parquet.coerced");
+  auto make_slice = [&](const std::vector<std::string_view>& xs) {
+    auto builder = factory<table_slice_builder>::make(
+      table_slice_encoding::arrow, layout);
+    REQUIRE(builder);
+    for (auto x : xs)
+      REQUIRE(builder->add(data{unbox(to<time>(x))}));
+    return builder->finish();
+  };
+  auto slice = make_slice({"2011-08-12T13:00:36.349948123Z",
+                           "2011-08-12T13:08:01.360925Z"});
+  caf::settings options;
+  caf::put(options, "vast.export.parquet.coerce-timestamps", true);
+  write({slice}, std::move(options));
+  auto path = directory / "parquet.coerced.parquet";
+  MESSAGE("timestamps lose their sub-microsecond digits");
+  auto slices = read(path, 100);
+  REQUIRE_EQUAL(slices.size(), 1u);
+  CHECK_EQUAL(slices[0], make_slice({"2011-08-12T13:00:36.349948Z",
+                                     "2011-08-12T13:08:01.360925Z"}));
+}
+
+FIXTURE_SCOPE_END()
+
+} // namespace vast::plugins::parquet
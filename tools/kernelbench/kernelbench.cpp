@@ -0,0 +1,121 @@
+//    _   _____   __________
+//   | | / / _ | / __/_  __/     Visibility
+//   | |/ / __ |_\ \  / /          Across
+//   |___/_/ |_/___/ /_/       Space and Time
+//
+// SPDX-FileCopyrightText: (c) 2021 The VAST Contributors
+// SPDX-License-Identifier: BSD-3-Clause
+
+// A microbenchmark for the comparison kernels that the column-wise evaluation
+// of table slices uses. It compares the scalar fallback against all SIMD
+// levels that the host CPU supports.
+
+#include <vast/detail/compare_kernels.hpp>
+#include <vast/operator.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace vast;
+using namespace vast::detail;
+
+namespace {
+
+constexpr auto levels = {simd_level::scalar, simd_level::sse4_2,
+                         simd_level::avx2};
+
+constexpr auto operators = {
+  relational_operator::equal,      relational_operator::not_equal,
+  relational_operator::less,       relational_operator::less_equal,
+  relational_operator::greater,    relational_operator::greater_equal,
+};
+
+template <class F>
+double measure(size_t iterations, F f) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    f();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+void report(const char* kernel, relational_operator op, simd_level level,
+            size_t values, double seconds, double baseline) {
+  std::printf("%-10s %-3s %-7s %10.1f Mvalues/s %6.2fx\n", kernel,
+              to_string(op).c_str(), to_string(level), values / seconds / 1e6,
+              baseline / seconds);
+}
+
+template <class T>
+void bench_compare(const char* kernel, const std::vector<T>& xs, T x,
+                   size_t iterations) {
+  auto out = std::vector<uint64_t>((xs.size() + 63) / 64);
+  for (auto op : operators) {
+    auto baseline = 0.0;
+    for (auto level : levels) {
+      if (level > supported_simd_level())
+        continue;
+      auto seconds = measure(iterations, [&] {
+        compare(level, op, xs.data(), xs.size(), x, out.data());
+      });
+      if (level == simd_level::scalar)
+        baseline = seconds;
+      report(kernel, op, level, xs.size() * iterations, seconds, baseline);
+    }
+  }
+}
+
+void bench_mask_equal(const std::vector<uint8_t>& addrs, size_t iterations) {
+  auto n = addrs.size() / 16;
+  auto out = std::vector<uint64_t>((n + 63) / 64);
+  uint8_t network[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 10};
+  uint8_t mask[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                      0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+  auto baseline = 0.0;
+  for (auto level : levels) {
+    if (level > supported_simd_level())
+      continue;
+    auto seconds = measure(iterations, [&] {
+      mask_equal(level, addrs.data(), n, network, mask, out.data());
+    });
+    if (level == simd_level::scalar)
+      baseline = seconds;
+    report("address", relational_operator::in, level, n * iterations, seconds,
+           baseline);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  auto n = size_t{1} << 20;
+  auto iterations = size_t{100};
+  if (argc > 1)
+    n = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2)
+    iterations = std::strtoull(argv[2], nullptr, 10);
+  std::printf("values: %zu, iterations: %zu, best SIMD level: %s\n", n,
+              iterations, to_string(supported_simd_level()));
+  auto gen = std::mt19937_64{42};
+  auto ints = std::vector<int64_t>(n);
+  auto counts = std::vector<uint64_t>(n);
+  auto reals = std::vector<double>(n);
+  auto addrs = std::vector<uint8_t>(n * 16);
+  for (size_t i = 0; i < n; ++i) {
+    ints[i] = static_cast<int64_t>(gen() % 1000);
+    counts[i] = gen() % 1000;
+    reals[i] = static_cast<double>(gen() % 1000) / 10.0;
+    addrs[i * 16 + 10] = 0xFF;
+    addrs[i * 16 + 11] = 0xFF;
+    for (size_t j = 12; j < 16; ++j)
+      addrs[i * 16 + j] = static_cast<uint8_t>(gen() % 16);
+  }
+  bench_compare("integer", ints, int64_t{500}, iterations);
+  bench_compare("count", counts, uint64_t{500}, iterations);
+  bench_compare("real", reals, 50.0, iterations);
+  bench_mask_equal(addrs, iterations);
+}
@@ -7,6 +7,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <vast/chunk.hpp>
+#include <vast/compression.hpp>
 #include <vast/concept/printable/to_string.hpp>
 #include <vast/concept/printable/vast/type.hpp>
 #include <vast/concept/printable/vast/uuid.hpp>
@@ -410,6 +411,8 @@ void print_partition_v0(const vast::fbs::partition::v0* partition,
       auto name = field.name;
       // auto name = index->qualified_field_name();
       auto sz = index->index()->data()->size();
+      if (auto blocks = index->index()->ewah_blocks())
+        sz += blocks->size() * sizeof(uint64_t);
       std::cout << indent << name << ": " << vast::to_string(field.type);
       if (formatting.print_bytesizes)
         std::cout << " (" << print_bytesize(sz, formatting) << ")";
@@ -520,6 +523,38 @@ void print_segment_v0(const vast::fbs::segment::v0* segment,
   }
 }
 
+void print_segment_v1(const vast::fbs::segment::v1* segment,
+                      indentation& indent,
+                      const formatting_options& formatting) {
+  auto method = static_cast<vast::compression>(segment->compression());
+  std::cout << indent << "Compressed Segment\n";
+  indented_scope _(indent);
+  std::cout << indent << "compression: " << to_string(method) << "\n";
+  if (formatting.print_bytesizes && segment->data()) {
+    std::cout << indent << "compressed size: "
+              << print_bytesize(segment->data()->size(), formatting) << "\n";
+    std::cout << indent << "decompressed size: "
+              << print_bytesize(segment->decompressed_size(), formatting)
+              << "\n";
+  }
+  if (!segment->data() || method == vast::compression::none) {
+    std::cout << indent << "(invalid compressed segment)\n";
+    return;
+  }
+  auto data = vast::decompress(method, vast::as_bytes(*segment->data()),
+                               segment->decompressed_size());
+  if (!data) {
+    std::cout << indent << "(" << vast::render(data.error()) << ")\n";
+    return;
+  }
+  auto inner = vast::fbs::GetSegment((*data)->data());
+  if (inner->segment_type() != vast::fbs::segment::Segment::v0) {
+    std::cout << indent << "(unknown segment version)\n";
+    return;
+  }
+  print_segment_v0(inner->segment_as_v0(), indent, formatting);
+}
+
 void print_segment(const std::filesystem::path& path, indentation& indent,
                    const formatting_options& formatting) {
   auto segment = read_flatbuffer_file<vast::fbs::Segment>(path);
@@ -530,6 +565,9 @@ void print_segment(const std::filesystem::path& path, indentation& indent,
     case vast::fbs::segment::Segment::v0:
       print_segment_v0(segment->segment_as_v0(), indent, formatting);
       break;
+    case vast::fbs::segment::Segment::v1:
+      print_segment_v1(segment->segment_as_v1(), indent, formatting);
+      break;
     default:
       std::cout << "(unknown partition version)\n";
   }